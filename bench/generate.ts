@@ -0,0 +1,131 @@
+// deterministic generator for large synthetic ass scripts, used by the benchmarks
+
+export interface GenerateOptions {
+	events: number
+	styles: number
+	// number of entries in an additional, not standard section
+	extra_section_entries?: number
+	// mix non ASCII words into the event texts
+	non_ascii?: boolean
+	seed?: number
+}
+
+export type ScriptEncoding = "utf8" | "utf16le"
+
+// small, seedable PRNG (mulberry32), so that every run produces the same script
+function make_random(seed: number): () => number {
+	let state = seed >>> 0
+
+	return () => {
+		state = (state + 0x6d2b79f5) >>> 0
+		let t = state
+		t = Math.imul(t ^ (t >>> 15), t | 1)
+		t ^= t + Math.imul(t ^ (t >>> 7), t | 61)
+		return ((t ^ (t >>> 14)) >>> 0) / 4294967296
+	}
+}
+
+function format_time(centiseconds: number): string {
+	const hundred = centiseconds % 100
+	const sec = Math.floor(centiseconds / 100) % 60
+	const min = Math.floor(centiseconds / 6000) % 60
+	const hour = Math.floor(centiseconds / 360000)
+
+	const pad = (value: number) => value.toString().padStart(2, "0")
+
+	return `${hour}:${pad(min)}:${pad(sec)}.${pad(hundred)}`
+}
+
+const WORDS = [
+	"hello",
+	"world",
+	"karaoke",
+	"subtitle",
+	"{\\an8}",
+	"{\\k20}",
+	"{\\fad(200,200)}",
+	"line",
+	"text",
+	"\\N",
+]
+
+const NON_ASCII_WORDS = ["größer", "café", "日本語", "ありがとう", "😀"]
+
+const EFFECTS = ["Karaoke", "Scroll up;100;200;10", "Banner;5"]
+
+export function generate_script(options: GenerateOptions): string {
+	const random = make_random(options.seed ?? 0x5eed)
+
+	const lines: string[] = [
+		"[Script Info]",
+		"Title: Generated benchmark file",
+		"ScriptType: v4.00+",
+		"WrapStyle: 0",
+		"ScaledBorderAndShadow: yes",
+		"YCbCr Matrix: None",
+		"",
+		"[V4+ Styles]",
+		"Format: Name, Fontname, Fontsize, PrimaryColour, SecondaryColour, OutlineColour, BackColour, Bold, Italic, Underline, StrikeOut, ScaleX, ScaleY, Spacing, Angle, BorderStyle, Outline, Shadow, Alignment, MarginL, MarginR, MarginV, Encoding",
+	]
+
+	for (let i = 0; i < options.styles; ++i) {
+		lines.push(
+			`Style: Style ${i},Arial,${20 + (i % 40)},&H00FFFFFF,&H000000FF,&H00000000,&H00000000,0,0,0,0,100,100,0,0,1,2,2,${1 + (i % 9)},10,10,10,1`
+		)
+	}
+
+	lines.push(
+		"",
+		"[Events]",
+		"Format: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text"
+	)
+
+	let start = 0
+
+	for (let i = 0; i < options.events; ++i) {
+		start += Math.floor(random() * 300)
+		const end = start + 100 + Math.floor(random() * 500)
+
+		const style = `Style ${Math.floor(random() * options.styles)}`
+		const name = random() < 0.5 ? "" : `Actor ${Math.floor(random() * 8)}`
+		const type = random() < 0.9 ? "Dialogue" : "Comment"
+		const effect =
+			random() < 0.8 ? "" : EFFECTS[Math.floor(random() * EFFECTS.length)]
+
+		const word_count = 3 + Math.floor(random() * 12)
+		const words: string[] = []
+		for (let j = 0; j < word_count; ++j) {
+			const word_list =
+				options.non_ascii === true && random() < 0.2
+					? NON_ASCII_WORDS
+					: WORDS
+			words.push(word_list[Math.floor(random() * word_list.length)])
+		}
+
+		lines.push(
+			`${type}: ${i % 3},${format_time(start)},${format_time(end)},${style},${name},0,0,0,${effect},${words.join(" ")}`
+		)
+	}
+
+	const extra_section_entries = options.extra_section_entries ?? 0
+
+	if (extra_section_entries > 0) {
+		lines.push("", "[Aegisub Project Garbage]")
+
+		for (let i = 0; i < extra_section_entries; ++i) {
+			lines.push(`Key ${i}: ${Math.floor(random() * 1_000_000_000)}`)
+		}
+	}
+
+	lines.push("")
+
+	return lines.join("\n")
+}
+
+// the bytes of the script, like they would be stored in a file, with a BOM
+export function encode_script(
+	script: string,
+	encoding: ScriptEncoding
+): Buffer {
+	return Buffer.from(`\ufeff${script}`, encoding)
+}
@@ -0,0 +1,253 @@
+// benchmark suite on large generated scripts, prints one machine readable JSON document, that can
+// be diffed between releases
+//
+// e.g. BENCH_SIZES=1000,100000 BENCH_ITERATIONS=5 npm run bench, by default it runs 1000,
+// 100000 and 1000000 events
+//
+// for every size and encoding it reports
+// - parse: the native parse_ass_cpp alone
+// - convert: the native ass_parse_result_to_js alone
+// - full: the complete AssParser.parse_ass_buffer call
+// and the memory usage, the retained heap of one result is only reported, if gc is exposed
+//
+// every case runs in its own child process (the same script with BENCH_CASE set), so the peak
+// memory of a case doesn't include the earlier ones, it does include the generated script
+
+import { spawnSync } from "child_process"
+import v8 from "v8"
+import { AssParser, type ParseSettingsTS } from "../src/ts/index"
+import { encode_script, generate_script, type ScriptEncoding } from "./generate"
+
+const SETTINGS: ParseSettingsTS = {
+	strict_settings: "non-strict",
+	validate_settings: "nothing",
+}
+
+const SIZES = (process.env.BENCH_SIZES ?? "1000,100000,1000000")
+	.split(",")
+	.map((size) => Number(size.trim()))
+
+const ITERATIONS = Number(process.env.BENCH_ITERATIONS ?? 5)
+
+const ENCODINGS: ScriptEncoding[] = ["utf8", "utf16le"]
+
+const MB = 1024 * 1024
+
+interface PhaseReport {
+	median_ms: number
+	mb_per_second: number
+	events_per_second: number
+}
+
+interface CaseReport {
+	events: number
+	encoding: ScriptEncoding
+	bytes: number
+	parse: PhaseReport
+	convert: PhaseReport
+	full: PhaseReport
+	result_heap_mb: number | undefined
+	// everything allocated on the JS heap by one full call, including what the gc already freed
+	full_js_heap_allocated_mb: number
+	full_gc_count: number
+	peak_rss_mb: number
+	peak_malloced_mb: number
+}
+
+function median(values: number[]): number {
+	const sorted = [...values].sort((a, b) => a - b)
+	return sorted[Math.floor(sorted.length / 2)]
+}
+
+function phase_report(
+	timings_ms: number[],
+	bytes: number,
+	events: number
+): PhaseReport {
+	const median_ms = median(timings_ms)
+	const seconds = median_ms / 1000
+
+	return {
+		median_ms,
+		mb_per_second: bytes / MB / seconds,
+		events_per_second: Math.round(events / seconds),
+	}
+}
+
+function get_gc(): (() => void) | undefined {
+	return (globalThis as { gc?: () => void }).gc
+}
+
+// the heap growth caused by keeping one result alive
+function measure_result_heap(data: Buffer): number | undefined {
+	const gc = get_gc()
+
+	if (gc === undefined) {
+		return undefined
+	}
+
+	gc()
+	const before = process.memoryUsage().heapUsed
+
+	const result = AssParser.parse_ass_buffer(data, SETTINGS)
+
+	gc()
+	const after = process.memoryUsage().heapUsed
+
+	if (result.error) {
+		throw new Error(`parsing failed: ${JSON.stringify(result.diagnostics)}`)
+	}
+
+	return (after - before) / MB
+}
+
+// the used heap only grows between two collections, so the allocated bytes are the growth before
+// every collection and after the last one
+function measure_allocations(data: Buffer): {
+	allocated_mb: number
+	gc_count: number
+} {
+	const profiler = new v8.GCProfiler()
+
+	profiler.start()
+	let used = v8.getHeapStatistics().used_heap_size
+
+	const result = AssParser.parse_ass_buffer(data, SETTINGS)
+
+	const end_used = v8.getHeapStatistics().used_heap_size
+	const { statistics } = profiler.stop()
+
+	if (result.error) {
+		throw new Error(`parsing failed: ${JSON.stringify(result.diagnostics)}`)
+	}
+
+	let allocated = 0
+
+	for (const gc of statistics) {
+		allocated += gc.beforeGC.heapStatistics.usedHeapSize - used
+		used = gc.afterGC.heapStatistics.usedHeapSize
+	}
+
+	allocated += end_used - used
+
+	return { allocated_mb: allocated / MB, gc_count: statistics.length }
+}
+
+function run_case(events: number, encoding: ScriptEncoding): CaseReport {
+	const script = generate_script({
+		events,
+		styles: 200,
+		extra_section_entries: Math.ceil(events / 10),
+		non_ascii: encoding !== "utf8",
+	})
+
+	const data = encode_script(script, encoding)
+
+	// warmup
+	AssParser.parse_ass_buffer(data, SETTINGS)
+
+	const phases = AssParser.benchmark_phases(
+		{ type: "buffer", data },
+		SETTINGS,
+		ITERATIONS
+	)
+
+	const full_ms: number[] = []
+
+	for (let i = 0; i < ITERATIONS; ++i) {
+		const start = process.hrtime.bigint()
+		const result = AssParser.parse_ass_buffer(data, SETTINGS)
+		const end = process.hrtime.bigint()
+
+		if (result.error) {
+			throw new Error(`parsing failed: ${JSON.stringify(result.diagnostics)}`)
+		}
+
+		full_ms.push(Number(end - start) / 1e6)
+	}
+
+	const allocations = measure_allocations(data)
+
+	return {
+		events,
+		encoding,
+		bytes: data.length,
+		parse: phase_report(
+			phases.parse_ns.map((ns) => ns / 1e6),
+			data.length,
+			events
+		),
+		convert: phase_report(
+			phases.convert_ns.map((ns) => ns / 1e6),
+			data.length,
+			events
+		),
+		full: phase_report(full_ms, data.length, events),
+		result_heap_mb: measure_result_heap(data),
+		full_js_heap_allocated_mb: allocations.allocated_mb,
+		full_gc_count: allocations.gc_count,
+		// maxRSS is in kilobytes, it is the peak of the process, that only ran this case
+		peak_rss_mb: (process.resourceUsage().maxRSS * 1024) / MB,
+		peak_malloced_mb: v8.getHeapStatistics().peak_malloced_memory / MB,
+	}
+}
+
+function run_case_in_child(
+	events: number,
+	encoding: ScriptEncoding
+): CaseReport {
+	const child = spawnSync(
+		process.execPath,
+		[...process.execArgv, __filename],
+		{
+			env: { ...process.env, BENCH_CASE: `${events}:${encoding}` },
+			encoding: "utf8",
+			maxBuffer: 16 * MB,
+			stdio: ["ignore", "pipe", "inherit"],
+		}
+	)
+
+	if (child.status !== 0) {
+		throw new Error(
+			`the case ${events}:${encoding} failed with ${child.status ?? child.signal}`
+		)
+	}
+
+	return JSON.parse(child.stdout) as CaseReport
+}
+
+function main(): void {
+	const bench_case = process.env.BENCH_CASE
+
+	if (bench_case !== undefined) {
+		const [events, encoding] = bench_case.split(":")
+		const report = run_case(Number(events), encoding as ScriptEncoding)
+
+		console.log(JSON.stringify(report))
+		return
+	}
+
+	const cases: CaseReport[] = []
+
+	for (const events of SIZES) {
+		for (const encoding of ENCODINGS) {
+			cases.push(run_case_in_child(events, encoding))
+		}
+	}
+
+	console.log(
+		JSON.stringify(
+			{
+				node: process.version,
+				ass_parser: AssParser.version,
+				commit_hash: AssParser.commit_hash,
+				iterations: ITERATIONS,
+				cases,
+			},
+			null,
+			2
+		)
+	)
+}
+
+main()
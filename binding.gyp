@@ -57,7 +57,21 @@
             "defines": ["V8_DEPRECATION_WARNINGS=1"],
             "sources": [
                 "src/cpp/wrapper.cpp",
+                "src/cpp/ass_writer.cpp",
+                "src/cpp/cache.cpp",
+                "src/cpp/compiled_settings.cpp",
                 "src/cpp/convert.cpp",
+                "src/cpp/document.cpp",
+                "src/cpp/event_index.cpp",
+                "src/cpp/isolate_data.cpp",
+                "src/cpp/js_ass_reader.cpp",
+                "src/cpp/json_writer.cpp",
+                "src/cpp/lazy_list.cpp",
+                "src/cpp/script_lines.cpp",
+                "src/cpp/snapshot.cpp",
+                "src/cpp/stream_parser.cpp",
+                "src/cpp/string_converter.cpp",
+                "src/cpp/worker.cpp",
                 "src/cpp/module.cpp",
             ],
             "include_dirs": [
@@ -0,0 +1,396 @@
+#include "./ass_writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stb/ds.h>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+// the buffer is written to the file descriptor, once it is larger than this
+static constexpr size_t flush_threshold = static_cast<size_t>(1) << 20U;
+
+[[nodiscard]] static std::string_view line_break_of(LineType line_type) {
+	switch(line_type) {
+		case LineTypeCrLf: return "\r\n";
+		case LineTypeCr: return "\r";
+		case LineTypeLf:
+		default: return "\n";
+	}
+}
+
+AssWriter::AssWriter(LineType line_type, int fd)
+    : m_out{}, m_line_break{ line_break_of(line_type) }, m_fd{ fd }, m_written{ 0 }, m_error{} {}
+
+void AssWriter::reserve(size_t size) {
+	m_out.reserve(m_fd < 0 ? size : std::min(size, flush_threshold * 2));
+}
+
+void AssWriter::end_line() {
+	m_out.append(m_line_break);
+
+	if(m_fd >= 0 && m_out.size() >= flush_threshold) {
+		flush();
+	}
+}
+
+void AssWriter::flush() {
+
+	if(m_error.empty()) {
+		auto written = write_to_fd(m_fd, m_out);
+
+		if(written.has_value()) {
+			m_written += written.value();
+		} else {
+			m_error = std::move(written.error());
+		}
+	}
+
+	m_out.clear();
+}
+
+void AssWriter::append_str(const FinalStr& value, const StringConverter& strings) {
+	strings.append_utf8(m_out, value);
+}
+
+void AssWriter::append_time(const AssTime& time) {
+
+	auto append_two_digits = [this](uint8_t value) {
+		m_out.push_back(static_cast<char>('0' + (value / 10)));
+		m_out.push_back(static_cast<char>('0' + (value % 10)));
+	};
+
+	// H:MM:SS.CC
+	append_number(static_cast<uint32_t>(time.hour));
+	m_out.push_back(':');
+	append_two_digits(time.min);
+	m_out.push_back(':');
+	append_two_digits(time.sec);
+	m_out.push_back('.');
+	append_two_digits(time.hundred);
+}
+
+void AssWriter::append_color(const AssColor& color) {
+
+	static constexpr std::string_view hex_digits = "0123456789ABCDEF";
+
+	m_out.append("&H");
+
+	for(uint8_t value : { color.a, color.b, color.g, color.r }) {
+		m_out.push_back(hex_digits[value >> 4U]);
+		m_out.push_back(hex_digits[value & 0xFU]);
+	}
+}
+
+// the parser only reads "0000" as the default (the margin of the style), so an explicit 0 is
+// written as "0" and set values are not padded
+void AssWriter::append_margin(const MarginValue& margin) {
+
+	if(margin.is_default) {
+		m_out.append("0000");
+		return;
+	}
+
+	append_number(margin.data.value);
+}
+
+template <typename T> void AssWriter::append_number(T value) {
+
+	std::array<char, 24> buffer{};
+	auto [end, error] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+
+	assert(error == std::errc{} && "the buffer is large enough for every integer");
+
+	m_out.append(buffer.data(), end);
+}
+
+// the shortest representation, that reads back to the same value
+void AssWriter::append_double(double value) {
+
+	if(!std::isfinite(value) || value == 0) {
+		m_out.push_back('0');
+		return;
+	}
+
+	std::array<char, 32> buffer{};
+
+	// without an exponent, unless that doesn't fit
+	auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value,
+	                            std::chars_format::fixed);
+
+	if(result.ec != std::errc{}) {
+		result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+	}
+
+	m_out.append(buffer.data(), result.ptr);
+}
+
+void AssWriter::append_info_str(std::string_view key, const FinalStr& value,
+                                const StringConverter& strings) {
+
+	if(value.length == 0 || value.start == nullptr) {
+		return;
+	}
+
+	m_out.append(key);
+	m_out.append(": ");
+	append_str(value, strings);
+	end_line();
+}
+
+void AssWriter::append_info_number(std::string_view key, size_t value) {
+
+	if(value == 0) {
+		return;
+	}
+
+	m_out.append(key);
+	m_out.append(": ");
+	append_number(value);
+	end_line();
+}
+
+void AssWriter::write_bom() {
+	m_out.append("\xEF\xBB\xBF");
+}
+
+void AssWriter::write_script_info(const AssScriptInfo& script_info,
+                                  const StringConverter& strings) {
+
+	m_out.append("[Script Info]");
+	end_line();
+
+	append_info_str("Title", script_info.title, strings);
+	append_info_str("Original Script", script_info.original_script, strings);
+	append_info_str("Original Translation", script_info.original_translation, strings);
+	append_info_str("Original Editing", script_info.original_editing, strings);
+	append_info_str("Original Timing", script_info.original_timing, strings);
+	append_info_str("Synch Point", script_info.synch_point, strings);
+	append_info_str("Script Updated By", script_info.script_updated_by, strings);
+	append_info_str("Update Details", script_info.update_details, strings);
+
+	switch(script_info.script_type) {
+		case ScriptTypeV4:
+			m_out.append("ScriptType: v4.00");
+			end_line();
+			break;
+		case ScriptTypeV4Plus:
+			m_out.append("ScriptType: v4.00+");
+			end_line();
+			break;
+		case ScriptTypeUnknown:
+		default: break;
+	}
+
+	append_info_str("Collisions", script_info.collisions, strings);
+	append_info_number("PlayResY", script_info.play_res_y);
+	append_info_number("PlayResX", script_info.play_res_x);
+	append_info_str("PlayDepth", script_info.play_depth, strings);
+	append_info_str("Timer", script_info.timer, strings);
+
+	m_out.append("WrapStyle: ");
+	append_number(static_cast<uint32_t>(script_info.wrap_style));
+	end_line();
+
+	m_out.append("ScaledBorderAndShadow: ");
+	m_out.append(script_info.scaled_border_and_shadow ? "yes" : "no");
+	end_line();
+
+	append_info_number("Video Aspect Ratio", script_info.video_aspect_ratio);
+	append_info_number("Video Zoom", script_info.video_zoom);
+	append_info_str("YCbCr Matrix", script_info.ycbcr_matrix, strings);
+}
+
+void AssWriter::begin_styles() {
+	end_line();
+	m_out.append("[V4+ Styles]");
+	end_line();
+	m_out.append("Format: Name, Fontname, Fontsize, PrimaryColour, SecondaryColour, "
+	             "OutlineColour, BackColour, Bold, Italic, Underline, StrikeOut, ScaleX, ScaleY, "
+	             "Spacing, Angle, BorderStyle, Outline, Shadow, Alignment, MarginL, MarginR, "
+	             "MarginV, Encoding");
+	end_line();
+}
+
+void AssWriter::write_style(const AssStyleEntry& style, const StringConverter& strings) {
+
+	m_out.append("Style: ");
+	append_str(style.name, strings);
+	m_out.push_back(',');
+	append_str(style.fontname, strings);
+	m_out.push_back(',');
+	append_number(style.fontsize);
+
+	for(const AssColor& color : { style.primary_colour, style.secondary_colour,
+	                              style.outline_colour, style.back_colour }) {
+		m_out.push_back(',');
+		append_color(color);
+	}
+
+	// -1 is true in the ass format
+	for(bool value : { style.bold, style.italic, style.underline, style.strike_out }) {
+		m_out.append(value ? ",-1" : ",0");
+	}
+
+	m_out.push_back(',');
+	append_number(style.scale_x);
+	m_out.push_back(',');
+	append_number(style.scale_y);
+	m_out.push_back(',');
+	append_double(style.spacing);
+	m_out.push_back(',');
+	append_double(style.angle);
+	m_out.push_back(',');
+	append_number(static_cast<uint32_t>(style.border_style));
+	m_out.push_back(',');
+	append_double(style.outline);
+	m_out.push_back(',');
+	append_double(style.shadow);
+	m_out.push_back(',');
+	append_number(static_cast<uint32_t>(style.alignment));
+
+	for(size_t value : { style.margin_l, style.margin_r, style.margin_v, style.encoding }) {
+		m_out.push_back(',');
+		append_number(value);
+	}
+
+	end_line();
+}
+
+void AssWriter::begin_events() {
+	end_line();
+	m_out.append("[Events]");
+	end_line();
+	m_out.append("Format: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text");
+	end_line();
+}
+
+void AssWriter::write_event(const AssEventEntry& event, const StringConverter& strings) {
+
+	m_out.append(event_type_to_string(event.type));
+	m_out.append(": ");
+	append_number(event.layer);
+	m_out.push_back(',');
+	append_time(event.start);
+	m_out.push_back(',');
+	append_time(event.end);
+	m_out.push_back(',');
+	append_str(event.style, strings);
+	m_out.push_back(',');
+	append_str(event.name, strings);
+	m_out.push_back(',');
+	append_margin(event.margin_l);
+	m_out.push_back(',');
+	append_margin(event.margin_r);
+	m_out.push_back(',');
+	append_margin(event.margin_v);
+	m_out.push_back(',');
+	append_str(event.effect, strings);
+	m_out.push_back(',');
+	append_str(event.text, strings);
+
+	end_line();
+}
+
+void AssWriter::begin_section(std::string_view name) {
+	end_line();
+	m_out.push_back('[');
+	m_out.append(name);
+	m_out.push_back(']');
+	end_line();
+}
+
+void AssWriter::write_field(std::string_view key, const FinalStr& value,
+                            const StringConverter& strings) {
+	m_out.append(key);
+	m_out.append(": ");
+	append_str(value, strings);
+	end_line();
+}
+
+[[nodiscard]] std::expected<size_t, std::string> AssWriter::finish() {
+
+	if(m_fd >= 0) {
+		flush();
+	}
+
+	if(!m_error.empty()) {
+		return std::unexpected{ m_error };
+	}
+
+	return { m_written };
+}
+
+[[nodiscard]] std::string AssWriter::take() {
+	return std::move(m_out);
+}
+
+[[nodiscard]] std::expected<size_t, std::string> write_to_fd(int fd, std::string_view data) {
+#if defined(_WIN32)
+	UNUSED(fd);
+	UNUSED(data);
+	return std::unexpected{ "writing to a file descriptor is not supported on windows" };
+#else
+	size_t offset = 0;
+
+	while(offset < data.size()) {
+		ssize_t result = ::write(fd, data.data() + offset, data.size() - offset);
+
+		if(result < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+
+			return std::unexpected{ std::string{ "writing to the file descriptor failed: " } +
+				                    std::strerror(errno) };
+		}
+
+		offset += static_cast<size_t>(result);
+	}
+
+	return { offset };
+#endif
+}
+
+[[nodiscard]] size_t estimate_ass_size(std::span<const AssStyleEntry> styles,
+                                       std::span<const AssEventEntry> events) {
+
+	// everything but the strings of an entry
+	constexpr size_t bytes_per_style = 128;
+	constexpr size_t bytes_per_event = 64;
+	constexpr size_t base_bytes = 1024;
+
+	size_t size = base_bytes + (styles.size() * bytes_per_style);
+
+	for(const AssEventEntry& event : events) {
+		size += bytes_per_event + event.style.length + event.name.length + event.effect.length +
+		        event.text.length;
+	}
+
+	return size;
+}
+
+void write_extra_sections(AssWriter& writer, const ExtraSections& extra_sections,
+                          const StringConverter& strings) {
+
+	size_t sections_length = ZMAP_FOREACH_TODO(extra_sections.entries);
+
+	for(size_t i = 0; i < sections_length; ++i) {
+		const ExtraSectionHashMapEntry& section = extra_sections.entries[i];
+
+		writer.begin_section(section.key);
+
+		size_t fields_length = ZMAP_FOREACH_TODO(section.value.fields);
+
+		for(size_t j = 0; j < fields_length; ++j) {
+			const SectionFieldEntry& field = section.value.fields[j];
+
+			writer.write_field(field.key, field.value, strings);
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "./convert.hpp"
+
+#include <expected>
+#include <string>
+#include <string_view>
+
+// writes a script section by section into one output buffer, in the layout aegisub uses:
+// [Script Info], [V4+ Styles] and [Events] with their Format lines, then every extra section,
+// empty strings and zero numbers of the script info are left out, as they are the defaults of
+// the parser, every value is written, so that parsing the output returns the same entries
+//
+// with a file descriptor, the buffer is written to it, whenever it grows too large, so large
+// scripts don't have to be kept in memory as a whole
+struct AssWriter {
+  private:
+	std::string m_out;
+	std::string_view m_line_break;
+	// -1, if everything is kept in m_out
+	int m_fd;
+	size_t m_written;
+	// the first error of writing to m_fd, nothing is written after it
+	std::string m_error;
+
+	void end_line();
+
+	void flush();
+
+	void append_str(const FinalStr& value, const StringConverter& strings);
+
+	void append_time(const AssTime& time);
+
+	void append_color(const AssColor& color);
+
+	void append_margin(const MarginValue& margin);
+
+	template <typename T> void append_number(T value);
+
+	void append_double(double value);
+
+	void append_info_str(std::string_view key, const FinalStr& value,
+	                     const StringConverter& strings);
+
+	void append_info_number(std::string_view key, size_t value);
+
+  public:
+	AssWriter(LineType line_type, int fd);
+
+	void reserve(size_t size);
+
+	// the output is always UTF-8
+	void write_bom();
+
+	void write_script_info(const AssScriptInfo& script_info, const StringConverter& strings);
+
+	void begin_styles();
+
+	void write_style(const AssStyleEntry& style, const StringConverter& strings);
+
+	void begin_events();
+
+	void write_event(const AssEventEntry& event, const StringConverter& strings);
+
+	void begin_section(std::string_view name);
+
+	void write_field(std::string_view key, const FinalStr& value, const StringConverter& strings);
+
+	// writes the rest to the file descriptor, returns the number of bytes written to it
+	[[nodiscard]] std::expected<size_t, std::string> finish();
+
+	// the output, if there is no file descriptor
+	[[nodiscard]] std::string take();
+};
+
+// a blocking write(2) of all of data, that retries interrupted and partial writes, returns the
+// number of written bytes
+[[nodiscard]] std::expected<size_t, std::string> write_to_fd(int fd, std::string_view data);
+
+// an estimate of the size of the output of the entries, for AssWriter::reserve
+[[nodiscard]] size_t estimate_ass_size(std::span<const AssStyleEntry> styles,
+                                       std::span<const AssEventEntry> events);
+
+// writes the extra sections of a native result, the strings are converted with strings
+void write_extra_sections(AssWriter& writer, const ExtraSections& extra_sections,
+                          const StringConverter& strings);
@@ -0,0 +1,353 @@
+#include "./cache.hpp"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+
+// xxHash64, fast non cryptographic hash of the content of string and buffer sources
+
+static constexpr uint64_t xxh64_prime_1 = 11400714785074694791ULL;
+static constexpr uint64_t xxh64_prime_2 = 14029467366897019727ULL;
+static constexpr uint64_t xxh64_prime_3 = 1609587929392839161ULL;
+static constexpr uint64_t xxh64_prime_4 = 9650029242287828579ULL;
+static constexpr uint64_t xxh64_prime_5 = 2870177450012600261ULL;
+
+[[nodiscard]] static uint64_t xxh64_read_64(const uint8_t* data) {
+	uint64_t value{};
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+[[nodiscard]] static uint32_t xxh64_read_32(const uint8_t* data) {
+	uint32_t value{};
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+[[nodiscard]] static uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+	acc += input * xxh64_prime_2;
+	acc = std::rotl(acc, 31);
+	return acc * xxh64_prime_1;
+}
+
+[[nodiscard]] static uint64_t xxh64_merge_round(uint64_t acc, uint64_t value) {
+	acc ^= xxh64_round(0, value);
+	return (acc * xxh64_prime_1) + xxh64_prime_4;
+}
+
+[[nodiscard]] static uint64_t xxh64(const uint8_t* data, size_t length, uint64_t seed) {
+
+	const uint8_t* const end = data + length;
+
+	uint64_t hash{};
+
+	if(length >= 32) {
+		uint64_t v1 = seed + xxh64_prime_1 + xxh64_prime_2;
+		uint64_t v2 = seed + xxh64_prime_2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - xxh64_prime_1;
+
+		for(; data + 32 <= end; data += 32) {
+			v1 = xxh64_round(v1, xxh64_read_64(data));
+			v2 = xxh64_round(v2, xxh64_read_64(data + 8));
+			v3 = xxh64_round(v3, xxh64_read_64(data + 16));
+			v4 = xxh64_round(v4, xxh64_read_64(data + 24));
+		}
+
+		hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+		hash = xxh64_merge_round(hash, v1);
+		hash = xxh64_merge_round(hash, v2);
+		hash = xxh64_merge_round(hash, v3);
+		hash = xxh64_merge_round(hash, v4);
+	} else {
+		hash = seed + xxh64_prime_5;
+	}
+
+	hash += static_cast<uint64_t>(length);
+
+	for(; data + 8 <= end; data += 8) {
+		hash ^= xxh64_round(0, xxh64_read_64(data));
+		hash = (std::rotl(hash, 27) * xxh64_prime_1) + xxh64_prime_4;
+	}
+
+	if(data + 4 <= end) {
+		hash ^= static_cast<uint64_t>(xxh64_read_32(data)) * xxh64_prime_1;
+		hash = (std::rotl(hash, 23) * xxh64_prime_2) + xxh64_prime_3;
+		data += 4;
+	}
+
+	for(; data < end; ++data) {
+		hash ^= static_cast<uint64_t>(*data) * xxh64_prime_5;
+		hash = std::rotl(hash, 11) * xxh64_prime_1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= xxh64_prime_2;
+	hash ^= hash >> 29;
+	hash *= xxh64_prime_3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+// cache keys
+
+template <typename T> static void append_key_value(std::string& key, const T& value) {
+	key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// every field on its own, so that padding bytes don't end up in the key
+static void append_settings_key(std::string& key, const ParseSettings& settings) {
+
+	const StrictSettings& strict = settings.strict_settings;
+
+	append_key_value(key, strict.script_info.allow_duplicate_fields);
+	append_key_value(key, strict.script_info.allow_missing_script_type);
+	append_key_value(key, strict.allow_additional_fields);
+	append_key_value(key, strict.allow_number_truncating);
+	append_key_value(key, strict.allow_unrecognized_file_encoding);
+	append_key_value(key, strict.allow_validation_errors);
+
+	const ValidateSettings& validate = settings.validate_settings;
+
+	append_key_value(key, static_cast<int64_t>(validate.font_settings.preset));
+	append_key_value(key, validate.validate_styles);
+	append_key_value(key, validate.validate_text);
+}
+
+static void append_content_key(std::string& key, const uint8_t* data, size_t size) {
+	key.push_back('c');
+	append_key_value(key, xxh64(data, size, 0));
+	append_key_value(key, static_cast<uint64_t>(size));
+}
+
+struct CacheKey {
+	std::string key;
+	// the size of the source, used to estimate the size of the result
+	size_t source_size;
+};
+
+// nullopt, if the source can't be cached (e.g. the file doesn't exist)
+[[nodiscard]] static std::optional<CacheKey> get_cache_key(const AssSourceCpp& source,
+                                                           const ParseSettings& settings) {
+
+	auto file_key = [](const std::string& file) -> std::optional<CacheKey> {
+		std::error_code error{};
+
+		// relative paths depend on the working directory, which may change between two parses
+		auto path = std::filesystem::weakly_canonical(file, error);
+
+		if(error) {
+			return std::nullopt;
+		}
+
+		auto size = std::filesystem::file_size(path, error);
+
+		if(error) {
+			return std::nullopt;
+		}
+
+		auto modified = std::filesystem::last_write_time(path, error);
+
+		if(error) {
+			return std::nullopt;
+		}
+
+		std::string key{ "f" };
+		append_key_value(key, static_cast<uint64_t>(size));
+		append_key_value(key,
+		                 static_cast<int64_t>(modified.time_since_epoch().count()));
+		key.append(path.string());
+		key.push_back('\0');
+
+		return CacheKey{ .key = std::move(key), .source_size = static_cast<size_t>(size) };
+	};
+
+	auto result = std::visit(
+	    helper::Overloaded{
+	        [&file_key](const FileSourceCpp& file_source) -> std::optional<CacheKey> {
+		        return file_key(file_source.file);
+	        },
+	        [&file_key](const MappedFileSourceCpp& mapped_source) -> std::optional<CacheKey> {
+		        return file_key(mapped_source.file);
+	        },
+	        [](const StringSourceCpp& string_source) -> std::optional<CacheKey> {
+		        std::string key{};
+		        append_content_key(key, reinterpret_cast<const uint8_t*>(string_source.str.data()),
+		                           string_source.str.size());
+		        return CacheKey{ .key = std::move(key), .source_size = string_source.str.size() };
+	        },
+	        [](const BufferSourceCpp& buffer_source) -> std::optional<CacheKey> {
+		        std::string key{};
+		        append_content_key(key, buffer_source.data, buffer_source.size);
+		        return CacheKey{ .key = std::move(key), .source_size = buffer_source.size };
+	        },
+	    },
+	    source);
+
+	if(result.has_value()) {
+		append_settings_key(result->key, settings);
+	}
+
+	return result;
+}
+
+// the parse result keeps (a normalized copy of) the source and the entry arrays
+[[nodiscard]] static size_t estimate_result_bytes(AssParseResultCpp& result, size_t source_size) {
+
+	size_t bytes = source_size + sizeof(AssParseResultCpp);
+
+	std::visit(helper::Overloaded{
+	               [](const AssParseResultErrorCpp&) -> void {},
+	               [&bytes](const AssParseResultOkCpp& result_ok) -> void {
+		               bytes += ZVEC_LENGTH(result_ok.result.events.entries) *
+		                        sizeof(AssEventEntry);
+		               bytes += ZVEC_LENGTH(result_ok.result.styles.entries) *
+		                        sizeof(AssStyleEntry);
+	               },
+	           },
+	           result.result());
+
+	return bytes;
+}
+
+// the cache
+
+ParseCache::ParseCache()
+    : m_mutex{},
+      m_enabled{ false },
+      m_max_bytes{ 0 },
+      m_bytes{ 0 },
+      m_entries{},
+      m_index{},
+      m_hits{ 0 },
+      m_misses{ 0 },
+      m_evictions{ 0 } {}
+
+[[nodiscard]] ParseCache& ParseCache::instance() {
+	static ParseCache cache{};
+	return cache;
+}
+
+void ParseCache::evict_to_budget() {
+	while(m_bytes > m_max_bytes && !m_entries.empty()) {
+		const Entry& entry = m_entries.back();
+
+		m_bytes -= entry.bytes;
+		m_index.erase(entry.key);
+		m_entries.pop_back();
+		++m_evictions;
+	}
+}
+
+[[nodiscard]] std::shared_ptr<AssParseResultCpp> ParseCache::lookup(const std::string& key) {
+	std::lock_guard lock{ m_mutex };
+
+	auto iter = m_index.find(key);
+
+	if(iter == m_index.end()) {
+		++m_misses;
+		return nullptr;
+	}
+
+	++m_hits;
+
+	m_entries.splice(m_entries.begin(), m_entries, iter->second);
+
+	return iter->second->result;
+}
+
+void ParseCache::insert(std::string key, const std::shared_ptr<AssParseResultCpp>& result,
+                        size_t bytes) {
+	std::lock_guard lock{ m_mutex };
+
+	// the cache might have been disabled or shrunk, while parsing
+	if(!m_enabled || bytes > m_max_bytes) {
+		return;
+	}
+
+	// another thread parsed the same source at the same time
+	if(m_index.contains(key)) {
+		return;
+	}
+
+	m_entries.push_front(Entry{ .key = key, .result = result, .bytes = bytes });
+	m_index.emplace(std::move(key), m_entries.begin());
+	m_bytes += bytes;
+
+	evict_to_budget();
+}
+
+void ParseCache::configure(bool enabled, size_t max_bytes) {
+	std::lock_guard lock{ m_mutex };
+
+	m_enabled = enabled;
+	m_max_bytes = enabled ? max_bytes : 0;
+
+	evict_to_budget();
+}
+
+void ParseCache::clear() {
+	std::lock_guard lock{ m_mutex };
+
+	m_entries.clear();
+	m_index.clear();
+	m_bytes = 0;
+	m_hits = 0;
+	m_misses = 0;
+	m_evictions = 0;
+}
+
+[[nodiscard]] ParseCacheStats ParseCache::stats() const {
+	std::lock_guard lock{ m_mutex };
+
+	return ParseCacheStats{ .enabled = m_enabled,
+		                    .max_bytes = m_max_bytes,
+		                    .bytes = m_bytes,
+		                    .entries = m_entries.size(),
+		                    .hits = m_hits,
+		                    .misses = m_misses,
+		                    .evictions = m_evictions };
+}
+
+[[nodiscard]] std::shared_ptr<AssParseResultCpp>
+ParseCache::parse(const AssSourceCpp& source, ParseSettings settings, ParseProfile* profile) {
+
+	bool enabled{};
+	{
+		std::lock_guard lock{ m_mutex };
+		enabled = m_enabled;
+	}
+
+	if(!enabled) {
+		return parse_ass_cpp(source, settings, profile);
+	}
+
+	auto lookup_start = profile != nullptr ? ProfileClock::now() : ProfileClock::time_point{};
+
+	auto key = get_cache_key(source, settings);
+
+	if(not key.has_value()) {
+		return parse_ass_cpp(source, settings, profile);
+	}
+
+	if(auto cached = lookup(key->key); cached != nullptr) {
+		// hashing the source and looking it up replaces the parsing
+		if(profile != nullptr) {
+			profile->parse_ns = elapsed_ns(lookup_start, ProfileClock::now());
+			profile->cached = true;
+		}
+
+		return cached;
+	}
+
+	std::shared_ptr<AssParseResultCpp> result = parse_ass_cpp(source, settings, profile);
+
+	if(std::holds_alternative<AssParseResultOkCpp>(result->result())) {
+		auto bytes = estimate_result_bytes(*result, key->source_size);
+
+		insert(std::move(key->key), result, bytes);
+	}
+
+	return result;
+}
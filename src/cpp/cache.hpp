@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "./wrapper.hpp"
+
+struct ParseCacheStats {
+	bool enabled;
+	size_t max_bytes;
+	size_t bytes;
+	size_t entries;
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+};
+
+// a process wide LRU cache of successful parse results, disabled by default, file sources are
+// keyed by path, size and modification time, string and buffer sources by a hash of their content,
+// both together with the parse settings
+struct ParseCache {
+  private:
+	struct Entry {
+		std::string key;
+		std::shared_ptr<AssParseResultCpp> result;
+		// an estimate, the parse result doesn't report its real size
+		size_t bytes;
+	};
+
+	mutable std::mutex m_mutex;
+	bool m_enabled;
+	size_t m_max_bytes;
+	size_t m_bytes;
+	// most recently used first
+	std::list<Entry> m_entries;
+	std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+	uint64_t m_hits;
+	uint64_t m_misses;
+	uint64_t m_evictions;
+
+	ParseCache();
+
+	// evicts the least recently used entries, until the budget is met, needs the mutex
+	void evict_to_budget();
+
+	[[nodiscard]] std::shared_ptr<AssParseResultCpp> lookup(const std::string& key);
+
+	void insert(std::string key, const std::shared_ptr<AssParseResultCpp>& result, size_t bytes);
+
+  public:
+	[[nodiscard]] static ParseCache& instance();
+
+	void configure(bool enabled, size_t max_bytes);
+
+	void clear();
+
+	[[nodiscard]] ParseCacheStats stats() const;
+
+	// returns the cached result for the source, or parses it (outside of the lock) and caches the
+	// result, if it is not an error, can be called from any thread, profile may be nullptr
+	[[nodiscard]] std::shared_ptr<AssParseResultCpp>
+	parse(const AssSourceCpp& source, ParseSettings settings, ParseProfile* profile);
+};
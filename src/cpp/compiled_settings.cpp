@@ -0,0 +1,69 @@
+#include "./compiled_settings.hpp"
+#include "./isolate_data.hpp"
+
+CompiledSettings::CompiledSettings() : m_parse_settings{}, m_convert_settings{} {}
+
+NAN_MODULE_INIT(CompiledSettings::Init) {
+
+	UNUSED(target);
+
+	v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+	tpl->SetClassName(Nan::New("CompiledSettings").ToLocalChecked());
+	tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+	// every isolate (e.g. of a worker thread) has its own template
+	auto* isolate = v8::Isolate::GetCurrent();
+
+	IsolateData::get(isolate).set_compiled_settings_template(isolate, tpl);
+}
+
+[[nodiscard]] v8::Local<v8::Object>
+CompiledSettings::NewInstance(v8::Isolate* isolate, const ParseSettings& parse_settings,
+                              const ConvertSettings& convert_settings) {
+
+	v8::Local<v8::Function> cons =
+	    Nan::GetFunction(IsolateData::get(isolate).compiled_settings_template(isolate))
+	        .ToLocalChecked();
+
+	v8::Local<v8::Object> instance = Nan::NewInstance(cons, 0, nullptr).ToLocalChecked();
+
+	auto* settings = Nan::ObjectWrap::Unwrap<CompiledSettings>(instance);
+
+	settings->m_parse_settings = parse_settings;
+	settings->m_convert_settings = convert_settings;
+
+	return instance;
+}
+
+[[nodiscard]] const CompiledSettings* CompiledSettings::FromValue(v8::Isolate* isolate,
+                                                                  v8::Local<v8::Value> value) {
+
+	if(!value->IsObject() ||
+	   !IsolateData::get(isolate).compiled_settings_template(isolate)->HasInstance(value)) {
+		return nullptr;
+	}
+
+	return Nan::ObjectWrap::Unwrap<CompiledSettings>(value.As<v8::Object>());
+}
+
+[[nodiscard]] const ParseSettings& CompiledSettings::parse_settings() const {
+	return m_parse_settings;
+}
+
+[[nodiscard]] const ConvertSettings& CompiledSettings::convert_settings() const {
+	return m_convert_settings;
+}
+
+NAN_METHOD(CompiledSettings::New) {
+
+	if(!info.IsConstructCall()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("CompiledSettings can only be created by compile_settings"));
+		return;
+	}
+
+	auto* settings = new CompiledSettings();
+	settings->Wrap(info.This());
+
+	info.GetReturnValue().Set(info.This());
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "./convert.hpp"
+
+// an opaque handle, that holds already validated settings, so that they only have to be read
+// from js once, every parse entry point accepts it instead of a settings object
+class CompiledSettings : public Nan::ObjectWrap {
+  private:
+	ParseSettings m_parse_settings;
+	ConvertSettings m_convert_settings;
+
+	CompiledSettings();
+
+	static NAN_METHOD(New);
+
+  public:
+	static NAN_MODULE_INIT(Init);
+
+	[[nodiscard]] static v8::Local<v8::Object> NewInstance(v8::Isolate* isolate,
+	                                                       const ParseSettings& parse_settings,
+	                                                       const ConvertSettings& convert_settings);
+
+	// nullptr, if the value is not a CompiledSettings instance
+	[[nodiscard]] static const CompiledSettings* FromValue(v8::Isolate* isolate,
+	                                                       v8::Local<v8::Value> value);
+
+	[[nodiscard]] const ParseSettings& parse_settings() const;
+
+	[[nodiscard]] const ConvertSettings& convert_settings() const;
+};
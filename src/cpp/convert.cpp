@@ -1,9 +1,23 @@
 
 
 #include "./convert.hpp"
-
+#include "./compiled_settings.hpp"
+#include "./document.hpp"
+#include "./event_index.hpp"
+#include "./isolate_data.hpp"
+#include "./lazy_list.hpp"
+#include "./snapshot.hpp"
+#include "./stream_parser.hpp"
+#include "./string_converter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <optional>
+#include <span>
 #include <stb/ds.h>
+#include <string>
 
 // generic helper functions
 
@@ -12,11 +26,6 @@
 	return Nan::New<v8::String>(str).ToLocalChecked();
 }
 
-[[nodiscard]] static v8::Local<v8::String> str_to_js(const std::string& str) {
-
-	return Nan::New<v8::String>(str).ToLocalChecked();
-}
-
 // js to c
 
 [[nodiscard]] std::expected<AssSourceCpp, v8::Local<v8::Value>>
@@ -60,6 +69,26 @@ get_ass_source_from_info(v8::Local<v8::Value> value) {
 
 		auto name_value = std::string{ *Nan::Utf8String(name_value_raw) };
 
+		auto mmap_key = c_str_to_js("mmap");
+
+		if(object->Has(Nan::GetCurrentContext(), mmap_key).ToChecked()) {
+
+			auto mmap_value_raw = object->Get(Nan::GetCurrentContext(), mmap_key).ToLocalChecked();
+
+			if(!mmap_value_raw->IsUndefined()) {
+
+				if(!mmap_value_raw->IsBoolean()) {
+					return std::unexpected{ Nan::TypeError("source.mmap needs to be a boolean") };
+				}
+
+				if(Nan::To<bool>(mmap_value_raw).FromJust()) {
+					MappedFileSourceCpp result = { .file = name_value };
+
+					return { result };
+				}
+			}
+		}
+
 		FileSourceCpp result = { .file = name_value };
 
 		return { result };
@@ -83,10 +112,31 @@ get_ass_source_from_info(v8::Local<v8::Value> value) {
 
 		StringSourceCpp result = { .str = content_value };
 
+		return { result };
+	} else if(type_value == "buffer") {
+
+		auto data_key = c_str_to_js("data");
+
+		if(!object->Has(Nan::GetCurrentContext(), data_key).ToChecked()) {
+			return std::unexpected{ Nan::TypeError(
+				"the 'source' argument needs to have a 'data' key, if the type is 'buffer'") };
+		}
+
+		auto data_value_raw = object->Get(Nan::GetCurrentContext(), data_key).ToLocalChecked();
+
+		if(!data_value_raw->IsUint8Array()) {
+			return std::unexpected{ Nan::TypeError("source.data needs to be a Uint8Array") };
+		}
+
+		// no copy, the parser reads directly from the backing store of the Uint8Array
+		Nan::TypedArrayContents<uint8_t> contents{ data_value_raw };
+
+		BufferSourceCpp result = { .data = *contents, .size = contents.length() };
+
 		return { result };
 	} else {
 		return std::unexpected{ Nan::TypeError(
-			"source.type needs to be either 'file' or 'string'") };
+			"source.type needs to be either 'file', 'string' or 'buffer'") };
 	}
 }
 
@@ -348,6 +398,10 @@ get_validate_settings_from_js(v8::Isolate* isolate, v8::Local<v8::Object> object
 [[nodiscard]] std::expected<ParseSettings, v8::Local<v8::Value>>
 get_parse_settings_from_info(v8::Isolate* isolate, v8::Local<v8::Value> value) {
 
+	if(const auto* compiled = CompiledSettings::FromValue(isolate, value); compiled != nullptr) {
+		return { compiled->parse_settings() };
+	}
+
 	if(!value->IsObject()) {
 		return std::unexpected{ Nan::TypeError("the 'settings' argument needs to be an object") };
 	}
@@ -407,6 +461,293 @@ get_parse_settings_from_info(v8::Isolate* isolate, v8::Local<v8::Value> value) {
 	return { settings };
 }
 
+// reads an optional list of field names, that all have to be keys of the shape
+[[nodiscard]] static std::expected<std::optional<JsKeySet>, v8::Local<v8::Value>>
+get_optional_key_set_from_js(v8::Local<v8::Object> object, const char* key, JsShape shape,
+                             const std::string& name) {
+
+	auto js_key = c_str_to_js(key);
+
+	if(!object->Has(Nan::GetCurrentContext(), js_key).ToChecked()) {
+		return std::nullopt;
+	}
+
+	auto value_raw = object->Get(Nan::GetCurrentContext(), js_key).ToLocalChecked();
+
+	if(value_raw->IsUndefined()) {
+		return std::nullopt;
+	}
+
+	if(!value_raw->IsArray()) {
+		return std::unexpected{ Nan::TypeError(
+			(name + " needs to be an array of strings").c_str()) };
+	}
+
+	auto array = value_raw.As<v8::Array>();
+
+	auto shape_keys = js_shape_keys(shape);
+
+	JsKeySet result{};
+
+	for(uint32_t i = 0; i < array->Length(); ++i) {
+		auto entry_raw = Nan::Get(array, i).ToLocalChecked();
+
+		if(!entry_raw->IsString()) {
+			return std::unexpected{ Nan::TypeError(
+				(name + " needs to be an array of strings").c_str()) };
+		}
+
+		auto entry = std::string{ *Nan::Utf8String(entry_raw) };
+
+		auto shape_key = std::ranges::find_if(
+		    shape_keys, [&entry](JsKey shape_key) { return entry == js_key_name(shape_key); });
+
+		if(shape_key == shape_keys.end()) {
+			return std::unexpected{ Nan::TypeError(
+				(name + " contains the unknown field '" + entry + "'").c_str()) };
+		}
+
+		result.set(static_cast<size_t>(*shape_key));
+	}
+
+	return result;
+}
+
+[[nodiscard]] static std::expected<Projection, v8::Local<v8::Value>>
+get_projection_from_js(v8::Local<v8::Object> object) {
+
+	Projection projection = { .sections = js_shape_key_set(JsShape::Result),
+		                      .event_fields = js_shape_key_set(JsShape::Event),
+		                      .style_fields = js_shape_key_set(JsShape::Style) };
+
+	auto sections = get_optional_key_set_from_js(object, "sections", JsShape::Result,
+	                                             "settings.projection.sections");
+
+	if(not sections.has_value()) {
+		return std::unexpected{ sections.error() };
+	}
+
+	if(sections.value().has_value()) {
+		projection.sections = sections.value().value();
+	}
+
+	auto event_fields = get_optional_key_set_from_js(object, "event_fields", JsShape::Event,
+	                                                 "settings.projection.event_fields");
+
+	if(not event_fields.has_value()) {
+		return std::unexpected{ event_fields.error() };
+	}
+
+	if(event_fields.value().has_value()) {
+		projection.event_fields = event_fields.value().value();
+	}
+
+	auto style_fields = get_optional_key_set_from_js(object, "style_fields", JsShape::Style,
+	                                                 "settings.projection.style_fields");
+
+	if(not style_fields.has_value()) {
+		return std::unexpected{ style_fields.error() };
+	}
+
+	if(style_fields.value().has_value()) {
+		projection.style_fields = style_fields.value().value();
+	}
+
+	return { projection };
+}
+
+[[nodiscard]] std::expected<ConvertSettings, v8::Local<v8::Value>>
+get_convert_settings_from_info(v8::Isolate* isolate, v8::Local<v8::Value> value) {
+
+	if(const auto* compiled = CompiledSettings::FromValue(isolate, value); compiled != nullptr) {
+		return { compiled->convert_settings() };
+	}
+
+	ConvertSettings settings = { .result_mode = ResultMode::Eager,
+		                         .projection = {
+		                             .sections = js_shape_key_set(JsShape::Result),
+		                             .event_fields = js_shape_key_set(JsShape::Event),
+		                             .style_fields = js_shape_key_set(JsShape::Style),
+		                         },
+		                         .formats = { .time = TimeFormat::Object,
+		                                      .color = ColorFormat::Object },
+		                         .external_strings = false,
+		                         .profile = false,
+		                         .event_index = false };
+
+	if(!value->IsObject()) {
+		return std::unexpected{ Nan::TypeError("the 'settings' argument needs to be an object") };
+	}
+
+	auto object = value->ToObject(Nan::GetCurrentContext()).ToLocalChecked();
+
+	auto result_mode_key = c_str_to_js("result_mode");
+
+	if(object->Has(Nan::GetCurrentContext(), result_mode_key).ToChecked()) {
+
+		auto result_mode_value_raw =
+		    object->Get(Nan::GetCurrentContext(), result_mode_key).ToLocalChecked();
+
+		if(!result_mode_value_raw->IsUndefined()) {
+
+			if(!result_mode_value_raw->IsString()) {
+				return std::unexpected{ Nan::TypeError(
+					"settings.result_mode needs to be a string") };
+			}
+
+			auto result_mode_value = std::string{ *Nan::Utf8String(result_mode_value_raw) };
+
+			if(result_mode_value == "eager") {
+				settings.result_mode = ResultMode::Eager;
+			} else if(result_mode_value == "lazy") {
+				settings.result_mode = ResultMode::Lazy;
+			} else if(result_mode_value == "columnar") {
+				settings.result_mode = ResultMode::Columnar;
+			} else {
+				return std::unexpected{ Nan::TypeError(
+					"settings.result_mode needs to be either 'eager', 'lazy' or 'columnar'") };
+			}
+		}
+	}
+
+	auto time_format_key = c_str_to_js("time_format");
+
+	if(object->Has(Nan::GetCurrentContext(), time_format_key).ToChecked()) {
+
+		auto time_format_value_raw =
+		    object->Get(Nan::GetCurrentContext(), time_format_key).ToLocalChecked();
+
+		if(!time_format_value_raw->IsUndefined()) {
+
+			if(!time_format_value_raw->IsString()) {
+				return std::unexpected{ Nan::TypeError(
+					"settings.time_format needs to be a string") };
+			}
+
+			auto time_format_value = std::string{ *Nan::Utf8String(time_format_value_raw) };
+
+			if(time_format_value == "object") {
+				settings.formats.time = TimeFormat::Object;
+			} else if(time_format_value == "centiseconds") {
+				settings.formats.time = TimeFormat::Centiseconds;
+			} else if(time_format_value == "milliseconds") {
+				settings.formats.time = TimeFormat::Milliseconds;
+			} else {
+				return std::unexpected{ Nan::TypeError(
+					"settings.time_format needs to be either 'object', 'centiseconds' or "
+					"'milliseconds'") };
+			}
+		}
+	}
+
+	auto color_format_key = c_str_to_js("color_format");
+
+	if(object->Has(Nan::GetCurrentContext(), color_format_key).ToChecked()) {
+
+		auto color_format_value_raw =
+		    object->Get(Nan::GetCurrentContext(), color_format_key).ToLocalChecked();
+
+		if(!color_format_value_raw->IsUndefined()) {
+
+			if(!color_format_value_raw->IsString()) {
+				return std::unexpected{ Nan::TypeError(
+					"settings.color_format needs to be a string") };
+			}
+
+			auto color_format_value = std::string{ *Nan::Utf8String(color_format_value_raw) };
+
+			if(color_format_value == "object") {
+				settings.formats.color = ColorFormat::Object;
+			} else if(color_format_value == "packed") {
+				settings.formats.color = ColorFormat::Packed;
+			} else {
+				return std::unexpected{ Nan::TypeError(
+					"settings.color_format needs to be either 'object' or 'packed'") };
+			}
+		}
+	}
+
+	auto external_strings_key = c_str_to_js("external_strings");
+
+	if(object->Has(Nan::GetCurrentContext(), external_strings_key).ToChecked()) {
+
+		auto external_strings_value_raw =
+		    object->Get(Nan::GetCurrentContext(), external_strings_key).ToLocalChecked();
+
+		if(!external_strings_value_raw->IsUndefined()) {
+
+			if(!external_strings_value_raw->IsBoolean()) {
+				return std::unexpected{ Nan::TypeError(
+					"settings.external_strings needs to be a boolean") };
+			}
+
+			settings.external_strings = Nan::To<bool>(external_strings_value_raw).FromJust();
+		}
+	}
+
+	auto profile_key = c_str_to_js("profile");
+
+	if(object->Has(Nan::GetCurrentContext(), profile_key).ToChecked()) {
+
+		auto profile_value_raw =
+		    object->Get(Nan::GetCurrentContext(), profile_key).ToLocalChecked();
+
+		if(!profile_value_raw->IsUndefined()) {
+
+			if(!profile_value_raw->IsBoolean()) {
+				return std::unexpected{ Nan::TypeError("settings.profile needs to be a boolean") };
+			}
+
+			settings.profile = Nan::To<bool>(profile_value_raw).FromJust();
+		}
+	}
+
+	auto event_index_key = c_str_to_js("event_index");
+
+	if(object->Has(Nan::GetCurrentContext(), event_index_key).ToChecked()) {
+
+		auto event_index_value_raw =
+		    object->Get(Nan::GetCurrentContext(), event_index_key).ToLocalChecked();
+
+		if(!event_index_value_raw->IsUndefined()) {
+
+			if(!event_index_value_raw->IsBoolean()) {
+				return std::unexpected{ Nan::TypeError(
+					"settings.event_index needs to be a boolean") };
+			}
+
+			settings.event_index = Nan::To<bool>(event_index_value_raw).FromJust();
+		}
+	}
+
+	auto projection_key = c_str_to_js("projection");
+
+	if(object->Has(Nan::GetCurrentContext(), projection_key).ToChecked()) {
+
+		auto projection_value_raw =
+		    object->Get(Nan::GetCurrentContext(), projection_key).ToLocalChecked();
+
+		if(!projection_value_raw->IsUndefined()) {
+
+			if(!projection_value_raw->IsObject()) {
+				return std::unexpected{ Nan::TypeError(
+					"settings.projection needs to be an object") };
+			}
+
+			auto projection = get_projection_from_js(
+			    projection_value_raw->ToObject(Nan::GetCurrentContext()).ToLocalChecked());
+
+			if(not projection.has_value()) {
+				return std::unexpected{ projection.error() };
+			}
+
+			settings.projection = projection.value();
+		}
+	}
+
+	return { settings };
+}
+
 // c to js
 
 // basic conversions
@@ -436,24 +777,6 @@ get_parse_settings_from_info(v8::Isolate* isolate, v8::Local<v8::Value> value) {
 	return u64_to_appropiate_number(isolate, value);
 }
 
-[[nodiscard]] static v8::Local<v8::String> final_str_to_js(v8::Isolate* isolate,
-                                                           const FinalStr& str) {
-
-	UNUSED(isolate);
-
-	if(str.length == 0 || str.start == nullptr) {
-		return Nan::EmptyString();
-	}
-
-	char* value = get_normalized_string(str);
-
-	auto result = c_str_to_js(value);
-
-	free(value);
-
-	return result;
-}
-
 [[nodiscard]] static v8::Local<v8::Value> bool_to_js(v8::Isolate* isolate, bool value) {
 	UNUSED(isolate);
 
@@ -469,22 +792,130 @@ get_parse_settings_from_info(v8::Isolate* isolate, v8::Local<v8::Value> value) {
 	return Nan::New<v8::Number>(value);
 }
 
-using ObjectProperties = std::vector<std::pair<std::string, v8::Local<v8::Value>>>;
+// for counters and nanoseconds, that don't need the precision of a BigInt
+[[nodiscard]] static v8::Local<v8::Value> uint64_to_js_number(uint64_t value) {
+	return Nan::New<v8::Number>(static_cast<double>(value));
+}
+
+// for strings, that are returned from functions like event_type_to_string, they only get created
+// once per isolate
+[[nodiscard]] static v8::Local<v8::String> constant_str_to_js(v8::Isolate* isolate,
+                                                              const char* str) {
+
+	return IsolateData::get(isolate).constant(isolate, str);
+}
+
+using ObjectProperty = std::pair<JsKey, v8::Local<v8::Value>>;
+
+using ObjectProperties = std::vector<ObjectProperty>;
+
+// the keys have to be in the order of the shape, so that no property is added to the template
+using ShapeProperties = std::initializer_list<ObjectProperty>;
+
+// the largest shape has less keys than this
+static constexpr size_t max_shape_size = 32;
+
+// collects the properties of one object of a shape, the value of a key is only converted, if
+// the key is included in the projected fields
+struct ProjectedProperties {
+  private:
+	const JsKeySet& m_fields;
+	std::array<ObjectProperty, max_shape_size> m_properties;
+	size_t m_size;
+
+  public:
+	explicit ProjectedProperties(const JsKeySet& fields)
+	    : m_fields{ fields }, m_properties{}, m_size{ 0 } {}
+
+	template <typename Convert> void add(JsKey key, Convert&& convert) {
+
+		if(!m_fields.test(static_cast<size_t>(key))) {
+			return;
+		}
+
+		assert(m_size < max_shape_size && "max_shape_size is too small");
+
+		m_properties[m_size] = { key, convert() };
+		++m_size;
+	}
+
+	[[nodiscard]] std::span<const ObjectProperty> properties() const {
+		return { m_properties.data(), m_size };
+	}
+};
+
+static void set_js_properties(v8::Isolate* isolate, v8::Local<v8::Object> object,
+                              std::span<const ObjectProperty> properties) {
+
+	const auto& isolate_data = IsolateData::get(isolate);
+
+	auto context = isolate->GetCurrentContext();
+
+	for(const auto& [key, value] : properties) {
+		object->CreateDataProperty(context, isolate_data.key(isolate, key), value).Check();
+	}
+}
 
 [[nodiscard]] static v8::Local<v8::Value> make_js_object(v8::Isolate* isolate,
                                                          const ObjectProperties& properties) {
-	UNUSED(isolate);
+
+	const auto& isolate_data = IsolateData::get(isolate);
 
 	v8::Local<v8::Object> object = Nan::New<v8::Object>();
 
 	for(const auto& [key, value] : properties) {
-		v8::Local<v8::String> key_value = str_to_js(key);
-		Nan::Set(object, key_value, value).Check();
+		Nan::Set(object, isolate_data.key(isolate, key), value).Check();
+	}
+
+	return object;
+}
+
+// creates the object from the ObjectTemplate of the shape, so that all objects of this shape
+// share one hidden class and no map transitions happen while setting the properties
+[[nodiscard]] static v8::Local<v8::Object> make_js_object(v8::Isolate* isolate, JsShape shape,
+                                                          const ShapeProperties& properties) {
+
+	v8::Local<v8::Object> object = IsolateData::get(isolate)
+	                                   .object_template(isolate, shape)
+	                                   ->NewInstance(isolate->GetCurrentContext())
+	                                   .ToLocalChecked();
+
+	set_js_properties(isolate, object, { properties.begin(), properties.size() });
+
+	return object;
+}
+
+// only objects with every key of the shape are created from the template, otherwise the keys,
+// that are not projected, would still be present with the value undefined
+[[nodiscard]] static v8::Local<v8::Object> make_js_object(v8::Isolate* isolate, JsShape shape,
+                                                          const ProjectedProperties& projected) {
+
+	auto properties = projected.properties();
+
+	if(properties.size() == js_shape_keys(shape).size()) {
+		v8::Local<v8::Object> object = IsolateData::get(isolate)
+		                                   .object_template(isolate, shape)
+		                                   ->NewInstance(isolate->GetCurrentContext())
+		                                   .ToLocalChecked();
+
+		set_js_properties(isolate, object, properties);
+
+		return object;
 	}
 
+	v8::Local<v8::Object> object = Nan::New<v8::Object>();
+
+	set_js_properties(isolate, object, properties);
+
 	return object;
 }
 
+[[nodiscard]] static v8::Local<v8::Value> make_js_array(v8::Isolate* isolate,
+                                                        std::vector<v8::Local<v8::Value>>& values) {
+
+	return v8::Array::New(isolate, values.data(), values.size());
+}
+
 // complex structs / objects to js
 
 [[nodiscard]] static v8::Local<v8::Value> file_pos_to_js(v8::Isolate* isolate,
@@ -494,16 +925,16 @@ using ObjectProperties = std::vector<std::pair<std::string, v8::Local<v8::Value>
 
 	auto js_column = size_t_to_js(isolate, file_pos.column);
 
-	ObjectProperties properties{
-		{ "line", js_line },
-		{ "column", js_column },
+	ShapeProperties properties{
+		{ JsKey::line, js_line },
+		{ JsKey::column, js_column },
 
 	};
 
-	return make_js_object(isolate, properties);
+	return make_js_object(isolate, JsShape::FilePos, properties);
 }
 
-[[nodiscard]] static const char* diagnostic_severity_string(DiagnosticSeverity severity) {
+[[nodiscard]] const char* diagnostic_severity_string(DiagnosticSeverity severity) {
 	switch(severity) {
 		case DiagnosticSeverityError: return "error";
 		case DiagnosticSeverityWarning: return "warning";
@@ -516,57 +947,64 @@ using ObjectProperties = std::vector<std::pair<std::string, v8::Local<v8::Value>
 
 [[nodiscard]] static v8::Local<v8::Value>
 diagnostic_severity_to_js(v8::Isolate* isolate, const DiagnosticSeverity& severity) {
-	UNUSED(isolate);
-	return c_str_to_js(diagnostic_severity_string(severity));
+	return constant_str_to_js(isolate, diagnostic_severity_string(severity));
 }
 
+// position is nullptr, if the diagnostic has none
 [[nodiscard]] static v8::Local<v8::Value> diagnostic_to_js(v8::Isolate* isolate,
-                                                           const DiagnosticEntry& diagnostic) {
+                                                           v8::Local<v8::String> js_message,
+                                                           DiagnosticSeverity severity,
+                                                           const FilePos* position) {
 
-	UNUSED(isolate);
+	auto js_severity = diagnostic_severity_to_js(isolate, severity);
 
-	v8::Local<v8::Object> result = Nan::New<v8::Object>();
+	ShapeProperties properties{
+		{ JsKey::message, js_message },
+		{ JsKey::severity, js_severity },
+	};
 
-	MessageStruct message = get_message_from_entry(diagnostic);
+	auto result = make_js_object(isolate, JsShape::Diagnostic, properties);
 
-	auto js_message = c_str_to_js(message.message);
+	if(position != nullptr) {
 
-	free_message_struct(message);
+		auto js_position = file_pos_to_js(isolate, *position);
 
-	auto js_severity = diagnostic_severity_to_js(isolate, diagnostic.severity);
+		Nan::Set(result, IsolateData::get(isolate).key(isolate, JsKey::position), js_position)
+		    .Check();
+	}
 
-	ObjectProperties properties{
-		{ "message", js_message },
-		{ "severity", js_severity },
-	};
+	return result;
+}
 
-	if(!is_empty_pos(diagnostic.position)) {
+[[nodiscard]] static v8::Local<v8::Value> diagnostic_to_js(v8::Isolate* isolate,
+                                                           const DiagnosticEntry& diagnostic) {
 
-		auto js_position = file_pos_to_js(isolate, diagnostic.position);
+	MessageStruct message = get_message_from_entry(diagnostic);
 
-		properties.emplace_back("position", js_position);
-	}
+	auto js_message = c_str_to_js(message.message);
 
-	return make_js_object(isolate, properties);
+	free_message_struct(message);
 
-	return result;
+	return diagnostic_to_js(isolate, js_message, diagnostic.severity,
+	                        is_empty_pos(diagnostic.position) ? nullptr : &diagnostic.position);
 }
 
 [[nodiscard]] static v8::Local<v8::Value> diagnostics_to_js(v8::Isolate* isolate,
                                                             const Diagnostics& diagnostics) {
 
-	v8::Local<v8::Array> array = v8::Array::New(isolate);
+	std::vector<v8::Local<v8::Value>> values{};
+	values.reserve(ZVEC_LENGTH(diagnostics.entries));
 
 	for(size_t i = 0; i < ZVEC_LENGTH(diagnostics.entries); ++i) {
-		DiagnosticEntry diagnostic = diagnostics.entries[i];
+		const DiagnosticEntry& diagnostic = diagnostics.entries[i];
 
-		Nan::Set(array, i, diagnostic_to_js(isolate, diagnostic));
+		values.push_back(diagnostic_to_js(isolate, diagnostic));
 	}
 
-	return array;
+	return make_js_array(isolate, values);
 }
 
-[[nodiscard]] static const char* line_type_to_string(LineType line_type) {
+[[nodiscard]] const char* line_type_to_string(LineType line_type) {
 	switch(line_type) {
 		case LineTypeCrLf: return "CrLf";
 		case LineTypeLf: return "Lf";
@@ -580,11 +1018,10 @@ diagnostic_severity_to_js(v8::Isolate* isolate, const DiagnosticSeverity& severi
 
 [[nodiscard]] static v8::Local<v8::Value> line_type_to_js(v8::Isolate* isolate,
                                                           const LineType& line_type) {
-	UNUSED(isolate);
-	return c_str_to_js(line_type_to_string(line_type));
+	return constant_str_to_js(isolate, line_type_to_string(line_type));
 }
 
-[[nodiscard]] static const char* file_type_to_string(FileType file_type) {
+[[nodiscard]] const char* file_type_to_string(FileType file_type) {
 	switch(file_type) {
 		case FileTypeUnknown: return "Unknown";
 		case FileTypeUtf8: return "UTF-8";
@@ -601,8 +1038,7 @@ diagnostic_severity_to_js(v8::Isolate* isolate, const DiagnosticSeverity& severi
 
 [[nodiscard]] static v8::Local<v8::Value> file_type_to_js(v8::Isolate* isolate,
                                                           const FileType& file_type) {
-	UNUSED(isolate);
-	return c_str_to_js(file_type_to_string(file_type));
+	return constant_str_to_js(isolate, file_type_to_string(file_type));
 }
 
 [[nodiscard]] static v8::Local<v8::Value> file_props_to_js(v8::Isolate* isolate,
@@ -612,17 +1048,18 @@ diagnostic_severity_to_js(v8::Isolate* isolate, const DiagnosticSeverity& severi
 
 	auto js_file_type = file_type_to_js(isolate, file_props.file_type);
 
-	ObjectProperties properties{
-		{ "line_type", js_line_type },
-		{ "file_type", js_file_type },
+	ShapeProperties properties{
+		{ JsKey::line_type, js_line_type },
+		{ JsKey::file_type, js_file_type },
 
 	};
 
-	return make_js_object(isolate, properties);
+	return make_js_object(isolate, JsShape::FileProps, properties);
 }
 
 [[nodiscard]] static v8::Local<v8::Value>
-extra_section_entry_to_js(v8::Isolate* isolate, const ExtraSectionEntry& entry) {
+extra_section_entry_to_js(v8::Isolate* isolate, const ExtraSectionEntry& entry,
+                          StringConverter& strings) {
 
 	v8::Local<v8::Object> result = Nan::New<v8::Object>();
 
@@ -633,7 +1070,7 @@ extra_section_entry_to_js(v8::Isolate* isolate, const ExtraSectionEntry& entry)
 
 		v8::Local<v8::String> key_value = c_str_to_js(hm_entry.key);
 
-		auto js_value = final_str_to_js(isolate, hm_entry.value);
+		auto js_value = strings.convert(isolate, hm_entry.value);
 
 		Nan::Set(result, key_value, js_value).Check();
 	}
@@ -642,7 +1079,8 @@ extra_section_entry_to_js(v8::Isolate* isolate, const ExtraSectionEntry& entry)
 }
 
 [[nodiscard]] static v8::Local<v8::Value>
-extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections) {
+extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections,
+                     StringConverter& strings) {
 
 	v8::Local<v8::Object> result = Nan::New<v8::Object>();
 
@@ -653,7 +1091,7 @@ extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections)
 
 		v8::Local<v8::String> key_value = c_str_to_js(entry.key);
 
-		auto js_value = extra_section_entry_to_js(isolate, entry.value);
+		auto js_value = extra_section_entry_to_js(isolate, entry.value, strings);
 
 		Nan::Set(result, key_value, js_value).Check();
 	}
@@ -665,14 +1103,30 @@ extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections)
                                                        const MarginValue& value) {
 
 	if(value.is_default) {
-		return c_str_to_js("default");
+		return constant_str_to_js(isolate, "default");
 	}
 
 	return size_t_to_js(isolate, value.data.value);
 }
 
-[[nodiscard]] static v8::Local<v8::Value> ass_time_to_js(v8::Isolate* isolate,
-                                                         const AssTime& time) {
+[[nodiscard]] int32_t ass_time_to_centiseconds(const AssTime& time) {
+	return (((static_cast<int32_t>(time.hour) * 60 + time.min) * 60 + time.sec) * 100) +
+	       time.hundred;
+}
+
+[[nodiscard]] int32_t ass_time_to_ms(const AssTime& time) {
+	return ass_time_to_centiseconds(time) * 10;
+}
+
+[[nodiscard]] static v8::Local<v8::Value> ass_time_to_js(v8::Isolate* isolate, const AssTime& time,
+                                                         TimeFormat format) {
+
+	switch(format) {
+		case TimeFormat::Centiseconds: return Nan::New<v8::Int32>(ass_time_to_centiseconds(time));
+		case TimeFormat::Milliseconds: return Nan::New<v8::Int32>(ass_time_to_ms(time));
+		case TimeFormat::Object:
+		default: break;
+	}
 
 	auto js_hour = u32_to_js(isolate, time.hour);
 
@@ -682,17 +1136,17 @@ extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections)
 
 	auto js_hundred = u32_to_js(isolate, time.hundred);
 
-	ObjectProperties properties{
-		{ "hour", js_hour },
-		{ "min", js_min },
-		{ "sec", js_sec },
-		{ "hundred", js_hundred },
+	ShapeProperties properties{
+		{ JsKey::hour, js_hour },
+		{ JsKey::min, js_min },
+		{ JsKey::sec, js_sec },
+		{ JsKey::hundred, js_hundred },
 	};
 
-	return make_js_object(isolate, properties);
+	return make_js_object(isolate, JsShape::Time, properties);
 }
 
-[[nodiscard]] static const char* event_type_to_string(EventType event_type) {
+[[nodiscard]] const char* event_type_to_string(EventType event_type) {
 	switch(event_type) {
 		case EventTypeDialogue: return "Dialogue";
 		case EventTypeComment: return "Comment";
@@ -709,72 +1163,291 @@ extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections)
 
 [[nodiscard]] static v8::Local<v8::Value> event_type_to_js(v8::Isolate* isolate,
                                                            const EventType& event_type) {
-	UNUSED(isolate);
-	return c_str_to_js(event_type_to_string(event_type));
+	return constant_str_to_js(isolate, event_type_to_string(event_type));
 }
 
-[[nodiscard]] static v8::Local<v8::Value> event_to_js(v8::Isolate* isolate,
-                                                      const AssEventEntry& event) {
-
-	auto js_type = event_type_to_js(isolate, event.type);
+[[nodiscard]] v8::Local<v8::Value> event_to_js(v8::Isolate* isolate, const AssEventEntry& event,
+                                               const JsKeySet& fields, const ValueFormats& formats,
+                                               StringConverter& strings) {
 
-	auto js_layer = size_t_to_js(isolate, event.layer);
+	ProjectedProperties properties{ fields };
 
-	auto js_start = ass_time_to_js(isolate, event.start);
+	properties.add(JsKey::type, [&] { return event_type_to_js(isolate, event.type); });
 
-	auto js_end = ass_time_to_js(isolate, event.end);
+	properties.add(JsKey::layer, [&] { return size_t_to_js(isolate, event.layer); });
 
-	auto js_style = final_str_to_js(isolate, event.style);
+	properties.add(JsKey::start,
+	               [&] { return ass_time_to_js(isolate, event.start, formats.time); });
 
-	auto js_name = final_str_to_js(isolate, event.name);
+	properties.add(JsKey::end, [&] { return ass_time_to_js(isolate, event.end, formats.time); });
 
-	auto js_margin_l = margin_to_js(isolate, event.margin_l);
+	properties.add(JsKey::style,
+	               [&] { return strings.intern(isolate, event.style); });
 
-	auto js_margin_r = margin_to_js(isolate, event.margin_r);
+	properties.add(JsKey::name, [&] { return strings.intern(isolate, event.name); });
 
-	auto js_margin_v = margin_to_js(isolate, event.margin_v);
+	properties.add(JsKey::margin_l, [&] { return margin_to_js(isolate, event.margin_l); });
 
-	auto js_effect = final_str_to_js(isolate, event.effect);
+	properties.add(JsKey::margin_r, [&] { return margin_to_js(isolate, event.margin_r); });
 
-	auto js_text = final_str_to_js(isolate, event.text);
+	properties.add(JsKey::margin_v, [&] { return margin_to_js(isolate, event.margin_v); });
 
-	ObjectProperties properties{
-		{ "type", js_type },         { "layer", js_layer },       { "start", js_start },
-		{ "end", js_end },           { "style", js_style },       { "name", js_name },
-		{ "margin_l", js_margin_l }, { "margin_r", js_margin_r }, { "margin_v", js_margin_v },
-		{ "effect", js_effect },     { "text", js_text },
+	properties.add(JsKey::effect,
+	               [&] { return strings.intern(isolate, event.effect); });
 
-	};
+	properties.add(JsKey::text, [&] { return strings.convert_large(isolate, event.text); });
 
-	return make_js_object(isolate, properties);
+	return make_js_object(isolate, JsShape::Event, properties);
 }
 
 [[nodiscard]] static v8::Local<v8::Value> events_to_js(v8::Isolate* isolate,
-                                                       const AssEvents& events) {
-
-	v8::Local<v8::Array> array = v8::Array::New(isolate);
+                                                       std::span<const AssEventEntry> events,
+                                                       const JsKeySet& fields,
+                                                       const ValueFormats& formats,
+                                                       StringConverter& strings) {
 
-	for(size_t i = 0; i < ZVEC_LENGTH(events.entries); ++i) {
-		AssEventEntry event = events.entries[i];
+	std::vector<v8::Local<v8::Value>> values{};
+	values.reserve(events.size());
 
-		Nan::Set(array, i, event_to_js(isolate, event));
+	for(const AssEventEntry& event : events) {
+		values.push_back(event_to_js(isolate, event, fields, formats, strings));
 	}
 
-	return array;
-}
-
-[[nodiscard]] static v8::Local<v8::Value> border_style_to_js(v8::Isolate* isolate,
-                                                             const BorderStyle& style) {
-	return u32_to_js(isolate, static_cast<uint32_t>(style));
+	return make_js_array(isolate, values);
 }
 
-[[nodiscard]] static v8::Local<v8::Value> alignment_to_js(v8::Isolate* isolate,
-                                                          const AssAlignment& alignment) {
-	return u32_to_js(isolate, static_cast<uint32_t>(alignment));
-}
+// columnar events
 
-[[nodiscard]] static v8::Local<v8::Value> ass_color_to_js(v8::Isolate* isolate,
-                                                          const AssColor& color) {
+// the value of margin columns, if the margin is "default"
+static constexpr int32_t columnar_margin_default = -1;
+
+// the index into EVENT_TYPES on the js side
+[[nodiscard]] static uint8_t event_type_to_code(EventType event_type) {
+	switch(event_type) {
+		case EventTypeDialogue: return 0;
+		case EventTypeComment: return 1;
+		case EventTypePicture: return 2;
+		case EventTypeSound: return 3;
+		case EventTypeMovie: return 4;
+		case EventTypeCommand: return 5;
+		default: {
+			assert(false && "UNREACHABLE");
+			return std::numeric_limits<uint8_t>::max();
+		}
+	}
+}
+
+[[nodiscard]] static int32_t margin_to_column_value(const MarginValue& value) {
+
+	if(value.is_default) {
+		return columnar_margin_default;
+	}
+
+	return static_cast<int32_t>(
+	    std::min<size_t>(value.data.value, std::numeric_limits<int32_t>::max()));
+}
+
+// a typed array, whose backing store is written directly, instead of going through js values,
+// columns, that are not projected, are not allocated at all
+template <typename T, typename ArrayType> struct TypedColumn {
+	v8::Local<ArrayType> array;
+	T* data;
+
+	TypedColumn(v8::Isolate* isolate, size_t length, bool enabled) : array{}, data{ nullptr } {
+
+		if(!enabled) {
+			return;
+		}
+
+		auto buffer = v8::ArrayBuffer::New(isolate, length * sizeof(T));
+		array = ArrayType::New(buffer, 0, length);
+		data = static_cast<T*>(buffer->GetBackingStore()->Data());
+	}
+};
+
+// the strings of all events are stored in one UTF-8 buffer, every string column has length + 1
+// offsets into it, the string of event i is the range [offsets[i], offsets[i + 1])
+struct StringColumns {
+	std::string blob;
+	// the offsets of every added column, they are only checked and converted to js at the end
+	std::vector<std::vector<size_t>> offsets;
+
+	// appends the strings of all events, so that the strings of one column are next to each other,
+	// returns the index of the column
+	[[nodiscard]] size_t add_column(const AssEvents& events, FinalStr AssEventEntry::* member,
+	                                const StringConverter& strings) {
+
+		const size_t length = ZVEC_LENGTH(events.entries);
+
+		std::vector<size_t>& column = offsets.emplace_back();
+		column.reserve(length + 1);
+
+		for(size_t i = 0; i < length; ++i) {
+			column.push_back(blob.size());
+
+			strings.append_utf8(blob, events.entries[i].*member);
+		}
+
+		column.push_back(blob.size());
+
+		return offsets.size() - 1;
+	}
+
+	// Uint32Arrays, unless the blob is larger than 4 GiB, then Float64Arrays, which hold every
+	// offset up to 2^53 exactly
+	[[nodiscard]] v8::Local<v8::TypedArray> offsets_to_js(v8::Isolate* isolate,
+	                                                      size_t column_index) const {
+
+		const std::vector<size_t>& column = offsets[column_index];
+
+		if(blob.size() > std::numeric_limits<uint32_t>::max()) {
+			TypedColumn<double, v8::Float64Array> result{ isolate, column.size(), true };
+
+			for(size_t i = 0; i < column.size(); ++i) {
+				result.data[i] = static_cast<double>(column[i]);
+			}
+
+			return result.array;
+		}
+
+		TypedColumn<uint32_t, v8::Uint32Array> result{ isolate, column.size(), true };
+
+		for(size_t i = 0; i < column.size(); ++i) {
+			result.data[i] = static_cast<uint32_t>(column[i]);
+		}
+
+		return result.array;
+	}
+
+	[[nodiscard]] v8::Local<v8::ArrayBuffer> blob_to_js(v8::Isolate* isolate) const {
+
+		auto buffer = v8::ArrayBuffer::New(isolate, blob.size());
+
+		if(!blob.empty()) {
+			std::memcpy(buffer->GetBackingStore()->Data(), blob.data(), blob.size());
+		}
+
+		return buffer;
+	}
+};
+
+// builds the typed arrays directly from the native events, without creating an object per event
+[[nodiscard]] static v8::Local<v8::Value>
+events_to_columnar_js(v8::Isolate* isolate, const AssEvents& events, const JsKeySet& fields,
+                      StringConverter& strings) {
+
+	const size_t length = ZVEC_LENGTH(events.entries);
+
+	auto has_field = [&fields](JsKey key) -> bool { return fields.test(static_cast<size_t>(key)); };
+
+	StringColumns string_columns{};
+
+	std::array<std::optional<size_t>, 4> string_column_indices{};
+	std::array<std::pair<JsKey, FinalStr AssEventEntry::*>, 4> string_fields{ {
+	    { JsKey::style, &AssEventEntry::style },
+	    { JsKey::name, &AssEventEntry::name },
+	    { JsKey::effect, &AssEventEntry::effect },
+	    { JsKey::text, &AssEventEntry::text },
+	} };
+
+	for(size_t i = 0; i < string_fields.size(); ++i) {
+		if(has_field(string_fields[i].first)) {
+			string_column_indices[i] =
+			    string_columns.add_column(events, string_fields[i].second, strings);
+		}
+	}
+
+	TypedColumn<uint8_t, v8::Uint8Array> types{ isolate, length, has_field(JsKey::type) };
+	TypedColumn<uint32_t, v8::Uint32Array> layers{ isolate, length, has_field(JsKey::layer) };
+	TypedColumn<int32_t, v8::Int32Array> starts{ isolate, length, has_field(JsKey::start) };
+	TypedColumn<int32_t, v8::Int32Array> ends{ isolate, length, has_field(JsKey::end) };
+	TypedColumn<int32_t, v8::Int32Array> margins_l{ isolate, length, has_field(JsKey::margin_l) };
+	TypedColumn<int32_t, v8::Int32Array> margins_r{ isolate, length, has_field(JsKey::margin_r) };
+	TypedColumn<int32_t, v8::Int32Array> margins_v{ isolate, length, has_field(JsKey::margin_v) };
+
+	for(size_t i = 0; i < length; ++i) {
+		const AssEventEntry& event = events.entries[i];
+
+		if(types.data != nullptr) {
+			types.data[i] = event_type_to_code(event.type);
+		}
+
+		if(layers.data != nullptr) {
+			layers.data[i] = static_cast<uint32_t>(
+			    std::min<size_t>(event.layer, std::numeric_limits<uint32_t>::max()));
+		}
+
+		if(starts.data != nullptr) {
+			starts.data[i] = ass_time_to_ms(event.start);
+		}
+
+		if(ends.data != nullptr) {
+			ends.data[i] = ass_time_to_ms(event.end);
+		}
+
+		if(margins_l.data != nullptr) {
+			margins_l.data[i] = margin_to_column_value(event.margin_l);
+		}
+
+		if(margins_r.data != nullptr) {
+			margins_r.data[i] = margin_to_column_value(event.margin_r);
+		}
+
+		if(margins_v.data != nullptr) {
+			margins_v.data[i] = margin_to_column_value(event.margin_v);
+		}
+	}
+
+	// the columns are the projected event fields, but start and end are called start_ms and
+	// end_ms here, length and strings are always present
+	JsKeySet columns = fields;
+	columns.set(static_cast<size_t>(JsKey::start_ms), has_field(JsKey::start));
+	columns.set(static_cast<size_t>(JsKey::end_ms), has_field(JsKey::end));
+	columns.set(static_cast<size_t>(JsKey::length));
+	columns.set(static_cast<size_t>(JsKey::strings));
+
+	ProjectedProperties properties{ columns };
+
+	properties.add(JsKey::length, [&] { return size_t_to_js(isolate, length); });
+	properties.add(JsKey::type, [&] { return types.array; });
+	properties.add(JsKey::layer, [&] { return layers.array; });
+	properties.add(JsKey::start_ms, [&] { return starts.array; });
+	properties.add(JsKey::end_ms, [&] { return ends.array; });
+	properties.add(JsKey::margin_l, [&] { return margins_l.array; });
+	properties.add(JsKey::margin_r, [&] { return margins_r.array; });
+	properties.add(JsKey::margin_v, [&] { return margins_v.array; });
+	for(size_t i = 0; i < string_fields.size(); ++i) {
+		properties.add(string_fields[i].first, [&] {
+			return string_columns.offsets_to_js(isolate, string_column_indices[i].value());
+		});
+	}
+	properties.add(JsKey::strings, [&] { return string_columns.blob_to_js(isolate); });
+
+	return make_js_object(isolate, JsShape::EventColumns, properties);
+}
+
+[[nodiscard]] static v8::Local<v8::Value> border_style_to_js(v8::Isolate* isolate,
+                                                             const BorderStyle& style) {
+	return u32_to_js(isolate, static_cast<uint32_t>(style));
+}
+
+[[nodiscard]] static v8::Local<v8::Value> alignment_to_js(v8::Isolate* isolate,
+                                                          const AssAlignment& alignment) {
+	return u32_to_js(isolate, static_cast<uint32_t>(alignment));
+}
+
+[[nodiscard]] uint32_t ass_color_to_packed(const AssColor& color) {
+	return (static_cast<uint32_t>(color.a) << 24) | (static_cast<uint32_t>(color.b) << 16) |
+	       (static_cast<uint32_t>(color.g) << 8) | static_cast<uint32_t>(color.r);
+}
+
+[[nodiscard]] static v8::Local<v8::Value> ass_color_to_js(v8::Isolate* isolate,
+                                                          const AssColor& color,
+                                                          ColorFormat format) {
+
+	if(format == ColorFormat::Packed) {
+		return u32_to_js(isolate, ass_color_to_packed(color));
+	}
 
 	auto js_r = u32_to_js(isolate, color.r);
 
@@ -784,110 +1457,93 @@ extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections)
 
 	auto js_a = u32_to_js(isolate, color.a);
 
-	ObjectProperties properties{
-		{ "r", js_r },
-		{ "g", js_g },
-		{ "b", js_b },
-		{ "a", js_a },
+	ShapeProperties properties{
+		{ JsKey::r, js_r },
+		{ JsKey::g, js_g },
+		{ JsKey::b, js_b },
+		{ JsKey::a, js_a },
 	};
 
-	return make_js_object(isolate, properties);
+	return make_js_object(isolate, JsShape::Color, properties);
 }
 
-[[nodiscard]] static v8::Local<v8::Value> style_to_js(v8::Isolate* isolate,
-                                                      const AssStyleEntry& style) {
+[[nodiscard]] v8::Local<v8::Value> style_to_js(v8::Isolate* isolate, const AssStyleEntry& style,
+                                               const JsKeySet& fields, const ValueFormats& formats,
+                                               StringConverter& strings) {
 
-	auto js_name = final_str_to_js(isolate, style.name);
+	ProjectedProperties properties{ fields };
 
-	auto js_fontname = final_str_to_js(isolate, style.fontname);
+	properties.add(JsKey::name, [&] { return strings.convert(isolate, style.name); });
 
-	auto js_fontsize = size_t_to_js(isolate, style.fontsize);
+	properties.add(JsKey::fontname, [&] { return strings.convert(isolate, style.fontname); });
 
-	auto js_primary_colour = ass_color_to_js(isolate, style.primary_colour);
+	properties.add(JsKey::fontsize, [&] { return size_t_to_js(isolate, style.fontsize); });
 
-	auto js_secondary_colour = ass_color_to_js(isolate, style.secondary_colour);
+	properties.add(JsKey::primary_colour,
+	               [&] { return ass_color_to_js(isolate, style.primary_colour, formats.color); });
 
-	auto js_outline_colour = ass_color_to_js(isolate, style.outline_colour);
+	properties.add(JsKey::secondary_colour,
+	               [&] { return ass_color_to_js(isolate, style.secondary_colour, formats.color); });
 
-	auto js_back_colour = ass_color_to_js(isolate, style.back_colour);
+	properties.add(JsKey::outline_colour,
+	               [&] { return ass_color_to_js(isolate, style.outline_colour, formats.color); });
 
-	auto js_bold = bool_to_js(isolate, style.bold);
+	properties.add(JsKey::back_colour,
+	               [&] { return ass_color_to_js(isolate, style.back_colour, formats.color); });
 
-	auto js_italic = bool_to_js(isolate, style.italic);
+	properties.add(JsKey::bold, [&] { return bool_to_js(isolate, style.bold); });
 
-	auto js_underline = bool_to_js(isolate, style.underline);
+	properties.add(JsKey::italic, [&] { return bool_to_js(isolate, style.italic); });
 
-	auto js_strike_out = bool_to_js(isolate, style.strike_out);
+	properties.add(JsKey::underline, [&] { return bool_to_js(isolate, style.underline); });
 
-	auto js_scale_x = size_t_to_js(isolate, style.scale_x);
+	properties.add(JsKey::strike_out, [&] { return bool_to_js(isolate, style.strike_out); });
 
-	auto js_scale_y = size_t_to_js(isolate, style.scale_y);
+	properties.add(JsKey::scale_x, [&] { return size_t_to_js(isolate, style.scale_x); });
 
-	auto js_spacing = double_to_js(isolate, style.spacing);
+	properties.add(JsKey::scale_y, [&] { return size_t_to_js(isolate, style.scale_y); });
 
-	auto js_angle = double_to_js(isolate, style.angle);
+	properties.add(JsKey::spacing, [&] { return double_to_js(isolate, style.spacing); });
 
-	auto js_border_style = border_style_to_js(isolate, style.border_style);
+	properties.add(JsKey::angle, [&] { return double_to_js(isolate, style.angle); });
 
-	auto js_outline = double_to_js(isolate, style.outline);
+	properties.add(JsKey::border_style,
+	               [&] { return border_style_to_js(isolate, style.border_style); });
 
-	auto js_shadow = double_to_js(isolate, style.shadow);
+	properties.add(JsKey::outline, [&] { return double_to_js(isolate, style.outline); });
 
-	auto js_alignment = alignment_to_js(isolate, style.alignment);
+	properties.add(JsKey::shadow, [&] { return double_to_js(isolate, style.shadow); });
 
-	auto js_margin_l = size_t_to_js(isolate, style.margin_l);
+	properties.add(JsKey::alignment, [&] { return alignment_to_js(isolate, style.alignment); });
 
-	auto js_margin_r = size_t_to_js(isolate, style.margin_r);
+	properties.add(JsKey::margin_l, [&] { return size_t_to_js(isolate, style.margin_l); });
 
-	auto js_margin_v = size_t_to_js(isolate, style.margin_v);
+	properties.add(JsKey::margin_r, [&] { return size_t_to_js(isolate, style.margin_r); });
 
-	auto js_encoding = size_t_to_js(isolate, style.encoding);
+	properties.add(JsKey::margin_v, [&] { return size_t_to_js(isolate, style.margin_v); });
 
-	ObjectProperties properties{
-		{ "name", js_name },
-		{ "fontname", js_fontname },
-		{ "fontsize", js_fontsize },
-		{ "primary_colour", js_primary_colour },
-		{ "secondary_colour", js_secondary_colour },
-		{ "outline_colour", js_outline_colour },
-		{ "back_colour", js_back_colour },
-		{ "bold", js_bold },
-		{ "italic", js_italic },
-		{ "underline", js_underline },
-		{ "strike_out", js_strike_out },
-		{ "scale_x", js_scale_x },
-		{ "scale_y", js_scale_y },
-		{ "spacing", js_spacing },
-		{ "angle", js_angle },
-		{ "border_style", js_border_style },
-		{ "outline", js_outline },
-		{ "shadow", js_shadow },
-		{ "alignment", js_alignment },
-		{ "margin_l", js_margin_l },
-		{ "margin_r", js_margin_r },
-		{ "margin_v", js_margin_v },
-		{ "encoding", js_encoding },
+	properties.add(JsKey::encoding, [&] { return size_t_to_js(isolate, style.encoding); });
 
-	};
-
-	return make_js_object(isolate, properties);
+	return make_js_object(isolate, JsShape::Style, properties);
 }
 
 [[nodiscard]] static v8::Local<v8::Value> styles_to_js(v8::Isolate* isolate,
-                                                       const AssStyles& styles) {
+                                                       std::span<const AssStyleEntry> styles,
+                                                       const JsKeySet& fields,
+                                                       const ValueFormats& formats,
+                                                       StringConverter& strings) {
 
-	v8::Local<v8::Array> array = v8::Array::New(isolate);
+	std::vector<v8::Local<v8::Value>> values{};
+	values.reserve(styles.size());
 
-	for(size_t i = 0; i < ZVEC_LENGTH(styles.entries); ++i) {
-		AssStyleEntry style = styles.entries[i];
-
-		Nan::Set(array, i, style_to_js(isolate, style));
+	for(const AssStyleEntry& style : styles) {
+		values.push_back(style_to_js(isolate, style, fields, formats, strings));
 	}
 
-	return array;
+	return make_js_array(isolate, values);
 }
 
-[[nodiscard]] static const char* script_type_to_string(ScriptType script_type) {
+[[nodiscard]] const char* script_type_to_string(ScriptType script_type) {
 	switch(script_type) {
 		case ScriptTypeUnknown: return "Unknown";
 		case ScriptTypeV4: return "V4";
@@ -901,8 +1557,7 @@ extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections)
 
 [[nodiscard]] static v8::Local<v8::Value> script_type_to_js(v8::Isolate* isolate,
                                                             const ScriptType& script_type) {
-	UNUSED(isolate);
-	return c_str_to_js(script_type_to_string(script_type));
+	return constant_str_to_js(isolate, script_type_to_string(script_type));
 }
 
 [[nodiscard]] static v8::Local<v8::Value> wrap_style_to_js(v8::Isolate* isolate,
@@ -911,35 +1566,36 @@ extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections)
 }
 
 [[nodiscard]] static v8::Local<v8::Value> script_info_to_js(v8::Isolate* isolate,
-                                                            const AssScriptInfo& script_info) {
+                                                            const AssScriptInfo& script_info,
+                                                            StringConverter& strings) {
 
-	auto js_title = final_str_to_js(isolate, script_info.title);
+	auto js_title = strings.convert(isolate, script_info.title);
 
-	auto js_original_script = final_str_to_js(isolate, script_info.original_script);
+	auto js_original_script = strings.convert(isolate, script_info.original_script);
 
-	auto js_original_translation = final_str_to_js(isolate, script_info.original_translation);
+	auto js_original_translation = strings.convert(isolate, script_info.original_translation);
 
-	auto js_original_editing = final_str_to_js(isolate, script_info.original_editing);
+	auto js_original_editing = strings.convert(isolate, script_info.original_editing);
 
-	auto js_original_timing = final_str_to_js(isolate, script_info.original_timing);
+	auto js_original_timing = strings.convert(isolate, script_info.original_timing);
 
-	auto js_synch_point = final_str_to_js(isolate, script_info.synch_point);
+	auto js_synch_point = strings.convert(isolate, script_info.synch_point);
 
-	auto js_script_updated_by = final_str_to_js(isolate, script_info.script_updated_by);
+	auto js_script_updated_by = strings.convert(isolate, script_info.script_updated_by);
 
-	auto js_update_details = final_str_to_js(isolate, script_info.update_details);
+	auto js_update_details = strings.convert(isolate, script_info.update_details);
 
 	auto js_script_type = script_type_to_js(isolate, script_info.script_type);
 
-	auto js_collisions = final_str_to_js(isolate, script_info.collisions);
+	auto js_collisions = strings.convert(isolate, script_info.collisions);
 
 	auto js_play_res_y = size_t_to_js(isolate, script_info.play_res_y);
 
 	auto js_play_res_x = size_t_to_js(isolate, script_info.play_res_x);
 
-	auto js_play_depth = final_str_to_js(isolate, script_info.play_depth);
+	auto js_play_depth = strings.convert(isolate, script_info.play_depth);
 
-	auto js_timer = final_str_to_js(isolate, script_info.timer);
+	auto js_timer = strings.convert(isolate, script_info.timer);
 
 	auto js_wrap_style = wrap_style_to_js(isolate, script_info.wrap_style);
 
@@ -949,75 +1605,561 @@ extra_sections_to_js(v8::Isolate* isolate, const ExtraSections& extra_sections)
 
 	auto js_video_zoom = size_t_to_js(isolate, script_info.video_zoom);
 
-	auto js_ycbcr_matrix = final_str_to_js(isolate, script_info.ycbcr_matrix);
+	auto js_ycbcr_matrix = strings.convert(isolate, script_info.ycbcr_matrix);
+
+	ShapeProperties properties{
+		{ JsKey::title, js_title },
+		{ JsKey::original_script, js_original_script },
+		{ JsKey::original_translation, js_original_translation },
+		{ JsKey::original_editing, js_original_editing },
+		{ JsKey::original_timing, js_original_timing },
+		{ JsKey::synch_point, js_synch_point },
+		{ JsKey::script_updated_by, js_script_updated_by },
+		{ JsKey::update_details, js_update_details },
+		{ JsKey::script_type, js_script_type },
+		{ JsKey::collisions, js_collisions },
+		{ JsKey::play_res_y, js_play_res_y },
+		{ JsKey::play_res_x, js_play_res_x },
+		{ JsKey::play_depth, js_play_depth },
+		{ JsKey::timer, js_timer },
+		{ JsKey::wrap_style, js_wrap_style },
+		{ JsKey::scaled_border_and_shadow, js_scaled_border_and_shadow },
+		{ JsKey::video_aspect_ratio, js_video_aspect_ratio },
+		{ JsKey::video_zoom, js_video_zoom },
+		{ JsKey::ycbcr_matrix, js_ycbcr_matrix },
+	};
+
+	return make_js_object(isolate, JsShape::ScriptInfo, properties);
+}
+
+[[nodiscard]] static v8::Local<v8::Value>
+ass_result_to_js(v8::Isolate* isolate, const std::shared_ptr<AssParseResultCpp>& result,
+                 const AssResult& ass_result, const ConvertSettings& convert_settings,
+                 ParseProfile* profile) {
+
+	const Projection& projection = convert_settings.projection;
+
+	StringConverter strings{ ass_result.file_props.file_type,
+		                     convert_settings.external_strings ? result : nullptr };
+
+	ProjectedProperties properties{ projection.sections };
+
+	properties.add(JsKey::script_info,
+	               [&] { return script_info_to_js(isolate, ass_result.script_info, strings); });
+
+	properties.add(JsKey::styles, [&]() -> v8::Local<v8::Value> {
+		switch(convert_settings.result_mode) {
+			case ResultMode::Lazy:
+				return LazyList::NewInstance(isolate, result, LazyListKind::Styles,
+				                             convert_settings);
+			case ResultMode::Columnar:
+			case ResultMode::Eager:
+			default:
+				return styles_to_js(isolate,
+				                    { ass_result.styles.entries,
+				                      ZVEC_LENGTH(ass_result.styles.entries) },
+				                    projection.style_fields, convert_settings.formats, strings);
+		}
+	});
+
+	properties.add(JsKey::events, [&]() -> v8::Local<v8::Value> {
+		switch(convert_settings.result_mode) {
+			case ResultMode::Lazy:
+				return LazyList::NewInstance(isolate, result, LazyListKind::Events,
+				                             convert_settings);
+			case ResultMode::Columnar:
+				return events_to_columnar_js(isolate, ass_result.events, projection.event_fields,
+				                             strings);
+			case ResultMode::Eager:
+			default:
+				return events_to_js(isolate,
+				                    { ass_result.events.entries,
+				                      ZVEC_LENGTH(ass_result.events.entries) },
+				                    projection.event_fields, convert_settings.formats, strings);
+		}
+	});
+
+	properties.add(JsKey::extra_sections, [&] {
+		return extra_sections_to_js(isolate, ass_result.extra_sections, strings);
+	});
+
+	properties.add(JsKey::file_props,
+	               [&] { return file_props_to_js(isolate, ass_result.file_props); });
+
+	if(profile != nullptr) {
+		profile->strings_created = strings.created();
+	}
+
+	return make_js_object(isolate, JsShape::Result, properties);
+}
+
+// { read_ns, parse_ns, convert_ns }
+[[nodiscard]] static v8::Local<v8::Value> profile_timings_to_js(v8::Isolate* isolate,
+                                                                const ParseProfile& profile) {
 
 	ObjectProperties properties{
-		{ "title", js_title },
-		{ "original_script", js_original_script },
-		{ "original_translation", js_original_translation },
-		{ "original_editing", js_original_editing },
-		{ "original_timing", js_original_timing },
-		{ "synch_point", js_synch_point },
-		{ "script_updated_by", js_script_updated_by },
-		{ "update_details", js_update_details },
-		{ "script_type", js_script_type },
-		{ "collisions", js_collisions },
-		{ "play_res_y", js_play_res_y },
-		{ "play_res_x", js_play_res_x },
-		{ "play_depth", js_play_depth },
-		{ "timer", js_timer },
-		{ "wrap_style", js_wrap_style },
-		{ "scaled_border_and_shadow", js_scaled_border_and_shadow },
-		{ "video_aspect_ratio", js_video_aspect_ratio },
-		{ "video_zoom", js_video_zoom },
-		{ "ycbcr_matrix", js_ycbcr_matrix },
+		{ JsKey::read_ns, uint64_to_js_number(profile.read_ns) },
+		{ JsKey::parse_ns, uint64_to_js_number(profile.parse_ns) },
+		{ JsKey::convert_ns, uint64_to_js_number(profile.convert_ns) },
 	};
 
 	return make_js_object(isolate, properties);
 }
 
-[[nodiscard]] static v8::Local<v8::Value> ass_result_to_js(v8::Isolate* isolate,
-                                                           const AssResult& ass_result) {
+// { bytes_read, events, styles, strings_created, diagnostics, cached }
+[[nodiscard]] static v8::Local<v8::Value>
+profile_counters_to_js(v8::Isolate* isolate, const ParseProfile& profile,
+                       AssParseResultCpp& result) {
 
-	auto js_script_info = script_info_to_js(isolate, ass_result.script_info);
+	size_t events = 0;
+	size_t styles = 0;
 
-	auto js_styles = styles_to_js(isolate, ass_result.styles);
+	std::visit(helper::Overloaded{
+	               [](const AssParseResultErrorCpp&) -> void {},
+	               [&events, &styles](const AssParseResultOkCpp& result_ok) -> void {
+		               events = ZVEC_LENGTH(result_ok.result.events.entries);
+		               styles = ZVEC_LENGTH(result_ok.result.styles.entries);
+	               },
+	           },
+	           result.result());
 
-	auto js_events = events_to_js(isolate, ass_result.events);
+	ObjectProperties properties{
+		{ JsKey::bytes_read, uint64_to_js_number(profile.bytes_read) },
+		{ JsKey::events, uint64_to_js_number(events) },
+		{ JsKey::styles, uint64_to_js_number(styles) },
+		{ JsKey::strings_created, uint64_to_js_number(profile.strings_created) },
+		{ JsKey::diagnostics,
+		  uint64_to_js_number(ZVEC_LENGTH(result.diagnostics().entries)) },
+		{ JsKey::cached, bool_to_js(isolate, profile.cached) },
+	};
 
-	auto js_extra_sections = extra_sections_to_js(isolate, ass_result.extra_sections);
+	return make_js_object(isolate, properties);
+}
 
-	auto js_file_props = file_props_to_js(isolate, ass_result.file_props);
+std::shared_ptr<const EventIntervalIndex> build_event_index(AssParseResultCpp& result) {
 
-	ObjectProperties properties{ { "script_info", js_script_info },
-		                         { "styles", js_styles },
-		                         { "events", js_events },
-		                         { "extra_sections", js_extra_sections },
-		                         { "file_props", js_file_props } };
+	std::shared_ptr<const EventIntervalIndex> event_index = nullptr;
 
-	return make_js_object(isolate, properties);
+	std::visit(helper::Overloaded{
+	               [](const AssParseResultErrorCpp&) -> void {},
+	               [&event_index](const AssParseResultOkCpp& result_ok) -> void {
+		               const AssEvents& events = result_ok.result.events;
+
+		               event_index = EventIntervalIndex::from_events(
+		                   { events.entries, ZVEC_LENGTH(events.entries) });
+	               },
+	           },
+	           result.result());
+
+	return event_index;
 }
 
 v8::Local<v8::Value> ass_parse_result_to_js(v8::Isolate* isolate,
-                                            std::unique_ptr<AssParseResultCpp> result) {
+                                            std::shared_ptr<AssParseResultCpp> result,
+                                            const ConvertSettings& convert_settings,
+                                            ParseProfile* profile,
+                                            std::shared_ptr<const EventIntervalIndex> event_index) {
+
+	auto convert_start = profile != nullptr ? ProfileClock::now() : ProfileClock::time_point{};
 
 	auto js_diagnostics = diagnostics_to_js(isolate, result->diagnostics());
 
-	ObjectProperties properties{ { "diagnostics", js_diagnostics } };
+	ObjectProperties properties{ { JsKey::diagnostics, js_diagnostics } };
 
 	std::visit(helper::Overloaded{
 	               [&properties](const AssParseResultErrorCpp&) -> void {
-		               properties.emplace_back("error", Nan::True());
+		               properties.emplace_back(JsKey::error, Nan::True());
 	               },
-	               [&properties, isolate](const AssParseResultOkCpp& result_ok) -> void {
-		               properties.emplace_back("error", Nan::False());
+	               [&properties, &result, &convert_settings, profile,
+	                isolate](const AssParseResultOkCpp& result_ok) -> void {
+		               properties.emplace_back(JsKey::error, Nan::False());
 
-		               auto ass_result_js = ass_result_to_js(isolate, result_ok.result);
+		               auto ass_result_js = ass_result_to_js(isolate, result, result_ok.result,
+		                                                     convert_settings, profile);
 
-		               properties.emplace_back("result", ass_result_js);
+		               properties.emplace_back(JsKey::result, ass_result_js);
 	               },
 	           },
 	           result->result());
 
+	if(convert_settings.event_index) {
+		if(event_index == nullptr) {
+			event_index = build_event_index(*result);
+		}
+
+		if(event_index != nullptr) {
+			properties.emplace_back(JsKey::event_index,
+			                        EventIndex::NewInstance(isolate, std::move(event_index)));
+		}
+	}
+
+	if(profile != nullptr) {
+		profile->convert_ns = elapsed_ns(convert_start, ProfileClock::now());
+
+		properties.emplace_back(JsKey::timings, profile_timings_to_js(isolate, *profile));
+		properties.emplace_back(JsKey::counters,
+		                        profile_counters_to_js(isolate, *profile, *result));
+	}
+
+	return make_js_object(isolate, properties);
+}
+
+v8::Local<v8::Value> ass_parse_result_to_lint_js(v8::Isolate* isolate, AssParseResultCpp& result) {
+
+	auto js_diagnostics = diagnostics_to_js(isolate, result.diagnostics());
+
+	bool is_error = std::holds_alternative<AssParseResultErrorCpp>(result.result());
+
+	ObjectProperties properties{ { JsKey::diagnostics, js_diagnostics },
+		                         { JsKey::error, bool_to_js(isolate, is_error) } };
+
+	return make_js_object(isolate, properties);
+}
+
+std::expected<v8::Local<v8::Value>, v8::Local<v8::Value>>
+ass_parse_result_to_snapshot_js(v8::Isolate* isolate, AssParseResultCpp& result) {
+
+	auto parse_result = result.result();
+
+	if(std::holds_alternative<AssParseResultErrorCpp>(parse_result)) {
+		return { ass_parse_result_to_lint_js(isolate, result) };
+	}
+
+	const AssResult& ass_result = std::get<AssParseResultOkCpp>(parse_result).result;
+
+	auto snapshot = write_snapshot(ass_result, result.diagnostics());
+
+	if(not snapshot.has_value()) {
+		return std::unexpected{ Nan::TypeError(snapshot.error().c_str()) };
+	}
+
+	auto buffer = string_to_js_buffer(std::move(snapshot.value()));
+
+	if(not buffer.has_value()) {
+		return std::unexpected{ buffer.error() };
+	}
+
+	ObjectProperties properties{
+		{ JsKey::diagnostics, diagnostics_to_js(isolate, result.diagnostics()) },
+		{ JsKey::error, Nan::False() },
+		{ JsKey::result, buffer.value() },
+	};
+
+	return { make_js_object(isolate, properties) };
+}
+
+[[nodiscard]] static v8::Local<v8::Value>
+snapshot_diagnostics_to_js(v8::Isolate* isolate, const AssSnapshot& snapshot,
+                           StringConverter& strings) {
+
+	std::vector<v8::Local<v8::Value>> values{};
+	values.reserve(snapshot.diagnostics.size());
+
+	for(const SnapshotDiagnostic& diagnostic : snapshot.diagnostics) {
+		const FilePos* position = diagnostic.has_position ? &diagnostic.position : nullptr;
+
+		values.push_back(diagnostic_to_js(isolate, strings.convert(isolate, diagnostic.message),
+		                                  diagnostic.severity, position));
+	}
+
+	return make_js_array(isolate, values);
+}
+
+[[nodiscard]] static v8::Local<v8::Value>
+snapshot_extra_sections_to_js(v8::Isolate* isolate, const AssSnapshot& snapshot,
+                              StringConverter& strings) {
+
+	v8::Local<v8::Object> result = Nan::New<v8::Object>();
+
+	for(const SnapshotExtraSection& section : snapshot.extra_sections) {
+
+		v8::Local<v8::Object> js_section = Nan::New<v8::Object>();
+
+		for(size_t i = 0; i < section.field_count; ++i) {
+			const SnapshotSectionField& field = snapshot.extra_fields[section.first_field + i];
+
+			Nan::Set(js_section, strings.convert(isolate, field.key),
+			         strings.convert(isolate, field.value))
+			    .Check();
+		}
+
+		Nan::Set(result, strings.convert(isolate, section.name), js_section).Check();
+	}
+
+	return result;
+}
+
+std::expected<v8::Local<v8::Value>, v8::Local<v8::Value>>
+snapshot_to_ass_parse_result_js(v8::Isolate* isolate, const uint8_t* data, size_t size,
+                                const ConvertSettings& convert_settings) {
+
+	if(convert_settings.result_mode != ResultMode::Eager) {
+		return std::unexpected{ Nan::TypeError(
+			"snapshots can only be loaded with the result_mode 'eager'") };
+	}
+
+	auto snapshot = read_snapshot(data, size);
+
+	if(not snapshot.has_value()) {
+		return std::unexpected{ Nan::TypeError(("invalid snapshot: " + snapshot.error()).c_str()) };
+	}
+
+	const Projection& projection = convert_settings.projection;
+
+	auto strings = StringConverter::for_normalized_utf8();
+
+	auto js_diagnostics = snapshot_diagnostics_to_js(isolate, snapshot.value(), strings);
+
+	ProjectedProperties properties{ projection.sections };
+
+	properties.add(JsKey::script_info,
+	               [&] { return script_info_to_js(isolate, snapshot->script_info, strings); });
+
+	properties.add(JsKey::styles, [&] {
+		return styles_to_js(isolate, snapshot->styles, projection.style_fields,
+		                    convert_settings.formats, strings);
+	});
+
+	properties.add(JsKey::events, [&] {
+		return events_to_js(isolate, snapshot->events, projection.event_fields,
+		                    convert_settings.formats, strings);
+	});
+
+	properties.add(JsKey::extra_sections, [&] {
+		return snapshot_extra_sections_to_js(isolate, snapshot.value(), strings);
+	});
+
+	properties.add(JsKey::file_props,
+	               [&] { return file_props_to_js(isolate, snapshot->file_props); });
+
+	ObjectProperties result_properties{
+		{ JsKey::diagnostics, js_diagnostics },
+		{ JsKey::error, Nan::False() },
+		{ JsKey::result, make_js_object(isolate, JsShape::Result, properties) },
+	};
+
+	if(convert_settings.event_index) {
+		result_properties.emplace_back(
+		    JsKey::event_index,
+		    EventIndex::NewInstance(isolate, EventIntervalIndex::from_events(snapshot->events)));
+	}
+
+	return { make_js_object(isolate, result_properties) };
+}
+
+v8::Local<v8::Value> document_diagnostics_to_js(v8::Isolate* isolate,
+                                                const DocumentState& document) {
+
+	std::vector<v8::Local<v8::Value>> values{};
+	values.reserve(document.diagnostics().size());
+
+	for(const DocumentDiagnostic& diagnostic : document.diagnostics()) {
+		const FilePos* position = diagnostic.has_position ? &diagnostic.position : nullptr;
+
+		auto js_message = Nan::New<v8::String>(diagnostic.message).ToLocalChecked();
+
+		values.push_back(diagnostic_to_js(isolate, js_message, diagnostic.severity, position));
+	}
+
+	return make_js_array(isolate, values);
+}
+
+// { start, removed, inserted }
+[[nodiscard]] static v8::Local<v8::Value> entry_splice_to_js(v8::Isolate* isolate,
+                                                             const EntrySplice& splice) {
+
+	ObjectProperties properties{
+		{ JsKey::start, uint64_to_js_number(splice.start) },
+		{ JsKey::removed, uint64_to_js_number(splice.removed) },
+		{ JsKey::inserted, uint64_to_js_number(splice.inserted) },
+	};
+
+	return make_js_object(isolate, properties);
+}
+
+v8::Local<v8::Value> document_edit_to_js(v8::Isolate* isolate, const DocumentState& document,
+                                         const DocumentEdit& edit) {
+
+	ObjectProperties properties{
+		{ JsKey::diagnostics, document_diagnostics_to_js(isolate, document) },
+		{ JsKey::error, bool_to_js(isolate, document.error()) },
+		{ JsKey::full_reparse, bool_to_js(isolate, edit.full_reparse) },
+		{ JsKey::events, entry_splice_to_js(isolate, edit.events) },
+		{ JsKey::styles, entry_splice_to_js(isolate, edit.styles) },
+	};
+
+	return make_js_object(isolate, properties);
+}
+
+[[nodiscard]] static const char* stream_chunk_kind_to_string(StreamChunkKind kind) {
+	switch(kind) {
+		case StreamChunkKind::Header: return "header";
+		case StreamChunkKind::Events: return "events";
+		case StreamChunkKind::End: return "end";
+		case StreamChunkKind::Error: return "error";
+		default: {
+			assert(false && "UNREACHABLE");
+			return "<ERROR>";
+		}
+	}
+}
+
+// the lines before chunk.first_line are the header, which has the same lines as the stream, so
+// only the ones after it are moved
+[[nodiscard]] static v8::Local<v8::Value> stream_chunk_diagnostics_to_js(v8::Isolate* isolate,
+                                                                         const StreamChunk& chunk) {
+
+	std::vector<v8::Local<v8::Value>> values{};
+
+	if(chunk.result == nullptr) {
+		auto js_message = Nan::New<v8::String>(chunk.message).ToLocalChecked();
+
+		values.push_back(diagnostic_to_js(isolate, js_message, DiagnosticSeverityError, nullptr));
+
+		return make_js_array(isolate, values);
+	}
+
+	const bool report_all =
+	    chunk.kind == StreamChunkKind::Header || chunk.kind == StreamChunkKind::Error;
+
+	Diagnostics diagnostics = chunk.result->diagnostics();
+
+	for(size_t i = 0; i < ZVEC_LENGTH(diagnostics.entries); ++i) {
+		const DiagnosticEntry& diagnostic = diagnostics.entries[i];
+
+		const bool in_part =
+		    !is_empty_pos(diagnostic.position) && diagnostic.position.line >= chunk.first_line;
+
+		if(!report_all && !in_part) {
+			continue;
+		}
+
+		FilePos position = diagnostic.position;
+
+		if(in_part) {
+			position.line += chunk.line_offset;
+		}
+
+		MessageStruct message = get_message_from_entry(diagnostic);
+
+		auto js_message = c_str_to_js(message.message);
+
+		free_message_struct(message);
+
+		values.push_back(diagnostic_to_js(isolate, js_message, diagnostic.severity,
+		                                  is_empty_pos(position) ? nullptr : &position));
+	}
+
+	return make_js_array(isolate, values);
+}
+
+v8::Local<v8::Value> stream_chunk_to_js(v8::Isolate* isolate, const StreamChunk& chunk,
+                                        const ConvertSettings& convert_settings) {
+
+	ObjectProperties properties{
+		{ JsKey::kind, constant_str_to_js(isolate, stream_chunk_kind_to_string(chunk.kind)) },
+		{ JsKey::diagnostics, stream_chunk_diagnostics_to_js(isolate, chunk) },
+	};
+
+	if(chunk.kind == StreamChunkKind::Error) {
+		return make_js_object(isolate, properties);
+	}
+
+	auto parse_result = chunk.result->result();
+
+	const AssResult& ass_result = std::get<AssParseResultOkCpp>(parse_result).result;
+
+	const Projection& projection = convert_settings.projection;
+
+	StringConverter strings{ ass_result.file_props.file_type,
+		                     convert_settings.external_strings ? chunk.result : nullptr };
+
+	switch(chunk.kind) {
+		case StreamChunkKind::Header: {
+			properties.emplace_back(JsKey::script_info,
+			                        script_info_to_js(isolate, ass_result.script_info, strings));
+			properties.emplace_back(
+			    JsKey::styles,
+			    styles_to_js(isolate,
+			                 { ass_result.styles.entries, ZVEC_LENGTH(ass_result.styles.entries) },
+			                 projection.style_fields, convert_settings.formats, strings));
+			break;
+		}
+		case StreamChunkKind::Events: {
+			// only the events of the batch, not the ones of the header (which has none)
+			properties.emplace_back(
+			    JsKey::events,
+			    events_to_js(isolate,
+			                 { ass_result.events.entries, ZVEC_LENGTH(ass_result.events.entries) },
+			                 projection.event_fields, convert_settings.formats, strings));
+			break;
+		}
+		case StreamChunkKind::End: {
+			FileProps file_props = ass_result.file_props;
+			file_props.line_type = chunk.line_type;
+
+			properties.emplace_back(
+			    JsKey::extra_sections,
+			    extra_sections_to_js(isolate, ass_result.extra_sections, strings));
+			properties.emplace_back(JsKey::file_props, file_props_to_js(isolate, file_props));
+			break;
+		}
+		case StreamChunkKind::Error:
+		default: break;
+	}
+
+	return make_js_object(isolate, properties);
+}
+
+std::expected<v8::Local<v8::Value>, v8::Local<v8::Value>> string_to_js_buffer(std::string value) {
+
+	// Nan::NewBuffer takes the length as uint32_t
+	constexpr size_t max_length =
+	    std::min<size_t>(node::Buffer::kMaxLength, std::numeric_limits<uint32_t>::max());
+
+	if(value.size() > max_length) {
+		const std::string message = "the result of " + std::to_string(value.size()) +
+		                            " bytes is larger than the maximum Buffer length of " +
+		                            std::to_string(max_length) + " bytes";
+
+		return std::unexpected{ Nan::RangeError(message.c_str()) };
+	}
+
+	auto* owned = new std::string{ std::move(value) };
+
+	return Nan::NewBuffer(
+	           owned->data(), static_cast<uint32_t>(owned->size()),
+	           [](char* data, void* hint) -> void {
+		           UNUSED(data);
+		           delete static_cast<std::string*>(hint);
+	           },
+	           owned)
+	    .ToLocalChecked();
+}
+
+v8::Local<v8::Value> error_to_ass_parse_result_js(v8::Isolate* isolate,
+                                                  v8::Local<v8::Value> error) {
+
+	v8::Local<v8::Value> js_message = error;
+
+	if(error->IsObject()) {
+		auto error_object = error->ToObject(Nan::GetCurrentContext()).ToLocalChecked();
+
+		js_message = Nan::Get(error_object, IsolateData::get(isolate).key(isolate, JsKey::message))
+		                 .ToLocalChecked();
+	}
+
+	ObjectProperties diagnostic_properties{
+		{ JsKey::message, js_message },
+		{ JsKey::severity, diagnostic_severity_to_js(isolate, DiagnosticSeverityError) },
+	};
+
+	v8::Local<v8::Array> js_diagnostics = v8::Array::New(isolate);
+
+	Nan::Set(js_diagnostics, 0, make_js_object(isolate, diagnostic_properties)).Check();
+
+	ObjectProperties properties{ { JsKey::diagnostics, js_diagnostics },
+		                         { JsKey::error, Nan::True() } };
+
 	return make_js_object(isolate, properties);
 }
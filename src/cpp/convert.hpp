@@ -20,13 +20,165 @@
 
 #include <ass_parser_lib.h>
 
+#include "./isolate_data.hpp"
+#include "./string_converter.hpp"
 #include "./wrapper.hpp"
 
+// how events and styles are returned
+enum class ResultMode : uint8_t {
+	// plain arrays of objects
+	Eager,
+	// native backed lists, that only convert an entry when it is accessed
+	Lazy,
+	// events as typed arrays per field, styles as in Eager
+	Columnar,
+};
+
+// which parts of the result are converted to js, everything else is skipped
+struct Projection {
+	// keys of the result object
+	JsKeySet sections;
+	// keys of every event
+	JsKeySet event_fields;
+	// keys of every style
+	JsKeySet style_fields;
+};
+
+// how the start and end of events are returned
+enum class TimeFormat : uint8_t {
+	// { hour, min, sec, hundred }
+	Object,
+	// integers, these are Smis and can be compared directly
+	Centiseconds,
+	Milliseconds,
+};
+
+// how the colours of styles are returned
+enum class ColorFormat : uint8_t {
+	// { r, g, b, a }
+	Object,
+	// an unsigned 32 bit integer in the order of the ass format (&HAABBGGRR), so it is a Smi for
+	// every (nearly) opaque colour
+	Packed,
+};
+
+struct ValueFormats {
+	TimeFormat time;
+	ColorFormat color;
+};
+
+// settings, that only affect the conversion of the result to js, not the parsing itself
+struct ConvertSettings {
+	ResultMode result_mode;
+	Projection projection;
+	ValueFormats formats;
+	// large ASCII event texts are external strings, that point into the native result, which is
+	// then kept alive, until all of them are garbage collected
+	bool external_strings;
+	// adds timings and counters to the result, see ParseProfile
+	bool profile;
+	// adds an EventIndex of the events to the result
+	bool event_index;
+};
+
+// see event_index.hpp
+struct EventIntervalIndex;
+
+// see document.hpp
+struct DocumentState;
+struct DocumentEdit;
+
+// see stream_parser.hpp
+struct StreamChunk;
+
 [[nodiscard]] std::expected<AssSourceCpp, v8::Local<v8::Value>>
 get_ass_source_from_info(v8::Local<v8::Value> value);
 
 [[nodiscard]] std::expected<ParseSettings, v8::Local<v8::Value>>
 get_parse_settings_from_info(v8::Isolate* isolate, v8::Local<v8::Value> value);
 
-[[nodiscard]] v8::Local<v8::Value> ass_parse_result_to_js(v8::Isolate* isolate,
-                                                          std::unique_ptr<AssParseResultCpp> result);
+// reads the optional conversion specific keys of the 'settings' argument
+[[nodiscard]] std::expected<ConvertSettings, v8::Local<v8::Value>>
+get_convert_settings_from_info(v8::Isolate* isolate, v8::Local<v8::Value> value);
+
+// since 0:00:00.00
+[[nodiscard]] int32_t ass_time_to_centiseconds(const AssTime& time);
+
+[[nodiscard]] int32_t ass_time_to_ms(const AssTime& time);
+
+// &HAABBGGRR, see ColorFormat::Packed
+[[nodiscard]] uint32_t ass_color_to_packed(const AssColor& color);
+
+// the string values of the enums, as they are returned to js
+
+[[nodiscard]] const char* diagnostic_severity_string(DiagnosticSeverity severity);
+
+[[nodiscard]] const char* line_type_to_string(LineType line_type);
+
+[[nodiscard]] const char* file_type_to_string(FileType file_type);
+
+[[nodiscard]] const char* event_type_to_string(EventType event_type);
+
+[[nodiscard]] const char* script_type_to_string(ScriptType script_type);
+
+[[nodiscard]] v8::Local<v8::Value> event_to_js(v8::Isolate* isolate, const AssEventEntry& event,
+                                               const JsKeySet& fields, const ValueFormats& formats,
+                                               StringConverter& strings);
+
+[[nodiscard]] v8::Local<v8::Value> style_to_js(v8::Isolate* isolate, const AssStyleEntry& style,
+                                               const JsKeySet& fields, const ValueFormats& formats,
+                                               StringConverter& strings);
+
+// profile is nullptr, if convert_settings.profile is not set, otherwise it already contains the
+// values of parsing, the conversion is added to it, event_index is an index, that was already
+// built (e.g. on a worker thread), if convert_settings.event_index is set, it is built here, if
+// it is nullptr
+[[nodiscard]] v8::Local<v8::Value>
+ass_parse_result_to_js(v8::Isolate* isolate, std::shared_ptr<AssParseResultCpp> result,
+                       const ConvertSettings& convert_settings, ParseProfile* profile,
+                       std::shared_ptr<const EventIntervalIndex> event_index);
+
+// the index of the events of a successful result, nullptr for error results
+[[nodiscard]] std::shared_ptr<const EventIntervalIndex>
+build_event_index(AssParseResultCpp& result);
+
+// only { diagnostics, error }, the result itself is never converted
+[[nodiscard]] v8::Local<v8::Value> ass_parse_result_to_lint_js(v8::Isolate* isolate,
+                                                               AssParseResultCpp& result);
+
+// { diagnostics, error: false, result: Buffer } with a snapshot of the result (see snapshot.hpp),
+// error results are returned like ass_parse_result_to_lint_js does
+[[nodiscard]] std::expected<v8::Local<v8::Value>, v8::Local<v8::Value>>
+ass_parse_result_to_snapshot_js(v8::Isolate* isolate, AssParseResultCpp& result);
+
+// the same as ass_parse_result_to_js, but of a snapshot, which has to stay alive during the call,
+// only the eager result mode is supported
+[[nodiscard]] std::expected<v8::Local<v8::Value>, v8::Local<v8::Value>>
+snapshot_to_ass_parse_result_js(v8::Isolate* isolate, const uint8_t* data, size_t size,
+                                const ConvertSettings& convert_settings);
+
+// the current diagnostics of the document
+[[nodiscard]] v8::Local<v8::Value> document_diagnostics_to_js(v8::Isolate* isolate,
+                                                              const DocumentState& document);
+
+// { diagnostics, error, full_reparse, events, styles }, events and styles are
+// { start, removed, inserted }
+[[nodiscard]] v8::Local<v8::Value> document_edit_to_js(v8::Isolate* isolate,
+                                                       const DocumentState& document,
+                                                       const DocumentEdit& edit);
+
+// { kind, diagnostics } and the entries of the kind: script_info and styles for "header", events
+// for "events", extra_sections and file_props for "end", nothing for "error", the positions of
+// the diagnostics are the lines of the stream, only the eager result mode is supported
+[[nodiscard]] v8::Local<v8::Value> stream_chunk_to_js(v8::Isolate* isolate,
+                                                      const StreamChunk& chunk,
+                                                      const ConvertSettings& convert_settings);
+
+// a Buffer, that takes the ownership of the value (e.g. the JSON of json_writer.hpp or the script
+// of ass_writer.hpp), so it is not copied, a RangeError, if the value is larger than the maximum
+// length of a Buffer
+[[nodiscard]] std::expected<v8::Local<v8::Value>, v8::Local<v8::Value>>
+string_to_js_buffer(std::string value);
+
+[[nodiscard]] v8::Local<v8::Value> error_to_ass_parse_result_js(v8::Isolate* isolate,
+                                                                v8::Local<v8::Value> error);
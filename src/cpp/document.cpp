@@ -0,0 +1,518 @@
+#include "./document.hpp"
+#include "./isolate_data.hpp"
+#include "./lazy_list.hpp"
+#include "./script_lines.hpp"
+
+#include <algorithm>
+
+// the lines of the [Events] section, that can be parsed on their own
+struct EventsLayout {
+	size_t format_line;
+	// the line after the last event line, the next section header or the end of the document
+	size_t body_end;
+};
+
+// nullopt, if there is no [Events] section with a Format line, or if a styles section comes after
+// it, as event lines are parsed behind everything before their Format line
+[[nodiscard]] static std::optional<EventsLayout>
+find_events_layout(const std::vector<std::string>& lines) {
+
+	std::optional<size_t> events_header{};
+	std::optional<size_t> body_end{};
+
+	for(size_t i = 0; i < lines.size(); ++i) {
+		if(!is_section_header(lines[i])) {
+			continue;
+		}
+
+		if(!events_header.has_value()) {
+			if(is_events_header(lines[i])) {
+				events_header = i;
+			}
+
+			continue;
+		}
+
+		if(is_styles_header(lines[i])) {
+			return std::nullopt;
+		}
+
+		if(!body_end.has_value()) {
+			body_end = i;
+		}
+	}
+
+	if(!events_header.has_value()) {
+		return std::nullopt;
+	}
+
+	EventsLayout layout{ .format_line = 0, .body_end = body_end.value_or(lines.size()) };
+
+	for(size_t i = events_header.value() + 1; i < layout.body_end; ++i) {
+		if(is_format_line(lines[i])) {
+			layout.format_line = i;
+			return layout;
+		}
+
+		if(is_event_line(lines[i])) {
+			return std::nullopt;
+		}
+	}
+
+	return std::nullopt;
+}
+
+[[nodiscard]] static DocumentDiagnostic copy_diagnostic(const DiagnosticEntry& diagnostic) {
+
+	MessageStruct message = get_message_from_entry(diagnostic);
+
+	DocumentDiagnostic result{ .message = message.message,
+		                       .severity = diagnostic.severity,
+		                       .has_position = !is_empty_pos(diagnostic.position),
+		                       .position = diagnostic.position };
+
+	free_message_struct(message);
+
+	return result;
+}
+
+// the document
+
+DocumentState::DocumentState(ParseSettings settings, std::vector<std::string> lines)
+    : m_settings{ settings },
+      m_lines{ std::move(lines) },
+      m_error{ false },
+      m_file_type{ FileTypeUnknown },
+      m_diagnostics{},
+      m_events{},
+      m_styles{} {}
+
+void DocumentState::parse_all() {
+
+	std::shared_ptr<AssParseResultCpp> result =
+	    parse_ass_cpp(StringSourceCpp{ .str = text() }, m_settings, nullptr);
+
+	Diagnostics diagnostics = result->diagnostics();
+
+	m_diagnostics.clear();
+
+	for(size_t i = 0; i < ZVEC_LENGTH(diagnostics.entries); ++i) {
+		m_diagnostics.push_back(copy_diagnostic(diagnostics.entries[i]));
+	}
+
+	m_events.clear();
+	m_styles.clear();
+
+	std::visit(helper::Overloaded{
+	               [this](const AssParseResultErrorCpp&) -> void { m_error = true; },
+	               [this, &result](const AssParseResultOkCpp& result_ok) -> void {
+		               const AssResult& ass_result = result_ok.result;
+
+		               m_error = false;
+		               m_file_type = ass_result.file_props.file_type;
+
+		               for(size_t i = 0; i < ZVEC_LENGTH(ass_result.events.entries); ++i) {
+			               m_events.push_back({ result, ass_result.events.entries[i] });
+		               }
+
+		               for(size_t i = 0; i < ZVEC_LENGTH(ass_result.styles.entries); ++i) {
+			               m_styles.push_back({ result, ass_result.styles.entries[i] });
+		               }
+	               },
+	           },
+	           result->result());
+}
+
+[[nodiscard]] std::optional<DocumentEdit>
+DocumentState::reparse_event_lines(size_t start, size_t end, std::vector<std::string>& lines) {
+
+	// the error might be anywhere, so only parsing the whole document can clear it
+	if(m_error) {
+		return std::nullopt;
+	}
+
+	auto layout = find_events_layout(m_lines);
+
+	if(!layout.has_value() || start <= layout->format_line || end > layout->body_end) {
+		return std::nullopt;
+	}
+
+	if(std::ranges::any_of(lines, [](const std::string& line) {
+		   return is_section_header(line) || is_format_line(line);
+	   })) {
+		return std::nullopt;
+	}
+
+	std::span<const std::string> all_lines = m_lines;
+
+	const size_t first_event = count_event_lines(
+	    all_lines.subspan(layout->format_line + 1, start - layout->format_line - 1));
+	const size_t removed_events = count_event_lines(all_lines.subspan(start, end - start));
+	const size_t inserted_events = count_event_lines(lines);
+
+	std::vector<DocumentEntry<AssEventEntry>> events{};
+	std::vector<DocumentDiagnostic> diagnostics{};
+
+	if(!lines.empty()) {
+		// the changed lines directly behind the Format line, so that they are parsed with the
+		// same script info, styles and format
+		const size_t first_line = layout->format_line + 1;
+
+		std::string text = join_lines(all_lines.subspan(0, first_line));
+		text.push_back('\n');
+		text.append(join_lines(lines));
+
+		// the styles were already validated, when the whole document was parsed
+		std::shared_ptr<AssParseResultCpp> result = parse_ass_cpp(
+		    StringSourceCpp{ .str = std::move(text) }, part_parse_settings(m_settings), nullptr);
+
+		auto parse_result = result->result();
+
+		if(std::holds_alternative<AssParseResultErrorCpp>(parse_result)) {
+			return std::nullopt;
+		}
+
+		const AssEvents& parsed_events = std::get<AssParseResultOkCpp>(parse_result).result.events;
+
+		// a line was not parsed the way is_event_line expects
+		if(ZVEC_LENGTH(parsed_events.entries) != inserted_events) {
+			return std::nullopt;
+		}
+
+		for(size_t i = 0; i < inserted_events; ++i) {
+			events.push_back({ result, parsed_events.entries[i] });
+		}
+
+		// only the diagnostics of the changed lines, the ones of the other lines are still known
+		Diagnostics parsed_diagnostics = result->diagnostics();
+
+		for(size_t i = 0; i < ZVEC_LENGTH(parsed_diagnostics.entries); ++i) {
+			const DiagnosticEntry& entry = parsed_diagnostics.entries[i];
+
+			if(is_empty_pos(entry.position) || entry.position.line < first_line ||
+			   entry.position.line >= first_line + lines.size()) {
+				continue;
+			}
+
+			DocumentDiagnostic diagnostic = copy_diagnostic(entry);
+			diagnostic.position.line = diagnostic.position.line - first_line + start;
+
+			diagnostics.push_back(std::move(diagnostic));
+		}
+	}
+
+	// the new diagnostics replace the ones of the removed lines, at the same place in the list
+	std::vector<DocumentDiagnostic> merged{};
+	merged.reserve(m_diagnostics.size() + diagnostics.size());
+
+	bool inserted_diagnostics = false;
+
+	for(DocumentDiagnostic& diagnostic : m_diagnostics) {
+		const bool positioned = diagnostic.has_position;
+
+		if(positioned && diagnostic.position.line >= start && diagnostic.position.line < end) {
+			continue;
+		}
+
+		if(positioned && diagnostic.position.line >= end) {
+			if(!inserted_diagnostics) {
+				std::ranges::move(diagnostics, std::back_inserter(merged));
+				inserted_diagnostics = true;
+			}
+
+			diagnostic.position.line = diagnostic.position.line - end + start + lines.size();
+		}
+
+		merged.push_back(std::move(diagnostic));
+	}
+
+	if(!inserted_diagnostics) {
+		std::ranges::move(diagnostics, std::back_inserter(merged));
+	}
+
+	m_diagnostics = std::move(merged);
+
+	auto events_start = m_events.begin() + static_cast<std::ptrdiff_t>(first_event);
+
+	m_events.erase(events_start, events_start + static_cast<std::ptrdiff_t>(removed_events));
+	m_events.insert(m_events.begin() + static_cast<std::ptrdiff_t>(first_event),
+	                std::make_move_iterator(events.begin()), std::make_move_iterator(events.end()));
+
+	auto lines_start = m_lines.begin() + static_cast<std::ptrdiff_t>(start);
+
+	m_lines.erase(lines_start, m_lines.begin() + static_cast<std::ptrdiff_t>(end));
+	m_lines.insert(m_lines.begin() + static_cast<std::ptrdiff_t>(start),
+	               std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+
+	return DocumentEdit{
+		.full_reparse = false,
+		.events = { .start = first_event, .removed = removed_events, .inserted = inserted_events },
+		.styles = { .start = 0, .removed = 0, .inserted = 0 },
+	};
+}
+
+[[nodiscard]] std::unique_ptr<DocumentState> DocumentState::from_text(std::string_view text,
+                                                                      ParseSettings settings) {
+
+	std::unique_ptr<DocumentState> state{ new DocumentState{ settings, split_lines(text) } };
+
+	state->parse_all();
+
+	return state;
+}
+
+[[nodiscard]] DocumentEdit DocumentState::edit(size_t start, size_t end,
+                                               std::vector<std::string> lines) {
+
+	assert(start <= end && end <= m_lines.size() && "the edit has to be inside of the document");
+
+	if(auto edit = reparse_event_lines(start, end, lines); edit.has_value()) {
+		return edit.value();
+	}
+
+	const size_t old_events = m_events.size();
+	const size_t old_styles = m_styles.size();
+
+	auto lines_start = m_lines.begin() + static_cast<std::ptrdiff_t>(start);
+
+	m_lines.erase(lines_start, m_lines.begin() + static_cast<std::ptrdiff_t>(end));
+	m_lines.insert(m_lines.begin() + static_cast<std::ptrdiff_t>(start),
+	               std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+
+	parse_all();
+
+	return DocumentEdit{
+		.full_reparse = true,
+		.events = { .start = 0, .removed = old_events, .inserted = m_events.size() },
+		.styles = { .start = 0, .removed = old_styles, .inserted = m_styles.size() },
+	};
+}
+
+[[nodiscard]] std::string DocumentState::text() const {
+	return join_lines(m_lines);
+}
+
+[[nodiscard]] size_t DocumentState::line_count() const {
+	return m_lines.size();
+}
+
+[[nodiscard]] bool DocumentState::error() const {
+	return m_error;
+}
+
+[[nodiscard]] FileType DocumentState::file_type() const {
+	return m_file_type;
+}
+
+[[nodiscard]] const std::vector<DocumentDiagnostic>& DocumentState::diagnostics() const {
+	return m_diagnostics;
+}
+
+[[nodiscard]] const std::vector<DocumentEntry<AssEventEntry>>& DocumentState::events() const {
+	return m_events;
+}
+
+[[nodiscard]] const std::vector<DocumentEntry<AssStyleEntry>>& DocumentState::styles() const {
+	return m_styles;
+}
+
+// js
+
+AssDocument::AssDocument()
+    : m_state{ nullptr },
+      m_event_fields{},
+      m_style_fields{},
+      m_formats{ .time = TimeFormat::Object, .color = ColorFormat::Object } {}
+
+NAN_MODULE_INIT(AssDocument::Init) {
+
+	UNUSED(target);
+
+	v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+	tpl->SetClassName(Nan::New("AssDocument").ToLocalChecked());
+	tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+	Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("line_count").ToLocalChecked(),
+	                 LineCount);
+	Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("error").ToLocalChecked(), IsError);
+
+	Nan::SetPrototypeMethod(tpl, "diagnostics", GetDiagnostics);
+	Nan::SetPrototypeMethod(tpl, "events", GetEvents);
+	Nan::SetPrototypeMethod(tpl, "styles", GetStyles);
+	Nan::SetPrototypeMethod(tpl, "text", GetText);
+	Nan::SetPrototypeMethod(tpl, "edit", Edit);
+
+	// every isolate (e.g. of a worker thread) has its own constructor
+	auto* isolate = v8::Isolate::GetCurrent();
+
+	IsolateData::get(isolate).set_document_constructor(isolate,
+	                                                  Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+[[nodiscard]] v8::Local<v8::Object>
+AssDocument::NewInstance(v8::Isolate* isolate, std::unique_ptr<DocumentState> state,
+                         const ConvertSettings& convert_settings) {
+
+	v8::Local<v8::Function> cons = IsolateData::get(isolate).document_constructor(isolate);
+
+	v8::Local<v8::Object> instance = Nan::NewInstance(cons, 0, nullptr).ToLocalChecked();
+
+	auto* document = Nan::ObjectWrap::Unwrap<AssDocument>(instance);
+
+	document->m_state = std::move(state);
+	document->m_event_fields = convert_settings.projection.event_fields;
+	document->m_style_fields = convert_settings.projection.style_fields;
+	document->m_formats = convert_settings.formats;
+
+	return instance;
+}
+
+NAN_METHOD(AssDocument::New) {
+
+	if(!info.IsConstructCall()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("AssDocument can only be created by the ass_parser"));
+		return;
+	}
+
+	auto* document = new AssDocument();
+	document->Wrap(info.This());
+
+	info.GetReturnValue().Set(info.This());
+}
+
+NAN_GETTER(AssDocument::LineCount) {
+
+	UNUSED(property);
+
+	auto* document = Nan::ObjectWrap::Unwrap<AssDocument>(info.Holder());
+
+	info.GetReturnValue().Set(static_cast<double>(document->m_state->line_count()));
+}
+
+NAN_GETTER(AssDocument::IsError) {
+
+	UNUSED(property);
+
+	auto* document = Nan::ObjectWrap::Unwrap<AssDocument>(info.Holder());
+
+	info.GetReturnValue().Set(document->m_state->error());
+}
+
+NAN_METHOD(AssDocument::GetDiagnostics) {
+
+	auto* document = Nan::ObjectWrap::Unwrap<AssDocument>(info.Holder());
+
+	info.GetReturnValue().Set(document_diagnostics_to_js(info.GetIsolate(), *document->m_state));
+}
+
+NAN_METHOD(AssDocument::GetEvents) {
+
+	auto* document = Nan::ObjectWrap::Unwrap<AssDocument>(info.Holder());
+
+	const auto& events = document->m_state->events();
+
+	size_t start = resolve_slice_index(info[0], events.size(), 0);
+
+	size_t end = resolve_slice_index(info[1], events.size(), events.size());
+
+	StringConverter strings{ document->m_state->file_type(), nullptr };
+
+	std::vector<v8::Local<v8::Value>> values{};
+
+	for(size_t i = start; i < end; ++i) {
+		values.push_back(event_to_js(info.GetIsolate(), events[i].entry, document->m_event_fields,
+		                             document->m_formats, strings));
+	}
+
+	info.GetReturnValue().Set(v8::Array::New(info.GetIsolate(), values.data(), values.size()));
+}
+
+NAN_METHOD(AssDocument::GetStyles) {
+
+	auto* document = Nan::ObjectWrap::Unwrap<AssDocument>(info.Holder());
+
+	const auto& styles = document->m_state->styles();
+
+	size_t start = resolve_slice_index(info[0], styles.size(), 0);
+
+	size_t end = resolve_slice_index(info[1], styles.size(), styles.size());
+
+	StringConverter strings{ document->m_state->file_type(), nullptr };
+
+	std::vector<v8::Local<v8::Value>> values{};
+
+	for(size_t i = start; i < end; ++i) {
+		values.push_back(style_to_js(info.GetIsolate(), styles[i].entry, document->m_style_fields,
+		                             document->m_formats, strings));
+	}
+
+	info.GetReturnValue().Set(v8::Array::New(info.GetIsolate(), values.data(), values.size()));
+}
+
+NAN_METHOD(AssDocument::GetText) {
+
+	auto* document = Nan::ObjectWrap::Unwrap<AssDocument>(info.Holder());
+
+	std::string text = document->m_state->text();
+
+	info.GetReturnValue().Set(
+	    Nan::New<v8::String>(text.data(), static_cast<int>(text.size())).ToLocalChecked());
+}
+
+NAN_METHOD(AssDocument::Edit) {
+
+	auto* document = Nan::ObjectWrap::Unwrap<AssDocument>(info.Holder());
+
+	if(info.Length() != 3) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	const size_t line_count = document->m_state->line_count();
+
+	if(!info[0]->IsUint32() || !info[1]->IsUint32() ||
+	   Nan::To<uint32_t>(info[0]).FromJust() > Nan::To<uint32_t>(info[1]).FromJust() ||
+	   Nan::To<uint32_t>(info[1]).FromJust() > line_count) {
+		info.GetIsolate()->ThrowException(Nan::TypeError(
+		    "the 'start' and 'end' arguments need to be line indices with start <= end <= "
+		    "line_count"));
+		return;
+	}
+
+	if(!info[2]->IsArray()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'lines' argument needs to be an array of strings"));
+		return;
+	}
+
+	auto lines_array = info[2].As<v8::Array>();
+
+	std::vector<std::string> lines{};
+	lines.reserve(lines_array->Length());
+
+	for(uint32_t i = 0; i < lines_array->Length(); ++i) {
+		auto line = Nan::Get(lines_array, i).ToLocalChecked();
+
+		if(!line->IsString()) {
+			info.GetIsolate()->ThrowException(
+			    Nan::TypeError("the 'lines' argument needs to be an array of strings"));
+			return;
+		}
+
+		std::string value{ *Nan::Utf8String(line) };
+
+		if(value.find_first_of("\r\n") != std::string::npos) {
+			info.GetIsolate()->ThrowException(
+			    Nan::TypeError("the 'lines' argument must not contain line breaks"));
+			return;
+		}
+
+		lines.push_back(std::move(value));
+	}
+
+	auto edit = document->m_state->edit(Nan::To<uint32_t>(info[0]).FromJust(),
+	                                    Nan::To<uint32_t>(info[1]).FromJust(), std::move(lines));
+
+	info.GetReturnValue().Set(document_edit_to_js(info.GetIsolate(), *document->m_state, edit));
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "./convert.hpp"
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// a diagnostic, that outlives its parse result, the line of the position is the index into the
+// lines of the document
+struct DocumentDiagnostic {
+	std::string message;
+	DiagnosticSeverity severity;
+	bool has_position;
+	FilePos position;
+};
+
+// an entry together with the parse result, that its strings point into
+template <typename T> struct DocumentEntry {
+	std::shared_ptr<AssParseResultCpp> owner;
+	T entry;
+};
+
+// the entries [start, start + removed) were replaced by [start, start + inserted)
+struct EntrySplice {
+	size_t start;
+	size_t removed;
+	size_t inserted;
+};
+
+struct DocumentEdit {
+	// the edit could not be applied to the event lines alone, so the whole document was parsed
+	bool full_reparse;
+	EntrySplice events;
+	EntrySplice styles;
+};
+
+// the lines of a script together with its parsed entries and diagnostics, edits of event lines
+// only parse the changed lines (behind the sections before [Events], so that they are parsed the
+// same way), every other edit parses the whole document again
+struct DocumentState {
+  private:
+	ParseSettings m_settings;
+	// without line breaks
+	std::vector<std::string> m_lines;
+	bool m_error;
+	FileType m_file_type;
+	std::vector<DocumentDiagnostic> m_diagnostics;
+	std::vector<DocumentEntry<AssEventEntry>> m_events;
+	std::vector<DocumentEntry<AssStyleEntry>> m_styles;
+
+	DocumentState(ParseSettings settings, std::vector<std::string> lines);
+
+	void parse_all();
+
+	// nullopt, if the edit has to parse the whole document
+	[[nodiscard]] std::optional<DocumentEdit> reparse_event_lines(size_t start, size_t end,
+	                                                              std::vector<std::string>& lines);
+
+  public:
+	[[nodiscard]] static std::unique_ptr<DocumentState> from_text(std::string_view text,
+	                                                              ParseSettings settings);
+
+	// replaces the lines [start, end) with lines, start <= end <= line_count() is checked by the
+	// caller, lines must not contain line breaks
+	[[nodiscard]] DocumentEdit edit(size_t start, size_t end, std::vector<std::string> lines);
+
+	[[nodiscard]] std::string text() const;
+
+	[[nodiscard]] size_t line_count() const;
+
+	[[nodiscard]] bool error() const;
+
+	[[nodiscard]] FileType file_type() const;
+
+	[[nodiscard]] const std::vector<DocumentDiagnostic>& diagnostics() const;
+
+	[[nodiscard]] const std::vector<DocumentEntry<AssEventEntry>>& events() const;
+
+	[[nodiscard]] const std::vector<DocumentEntry<AssStyleEntry>>& styles() const;
+};
+
+// the js side of DocumentState
+class AssDocument : public Nan::ObjectWrap {
+  private:
+	std::unique_ptr<DocumentState> m_state;
+	JsKeySet m_event_fields;
+	JsKeySet m_style_fields;
+	ValueFormats m_formats;
+
+	AssDocument();
+
+	static NAN_METHOD(New);
+
+	static NAN_GETTER(LineCount);
+
+	static NAN_GETTER(IsError);
+
+	static NAN_METHOD(GetDiagnostics);
+
+	// events(start?, end?) and styles(start?, end?), the range is resolved like Array.slice
+	static NAN_METHOD(GetEvents);
+
+	static NAN_METHOD(GetStyles);
+
+	static NAN_METHOD(GetText);
+
+	static NAN_METHOD(Edit);
+
+  public:
+	static NAN_MODULE_INIT(Init);
+
+	[[nodiscard]] static v8::Local<v8::Object> NewInstance(v8::Isolate* isolate,
+	                                                       std::unique_ptr<DocumentState> state,
+	                                                       const ConvertSettings& convert_settings);
+};
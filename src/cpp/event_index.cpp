@@ -0,0 +1,299 @@
+#include "./event_index.hpp"
+#include "./isolate_data.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+EventIntervalIndex::EventIntervalIndex(std::vector<int32_t> starts, std::vector<int32_t> ends)
+    : m_starts{ std::move(starts) },
+      m_ends{ std::move(ends) },
+      m_nodes{},
+      m_root{ no_node },
+      m_by_start{},
+      m_by_end{},
+      m_sorted{},
+      m_sorted_starts{} {
+
+	for(size_t i = 0; i < m_starts.size(); ++i) {
+		if(m_starts[i] < m_ends[i]) {
+			m_sorted.push_back(static_cast<uint32_t>(i));
+		}
+	}
+
+	std::ranges::stable_sort(m_sorted, {}, [this](uint32_t index) { return m_starts[index]; });
+
+	m_sorted_starts.reserve(m_sorted.size());
+
+	for(uint32_t index : m_sorted) {
+		m_sorted_starts.push_back(m_starts[index]);
+	}
+
+	m_by_start.reserve(m_sorted.size());
+	m_by_end.reserve(m_sorted.size());
+
+	m_root = build_node(m_sorted);
+}
+
+// the center is the start of the median interval, so that interval is always in the node and
+// each subtree gets at most half of the intervals
+[[nodiscard]] uint32_t EventIntervalIndex::build_node(std::span<const uint32_t> items) {
+
+	if(items.empty()) {
+		return no_node;
+	}
+
+	const int32_t center = m_starts[items[items.size() / 2]];
+
+	std::vector<uint32_t> left{};
+	std::vector<uint32_t> middle{};
+	std::vector<uint32_t> right{};
+
+	for(uint32_t index : items) {
+		if(m_ends[index] <= center) {
+			left.push_back(index);
+		} else if(m_starts[index] > center) {
+			right.push_back(index);
+		} else {
+			middle.push_back(index);
+		}
+	}
+
+	const auto node_index = static_cast<uint32_t>(m_nodes.size());
+
+	m_nodes.push_back(Node{ .center = center,
+	                        .first = static_cast<uint32_t>(m_by_start.size()),
+	                        .count = static_cast<uint32_t>(middle.size()),
+	                        .left = no_node,
+	                        .right = no_node });
+
+	m_by_start.insert(m_by_start.end(), middle.begin(), middle.end());
+
+	std::ranges::stable_sort(middle, std::ranges::greater{},
+	                         [this](uint32_t index) { return m_ends[index]; });
+
+	m_by_end.insert(m_by_end.end(), middle.begin(), middle.end());
+
+	// building the children can reallocate m_nodes
+	const uint32_t left_node = build_node(left);
+	const uint32_t right_node = build_node(right);
+
+	m_nodes[node_index].left = left_node;
+	m_nodes[node_index].right = right_node;
+
+	return node_index;
+}
+
+void EventIntervalIndex::collect_active(double time, std::vector<uint32_t>& indices) const {
+
+	uint32_t node_index = m_root;
+
+	while(node_index != no_node) {
+		const Node& node = m_nodes[node_index];
+
+		if(time < static_cast<double>(node.center)) {
+			// every interval of the node ends after the time, so only the start matters
+			for(uint32_t i = node.first; i < node.first + node.count; ++i) {
+				if(static_cast<double>(m_starts[m_by_start[i]]) > time) {
+					break;
+				}
+
+				indices.push_back(m_by_start[i]);
+			}
+
+			node_index = node.left;
+		} else {
+			// every interval of the node starts at or before the time, so only the end matters
+			for(uint32_t i = node.first; i < node.first + node.count; ++i) {
+				if(static_cast<double>(m_ends[m_by_end[i]]) <= time) {
+					break;
+				}
+
+				indices.push_back(m_by_end[i]);
+			}
+
+			node_index = node.right;
+		}
+	}
+}
+
+[[nodiscard]] std::shared_ptr<const EventIntervalIndex>
+EventIntervalIndex::from_times(std::vector<int32_t> starts, std::vector<int32_t> ends) {
+
+	assert(starts.size() == ends.size() && "every event needs a start and an end");
+
+	return std::shared_ptr<const EventIntervalIndex>{ new EventIntervalIndex{ std::move(starts),
+		                                                                       std::move(ends) } };
+}
+
+[[nodiscard]] std::shared_ptr<const EventIntervalIndex>
+EventIntervalIndex::from_events(std::span<const AssEventEntry> events) {
+
+	std::vector<int32_t> starts{};
+	std::vector<int32_t> ends{};
+
+	starts.reserve(events.size());
+	ends.reserve(events.size());
+
+	for(const AssEventEntry& event : events) {
+		starts.push_back(ass_time_to_ms(event.start));
+		ends.push_back(ass_time_to_ms(event.end));
+	}
+
+	return from_times(std::move(starts), std::move(ends));
+}
+
+[[nodiscard]] size_t EventIntervalIndex::size() const {
+	return m_starts.size();
+}
+
+[[nodiscard]] std::vector<uint32_t> EventIntervalIndex::active_at(double time) const {
+
+	std::vector<uint32_t> indices{};
+
+	if(std::isnan(time)) {
+		return indices;
+	}
+
+	collect_active(time, indices);
+
+	std::ranges::sort(indices);
+
+	return indices;
+}
+
+[[nodiscard]] std::vector<uint32_t> EventIntervalIndex::range(double start, double end) const {
+
+	std::vector<uint32_t> indices{};
+
+	// also false for NaN
+	if(!(start < end)) {
+		return indices;
+	}
+
+	// the events, that are already shown at the start of the range
+	collect_active(start, indices);
+
+	// and the ones, that start inside of it
+	auto first = std::ranges::upper_bound(m_sorted_starts, start, std::ranges::less{},
+	                                      [](int32_t value) { return static_cast<double>(value); });
+
+	auto last = std::ranges::lower_bound(m_sorted_starts, end, std::ranges::less{},
+	                                     [](int32_t value) { return static_cast<double>(value); });
+
+	for(auto iter = first; iter < last; ++iter) {
+		indices.push_back(m_sorted[static_cast<size_t>(iter - m_sorted_starts.begin())]);
+	}
+
+	std::ranges::sort(indices);
+
+	return indices;
+}
+
+// js
+
+[[nodiscard]] static v8::Local<v8::Uint32Array>
+indices_to_js(v8::Isolate* isolate, const std::vector<uint32_t>& indices) {
+
+	auto buffer = v8::ArrayBuffer::New(isolate, indices.size() * sizeof(uint32_t));
+
+	if(!indices.empty()) {
+		std::memcpy(buffer->GetBackingStore()->Data(), indices.data(),
+		            indices.size() * sizeof(uint32_t));
+	}
+
+	return v8::Uint32Array::New(buffer, 0, indices.size());
+}
+
+EventIndex::EventIndex() : m_index{ nullptr } {}
+
+NAN_MODULE_INIT(EventIndex::Init) {
+
+	UNUSED(target);
+
+	v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+	tpl->SetClassName(Nan::New("EventIndex").ToLocalChecked());
+	tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+	Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("length").ToLocalChecked(), Length);
+
+	Nan::SetPrototypeMethod(tpl, "active_at", ActiveAt);
+	Nan::SetPrototypeMethod(tpl, "range", Range);
+
+	// every isolate (e.g. of a worker thread) has its own constructor
+	auto* isolate = v8::Isolate::GetCurrent();
+
+	IsolateData::get(isolate).set_event_index_constructor(isolate,
+	                                                     Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+[[nodiscard]] v8::Local<v8::Object>
+EventIndex::NewInstance(v8::Isolate* isolate, std::shared_ptr<const EventIntervalIndex> index) {
+
+	v8::Local<v8::Function> cons = IsolateData::get(isolate).event_index_constructor(isolate);
+
+	v8::Local<v8::Object> instance = Nan::NewInstance(cons, 0, nullptr).ToLocalChecked();
+
+	auto* event_index = Nan::ObjectWrap::Unwrap<EventIndex>(instance);
+
+	event_index->m_index = std::move(index);
+
+	return instance;
+}
+
+NAN_METHOD(EventIndex::New) {
+
+	if(!info.IsConstructCall()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("EventIndex can only be created by the ass_parser"));
+		return;
+	}
+
+	auto* event_index = new EventIndex();
+	event_index->Wrap(info.This());
+
+	info.GetReturnValue().Set(info.This());
+}
+
+NAN_GETTER(EventIndex::Length) {
+
+	UNUSED(property);
+
+	auto* event_index = Nan::ObjectWrap::Unwrap<EventIndex>(info.Holder());
+
+	info.GetReturnValue().Set(static_cast<double>(event_index->m_index->size()));
+}
+
+NAN_METHOD(EventIndex::ActiveAt) {
+
+	auto* event_index = Nan::ObjectWrap::Unwrap<EventIndex>(info.Holder());
+
+	if(info.Length() != 1 || !info[0]->IsNumber()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'time' argument needs to be a number"));
+		return;
+	}
+
+	double time = Nan::To<double>(info[0]).FromJust();
+
+	info.GetReturnValue().Set(
+	    indices_to_js(info.GetIsolate(), event_index->m_index->active_at(time)));
+}
+
+NAN_METHOD(EventIndex::Range) {
+
+	auto* event_index = Nan::ObjectWrap::Unwrap<EventIndex>(info.Holder());
+
+	if(info.Length() != 2 || !info[0]->IsNumber() || !info[1]->IsNumber()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'start' and 'end' arguments need to be numbers"));
+		return;
+	}
+
+	double start = Nan::To<double>(info[0]).FromJust();
+
+	double end = Nan::To<double>(info[1]).FromJust();
+
+	info.GetReturnValue().Set(
+	    indices_to_js(info.GetIsolate(), event_index->m_index->range(start, end)));
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "./convert.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// a static centered interval tree over the [start, end) times of events in milliseconds, answers
+// which events are shown at a time or during a time range in O(log n + k), events, that end
+// before or when they start, are never shown and so never returned
+struct EventIntervalIndex {
+  private:
+	static constexpr uint32_t no_node = UINT32_MAX;
+
+	// every interval of a node contains its center, the intervals of the left subtree end at or
+	// before it, the ones of the right subtree start after it
+	struct Node {
+		int32_t center;
+		// the slice of the node in m_by_start and m_by_end
+		uint32_t first;
+		uint32_t count;
+		uint32_t left;
+		uint32_t right;
+	};
+
+	std::vector<int32_t> m_starts;
+	std::vector<int32_t> m_ends;
+	std::vector<Node> m_nodes;
+	uint32_t m_root;
+	// event indices, per node by ascending start and by descending end
+	std::vector<uint32_t> m_by_start;
+	std::vector<uint32_t> m_by_end;
+	// every shown event by ascending start, for the events starting inside of a range
+	std::vector<uint32_t> m_sorted;
+	std::vector<int32_t> m_sorted_starts;
+
+	EventIntervalIndex(std::vector<int32_t> starts, std::vector<int32_t> ends);
+
+	// items are sorted by start, returns the index of the node
+	[[nodiscard]] uint32_t build_node(std::span<const uint32_t> items);
+
+	// appends the events with start <= time < end
+	void collect_active(double time, std::vector<uint32_t>& indices) const;
+
+  public:
+	// the times are in milliseconds, both have one entry per event
+	[[nodiscard]] static std::shared_ptr<const EventIntervalIndex>
+	from_times(std::vector<int32_t> starts, std::vector<int32_t> ends);
+
+	[[nodiscard]] static std::shared_ptr<const EventIntervalIndex>
+	from_events(std::span<const AssEventEntry> events);
+
+	// the number of events, including the ones, that are never shown
+	[[nodiscard]] size_t size() const;
+
+	// the indices of the events with start <= time < end, ascending
+	[[nodiscard]] std::vector<uint32_t> active_at(double time) const;
+
+	// the indices of the events, that are shown at some point in [start, end), ascending
+	[[nodiscard]] std::vector<uint32_t> range(double start, double end) const;
+};
+
+// the js side of EventIntervalIndex, the index is shared with the worker, that built it
+class EventIndex : public Nan::ObjectWrap {
+  private:
+	std::shared_ptr<const EventIntervalIndex> m_index;
+
+	EventIndex();
+
+	static NAN_METHOD(New);
+
+	static NAN_GETTER(Length);
+
+	static NAN_METHOD(ActiveAt);
+
+	static NAN_METHOD(Range);
+
+  public:
+	static NAN_MODULE_INIT(Init);
+
+	[[nodiscard]] static v8::Local<v8::Object>
+	NewInstance(v8::Isolate* isolate, std::shared_ptr<const EventIntervalIndex> index);
+};
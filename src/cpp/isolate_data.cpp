@@ -0,0 +1,288 @@
+#include "./isolate_data.hpp"
+
+#include <cassert>
+#include <memory>
+#include <mutex>
+
+static constexpr std::array<const char*, static_cast<size_t>(JsKey::Count)> key_names = {
+#define ASS_PARSER_JS_KEY_NAME(name) #name,
+	ASS_PARSER_JS_KEYS(ASS_PARSER_JS_KEY_NAME)
+#undef ASS_PARSER_JS_KEY_NAME
+};
+
+[[nodiscard]] const char* js_key_name(JsKey key) {
+	return key_names[static_cast<size_t>(key)];
+}
+
+static constexpr std::array file_pos_shape = { JsKey::line, JsKey::column };
+
+static constexpr std::array diagnostic_shape = { JsKey::message, JsKey::severity };
+
+static constexpr std::array file_props_shape = { JsKey::line_type, JsKey::file_type };
+
+static constexpr std::array time_shape = { JsKey::hour, JsKey::min, JsKey::sec, JsKey::hundred };
+
+static constexpr std::array event_shape = {
+	JsKey::type,
+	JsKey::layer,
+	JsKey::start,
+	JsKey::end,
+	JsKey::style,
+	JsKey::name,
+	JsKey::margin_l,
+	JsKey::margin_r,
+	JsKey::margin_v,
+	JsKey::effect,
+	JsKey::text,
+};
+
+static constexpr std::array color_shape = { JsKey::r, JsKey::g, JsKey::b, JsKey::a };
+
+static constexpr std::array style_shape = {
+	JsKey::name,
+	JsKey::fontname,
+	JsKey::fontsize,
+	JsKey::primary_colour,
+	JsKey::secondary_colour,
+	JsKey::outline_colour,
+	JsKey::back_colour,
+	JsKey::bold,
+	JsKey::italic,
+	JsKey::underline,
+	JsKey::strike_out,
+	JsKey::scale_x,
+	JsKey::scale_y,
+	JsKey::spacing,
+	JsKey::angle,
+	JsKey::border_style,
+	JsKey::outline,
+	JsKey::shadow,
+	JsKey::alignment,
+	JsKey::margin_l,
+	JsKey::margin_r,
+	JsKey::margin_v,
+	JsKey::encoding,
+};
+
+static constexpr std::array script_info_shape = {
+	JsKey::title,
+	JsKey::original_script,
+	JsKey::original_translation,
+	JsKey::original_editing,
+	JsKey::original_timing,
+	JsKey::synch_point,
+	JsKey::script_updated_by,
+	JsKey::update_details,
+	JsKey::script_type,
+	JsKey::collisions,
+	JsKey::play_res_y,
+	JsKey::play_res_x,
+	JsKey::play_depth,
+	JsKey::timer,
+	JsKey::wrap_style,
+	JsKey::scaled_border_and_shadow,
+	JsKey::video_aspect_ratio,
+	JsKey::video_zoom,
+	JsKey::ycbcr_matrix,
+};
+
+static constexpr std::array result_shape = { JsKey::script_info, JsKey::styles, JsKey::events,
+	                                         JsKey::extra_sections, JsKey::file_props };
+
+static constexpr std::array event_columns_shape = {
+	JsKey::length,
+	JsKey::type,
+	JsKey::layer,
+	JsKey::start_ms,
+	JsKey::end_ms,
+	JsKey::margin_l,
+	JsKey::margin_r,
+	JsKey::margin_v,
+	JsKey::style,
+	JsKey::name,
+	JsKey::effect,
+	JsKey::text,
+	JsKey::strings,
+};
+
+[[nodiscard]] std::span<const JsKey> js_shape_keys(JsShape shape) {
+	switch(shape) {
+		case JsShape::FilePos: return file_pos_shape;
+		case JsShape::Diagnostic: return diagnostic_shape;
+		case JsShape::FileProps: return file_props_shape;
+		case JsShape::Time: return time_shape;
+		case JsShape::Event: return event_shape;
+		case JsShape::Color: return color_shape;
+		case JsShape::Style: return style_shape;
+		case JsShape::ScriptInfo: return script_info_shape;
+		case JsShape::Result: return result_shape;
+		case JsShape::EventColumns: return event_columns_shape;
+		default: {
+			assert(false && "UNREACHABLE");
+			return {};
+		}
+	}
+}
+
+[[nodiscard]] JsKeySet js_shape_key_set(JsShape shape) {
+
+	JsKeySet result{};
+
+	for(const auto& key : js_shape_keys(shape)) {
+		result.set(static_cast<size_t>(key));
+	}
+
+	return result;
+}
+
+[[nodiscard]] static v8::Local<v8::String> internalized_str_to_js(v8::Isolate* isolate,
+                                                                  const char* str) {
+
+	return v8::String::NewFromUtf8(isolate, str, v8::NewStringType::kInternalized)
+	    .ToLocalChecked();
+}
+
+IsolateData::IsolateData(v8::Isolate* isolate)
+    : m_keys{},
+      m_templates{},
+      m_constants{},
+      m_lazy_list_template{},
+      m_event_index_constructor{},
+      m_document_constructor{},
+      m_stream_parser_constructor{},
+      m_compiled_settings_template{} {
+
+	for(size_t i = 0; i < key_names.size(); ++i) {
+		m_keys[i].Set(isolate, internalized_str_to_js(isolate, key_names[i]));
+	}
+
+	for(size_t i = 0; i < m_templates.size(); ++i) {
+		v8::Local<v8::ObjectTemplate> object_template = v8::ObjectTemplate::New(isolate);
+
+		for(const auto& key : js_shape_keys(static_cast<JsShape>(i))) {
+			object_template->Set(this->key(isolate, key), v8::Undefined(isolate));
+		}
+
+		m_templates[i].Set(isolate, object_template);
+	}
+}
+
+// every worker thread adds and removes its isolate, so the map is guarded by the mutex
+static std::mutex isolate_data_mutex{};
+
+static std::unordered_map<v8::Isolate*, std::unique_ptr<IsolateData>> isolate_data_map{};
+
+// the lookup is done for every converted object, so cache the last one, an isolate is only used
+// by one thread at a time, so this doesn't need the mutex
+thread_local v8::Isolate* last_isolate = nullptr;
+thread_local IsolateData* last_isolate_data = nullptr;
+
+[[nodiscard]] IsolateData& IsolateData::get(v8::Isolate* isolate) {
+
+	if(last_isolate == isolate && last_isolate_data != nullptr) {
+		return *last_isolate_data;
+	}
+
+	std::lock_guard lock{ isolate_data_mutex };
+
+	auto iter = isolate_data_map.find(isolate);
+
+	if(iter == isolate_data_map.end()) {
+		iter = isolate_data_map.emplace(isolate, std::make_unique<IsolateData>(isolate)).first;
+
+		node::AddEnvironmentCleanupHook(isolate, IsolateData::cleanup, isolate);
+	}
+
+	last_isolate = isolate;
+	last_isolate_data = iter->second.get();
+
+	return *last_isolate_data;
+}
+
+// runs on the thread of the environment, when it is torn down, e.g. when a worker exits
+void IsolateData::cleanup(void* isolate) {
+
+	auto* isolate_ptr = static_cast<v8::Isolate*>(isolate);
+
+	// a new isolate could get the same address later
+	if(last_isolate == isolate_ptr) {
+		last_isolate = nullptr;
+		last_isolate_data = nullptr;
+	}
+
+	std::lock_guard lock{ isolate_data_mutex };
+
+	isolate_data_map.erase(isolate_ptr);
+}
+
+[[nodiscard]] v8::Local<v8::String> IsolateData::key(v8::Isolate* isolate, JsKey key) const {
+	return m_keys[static_cast<size_t>(key)].Get(isolate);
+}
+
+[[nodiscard]] v8::Local<v8::ObjectTemplate> IsolateData::object_template(v8::Isolate* isolate,
+                                                                         JsShape shape) const {
+	return m_templates[static_cast<size_t>(shape)].Get(isolate);
+}
+
+[[nodiscard]] v8::Local<v8::String> IsolateData::constant(v8::Isolate* isolate,
+                                                          const char* value) {
+
+	auto iter = m_constants.find(value);
+
+	if(iter == m_constants.end()) {
+		iter = m_constants.emplace(value, v8::Eternal<v8::String>{}).first;
+		iter->second.Set(isolate, internalized_str_to_js(isolate, value));
+	}
+
+	return iter->second.Get(isolate);
+}
+
+void IsolateData::set_lazy_list_template(v8::Isolate* isolate,
+                                         v8::Local<v8::FunctionTemplate> function_template) {
+	m_lazy_list_template.Reset(isolate, function_template);
+}
+
+[[nodiscard]] v8::Local<v8::FunctionTemplate>
+IsolateData::lazy_list_template(v8::Isolate* isolate) const {
+	return m_lazy_list_template.Get(isolate);
+}
+
+void IsolateData::set_event_index_constructor(v8::Isolate* isolate,
+                                              v8::Local<v8::Function> constructor) {
+	m_event_index_constructor.Reset(isolate, constructor);
+}
+
+[[nodiscard]] v8::Local<v8::Function>
+IsolateData::event_index_constructor(v8::Isolate* isolate) const {
+	return m_event_index_constructor.Get(isolate);
+}
+
+void IsolateData::set_document_constructor(v8::Isolate* isolate,
+                                           v8::Local<v8::Function> constructor) {
+	m_document_constructor.Reset(isolate, constructor);
+}
+
+[[nodiscard]] v8::Local<v8::Function>
+IsolateData::document_constructor(v8::Isolate* isolate) const {
+	return m_document_constructor.Get(isolate);
+}
+
+void IsolateData::set_stream_parser_constructor(v8::Isolate* isolate,
+                                                v8::Local<v8::Function> constructor) {
+	m_stream_parser_constructor.Reset(isolate, constructor);
+}
+
+[[nodiscard]] v8::Local<v8::Function>
+IsolateData::stream_parser_constructor(v8::Isolate* isolate) const {
+	return m_stream_parser_constructor.Get(isolate);
+}
+
+void IsolateData::set_compiled_settings_template(
+    v8::Isolate* isolate, v8::Local<v8::FunctionTemplate> function_template) {
+	m_compiled_settings_template.Reset(isolate, function_template);
+}
+
+[[nodiscard]] v8::Local<v8::FunctionTemplate>
+IsolateData::compiled_settings_template(v8::Isolate* isolate) const {
+	return m_compiled_settings_template.Get(isolate);
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wtemplate-id-cdtor"
+#endif
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <nan.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <array>
+#include <bitset>
+#include <span>
+#include <unordered_map>
+
+// every fixed property name, that is used, when converting results to js
+#define ASS_PARSER_JS_KEYS(V)                                                                   \
+	V(diagnostics)                                                                              \
+	V(error)                                                                                    \
+	V(result)                                                                                   \
+	V(message)                                                                                  \
+	V(severity)                                                                                 \
+	V(position)                                                                                 \
+	V(line)                                                                                     \
+	V(column)                                                                                   \
+	V(script_info)                                                                              \
+	V(styles)                                                                                   \
+	V(events)                                                                                   \
+	V(extra_sections)                                                                           \
+	V(file_props)                                                                               \
+	V(line_type)                                                                                \
+	V(file_type)                                                                                \
+	V(hour)                                                                                     \
+	V(min)                                                                                      \
+	V(sec)                                                                                      \
+	V(hundred)                                                                                  \
+	V(type)                                                                                     \
+	V(layer)                                                                                    \
+	V(start)                                                                                    \
+	V(end)                                                                                      \
+	V(style)                                                                                    \
+	V(name)                                                                                     \
+	V(margin_l)                                                                                 \
+	V(margin_r)                                                                                 \
+	V(margin_v)                                                                                 \
+	V(effect)                                                                                   \
+	V(text)                                                                                     \
+	V(r)                                                                                        \
+	V(g)                                                                                        \
+	V(b)                                                                                        \
+	V(a)                                                                                        \
+	V(fontname)                                                                                 \
+	V(fontsize)                                                                                 \
+	V(primary_colour)                                                                           \
+	V(secondary_colour)                                                                         \
+	V(outline_colour)                                                                           \
+	V(back_colour)                                                                              \
+	V(bold)                                                                                     \
+	V(italic)                                                                                   \
+	V(underline)                                                                                \
+	V(strike_out)                                                                               \
+	V(scale_x)                                                                                  \
+	V(scale_y)                                                                                  \
+	V(spacing)                                                                                  \
+	V(angle)                                                                                    \
+	V(border_style)                                                                             \
+	V(outline)                                                                                  \
+	V(shadow)                                                                                   \
+	V(alignment)                                                                                \
+	V(encoding)                                                                                 \
+	V(title)                                                                                    \
+	V(original_script)                                                                          \
+	V(original_translation)                                                                     \
+	V(original_editing)                                                                         \
+	V(original_timing)                                                                          \
+	V(synch_point)                                                                              \
+	V(script_updated_by)                                                                        \
+	V(update_details)                                                                           \
+	V(script_type)                                                                              \
+	V(collisions)                                                                               \
+	V(play_res_y)                                                                               \
+	V(play_res_x)                                                                               \
+	V(play_depth)                                                                               \
+	V(timer)                                                                                    \
+	V(wrap_style)                                                                               \
+	V(scaled_border_and_shadow)                                                                 \
+	V(video_aspect_ratio)                                                                       \
+	V(video_zoom)                                                                               \
+	V(ycbcr_matrix)                                                                             \
+	V(length)                                                                                   \
+	V(start_ms)                                                                                 \
+	V(end_ms)                                                                                   \
+	V(strings)                                                                                  \
+	V(timings)                                                                                  \
+	V(counters)                                                                                 \
+	V(read_ns)                                                                                  \
+	V(parse_ns)                                                                                 \
+	V(convert_ns)                                                                               \
+	V(bytes_read)                                                                               \
+	V(strings_created)                                                                          \
+	V(cached)                                                                                   \
+	V(event_index)                                                                              \
+	V(full_reparse)                                                                             \
+	V(removed)                                                                                  \
+	V(inserted)                                                                                 \
+	V(kind)
+
+enum class JsKey : size_t {
+#define ASS_PARSER_JS_KEY_ENUM(name) name,
+	ASS_PARSER_JS_KEYS(ASS_PARSER_JS_KEY_ENUM)
+#undef ASS_PARSER_JS_KEY_ENUM
+	    Count
+};
+
+using JsKeySet = std::bitset<static_cast<size_t>(JsKey::Count)>;
+
+[[nodiscard]] const char* js_key_name(JsKey key);
+
+// records with a fixed set of keys, every object of one shape is created from the same
+// ObjectTemplate, so that they all share one hidden class
+enum class JsShape : size_t {
+	FilePos,
+	Diagnostic,
+	FileProps,
+	Time,
+	Event,
+	Color,
+	Style,
+	ScriptInfo,
+	Result,
+	EventColumns,
+	Count
+};
+
+[[nodiscard]] std::span<const JsKey> js_shape_keys(JsShape shape);
+
+[[nodiscard]] JsKeySet js_shape_key_set(JsShape shape);
+
+// js values, that are created once per isolate and then reused for every conversion, every
+// isolate (the main thread and every worker thread) has its own, which is deleted in the cleanup
+// hook of its environment
+struct IsolateData {
+  private:
+	std::array<v8::Eternal<v8::String>, static_cast<size_t>(JsKey::Count)> m_keys;
+	std::array<v8::Eternal<v8::ObjectTemplate>, static_cast<size_t>(JsShape::Count)> m_templates;
+	// keyed by the address of string literals, so only use this for constant strings
+	std::unordered_map<const char*, v8::Eternal<v8::String>> m_constants;
+	// a template and not only the constructor, as instances are checked with HasInstance
+	v8::Global<v8::FunctionTemplate> m_lazy_list_template;
+	v8::Global<v8::Function> m_event_index_constructor;
+	v8::Global<v8::Function> m_document_constructor;
+	v8::Global<v8::Function> m_stream_parser_constructor;
+	// a template and not only the constructor, as instances are checked with HasInstance
+	v8::Global<v8::FunctionTemplate> m_compiled_settings_template;
+
+	static void cleanup(void* isolate);
+
+  public:
+	explicit IsolateData(v8::Isolate* isolate);
+
+	IsolateData(const IsolateData& other) = delete;
+	IsolateData& operator=(const IsolateData& other) = delete;
+
+	[[nodiscard]] static IsolateData& get(v8::Isolate* isolate);
+
+	[[nodiscard]] v8::Local<v8::String> key(v8::Isolate* isolate, JsKey key) const;
+
+	[[nodiscard]] v8::Local<v8::ObjectTemplate> object_template(v8::Isolate* isolate,
+	                                                            JsShape shape) const;
+
+	[[nodiscard]] v8::Local<v8::String> constant(v8::Isolate* isolate, const char* value);
+
+	void set_lazy_list_template(v8::Isolate* isolate,
+	                            v8::Local<v8::FunctionTemplate> function_template);
+
+	[[nodiscard]] v8::Local<v8::FunctionTemplate> lazy_list_template(v8::Isolate* isolate) const;
+
+	void set_event_index_constructor(v8::Isolate* isolate, v8::Local<v8::Function> constructor);
+
+	[[nodiscard]] v8::Local<v8::Function> event_index_constructor(v8::Isolate* isolate) const;
+
+	void set_document_constructor(v8::Isolate* isolate, v8::Local<v8::Function> constructor);
+
+	[[nodiscard]] v8::Local<v8::Function> document_constructor(v8::Isolate* isolate) const;
+
+	void set_stream_parser_constructor(v8::Isolate* isolate, v8::Local<v8::Function> constructor);
+
+	[[nodiscard]] v8::Local<v8::Function> stream_parser_constructor(v8::Isolate* isolate) const;
+
+	void set_compiled_settings_template(v8::Isolate* isolate,
+	                                    v8::Local<v8::FunctionTemplate> function_template);
+
+	[[nodiscard]] v8::Local<v8::FunctionTemplate>
+	compiled_settings_template(v8::Isolate* isolate) const;
+};
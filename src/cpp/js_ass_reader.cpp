@@ -0,0 +1,828 @@
+#include "./js_ass_reader.hpp"
+#include "./isolate_data.hpp"
+#include "./lazy_list.hpp"
+#include "./string_converter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <span>
+#include <stb/ds.h>
+#include <string>
+
+// reads the values of an AssResult from js into the native entries, so that they are written with
+// the same AssWriter functions as native results, every error names the path of the value, e.g.
+// events[3].text, the strings of the entries are owned by the reader until clear_strings
+struct JsAssReader {
+  private:
+	v8::Isolate* m_isolate;
+	ValueFormats m_formats;
+	// a deque, so that the FinalStrs pointing into earlier strings stay valid
+	std::deque<std::string> m_strings;
+
+	[[nodiscard]] static v8::Local<v8::Value> type_error(const std::string& path,
+	                                                     const char* expected) {
+		std::string message = path + " needs to be " + expected;
+		return Nan::TypeError(message.c_str());
+	}
+
+	[[nodiscard]] static std::string field_path(const std::string& path, JsKey key) {
+		return path + "." + js_key_name(key);
+	}
+
+	// an integer between 0 and max, BigInts are accepted, as size_t_to_js returns them for large
+	// values
+	[[nodiscard]] static std::expected<uint64_t, v8::Local<v8::Value>>
+	integer(v8::Local<v8::Value> value, const std::string& path, uint64_t max) {
+
+		if(value->IsBigInt()) {
+			bool lossless = false;
+			uint64_t result = value.As<v8::BigInt>()->Uint64Value(&lossless);
+
+			if(!lossless || result > max) {
+				return std::unexpected{ type_error(path, "a non negative integer in range") };
+			}
+
+			return { result };
+		}
+
+		if(!value->IsNumber()) {
+			return std::unexpected{ type_error(path, "a number") };
+		}
+
+		double number = value.As<v8::Number>()->Value();
+
+		if(!(number >= 0) || std::trunc(number) != number ||
+		   number > static_cast<double>(std::min<uint64_t>(max, uint64_t{ 1 } << 53U))) {
+			return std::unexpected{ type_error(path, "a non negative integer in range") };
+		}
+
+		return { static_cast<uint64_t>(number) };
+	}
+
+	[[nodiscard]] static std::expected<double, v8::Local<v8::Value>>
+	number(v8::Local<v8::Value> value, const std::string& path) {
+
+		if(!value->IsNumber() || !std::isfinite(value.As<v8::Number>()->Value())) {
+			return std::unexpected{ type_error(path, "a finite number") };
+		}
+
+		return { value.As<v8::Number>()->Value() };
+	}
+
+	[[nodiscard]] static std::expected<bool, v8::Local<v8::Value>>
+	boolean(v8::Local<v8::Value> value, const std::string& path) {
+
+		if(!value->IsBoolean()) {
+			return std::unexpected{ type_error(path, "a boolean") };
+		}
+
+		return { value.As<v8::Boolean>()->Value() };
+	}
+
+	// the value of one of the *_to_string functions
+	template <typename T>
+	[[nodiscard]] static std::expected<T, v8::Local<v8::Value>>
+	enum_value(v8::Local<v8::Value> value, const std::string& path,
+	           std::initializer_list<T> values, const char* (*to_string)(T),
+	           const char* expected) {
+
+		if(value->IsString()) {
+			Nan::Utf8String str{ value };
+
+			for(T entry : values) {
+				if(std::strcmp(*str, to_string(entry)) == 0) {
+					return { entry };
+				}
+			}
+		}
+
+		return std::unexpected{ type_error(path, expected) };
+	}
+
+	[[nodiscard]] std::expected<AssTime, v8::Local<v8::Value>>
+	time(v8::Local<v8::Value> value, const std::string& path) const {
+
+		// the largest time, that fits into AssTime
+		constexpr uint64_t max_centiseconds = ((((255ULL * 60) + 59) * 60) + 59) * 100 + 99;
+
+		if(value->IsNumber() && m_formats.time != TimeFormat::Object) {
+			const bool is_ms = m_formats.time == TimeFormat::Milliseconds;
+
+			auto total = integer(value, path, is_ms ? max_centiseconds * 10 + 9 : max_centiseconds);
+
+			if(!total.has_value()) {
+				return std::unexpected{ total.error() };
+			}
+
+			// the ass format only has centiseconds
+			uint64_t centiseconds = is_ms ? total.value() / 10 : total.value();
+
+			return { AssTime{ .hour = static_cast<uint8_t>(centiseconds / 360000),
+				              .min = static_cast<uint8_t>((centiseconds / 6000) % 60),
+				              .sec = static_cast<uint8_t>((centiseconds / 100) % 60),
+				              .hundred = static_cast<uint8_t>(centiseconds % 100) } };
+		}
+
+		if(!value->IsObject()) {
+			return std::unexpected{ type_error(path, m_formats.time == TimeFormat::Object
+			                                             ? "a time object"
+			                                             : "a time object or a number") };
+		}
+
+		auto object = value.As<v8::Object>();
+
+		std::array<uint8_t, 4> parts{};
+		std::array<std::pair<JsKey, uint64_t>, 4> keys{ { { JsKey::hour, 255 },
+			                                              { JsKey::min, 59 },
+			                                              { JsKey::sec, 59 },
+			                                              { JsKey::hundred, 99 } } };
+
+		for(size_t i = 0; i < keys.size(); ++i) {
+			auto part = integer(get(object, keys[i].first), field_path(path, keys[i].first),
+			                    keys[i].second);
+
+			if(!part.has_value()) {
+				return std::unexpected{ part.error() };
+			}
+
+			parts[i] = static_cast<uint8_t>(part.value());
+		}
+
+		return { AssTime{
+			.hour = parts[0], .min = parts[1], .sec = parts[2], .hundred = parts[3] } };
+	}
+
+	// packed colors are accepted in both formats, as they can't be mistaken for anything else
+	[[nodiscard]] std::expected<AssColor, v8::Local<v8::Value>>
+	color(v8::Local<v8::Value> value, const std::string& path) const {
+
+		if(value->IsNumber()) {
+			auto packed = integer(value, path, std::numeric_limits<uint32_t>::max());
+
+			if(!packed.has_value()) {
+				return std::unexpected{ packed.error() };
+			}
+
+			// &HAABBGGRR
+			return { AssColor{ .r = static_cast<uint8_t>(packed.value()),
+				               .g = static_cast<uint8_t>(packed.value() >> 8U),
+				               .b = static_cast<uint8_t>(packed.value() >> 16U),
+				               .a = static_cast<uint8_t>(packed.value() >> 24U) } };
+		}
+
+		if(!value->IsObject()) {
+			return std::unexpected{ type_error(path, "a color object or a number") };
+		}
+
+		auto object = value.As<v8::Object>();
+
+		std::array<uint8_t, 4> parts{};
+		std::array<JsKey, 4> keys{ JsKey::r, JsKey::g, JsKey::b, JsKey::a };
+
+		for(size_t i = 0; i < keys.size(); ++i) {
+			auto part = integer(get(object, keys[i]), field_path(path, keys[i]), 255);
+
+			if(!part.has_value()) {
+				return std::unexpected{ part.error() };
+			}
+
+			parts[i] = static_cast<uint8_t>(part.value());
+		}
+
+		return { AssColor{ .r = parts[0], .g = parts[1], .b = parts[2], .a = parts[3] } };
+	}
+
+	[[nodiscard]] static std::expected<MarginValue, v8::Local<v8::Value>>
+	margin(v8::Local<v8::Value> value, const std::string& path) {
+
+		if(value->IsString() && std::string_view{ *Nan::Utf8String(value) } == "default") {
+			return { MarginValue{ .is_default = true, .data = { .value = 0 } } };
+		}
+
+		auto margin_value = integer(value, path, std::numeric_limits<size_t>::max());
+
+		if(!margin_value.has_value()) {
+			return std::unexpected{ type_error(path, "'default' or a non negative integer") };
+		}
+
+		return { MarginValue{ .is_default = false, .data = { .value = margin_value.value() } } };
+	}
+
+  public:
+	JsAssReader(v8::Isolate* isolate, const ValueFormats& formats)
+	    : m_isolate{ isolate }, m_formats{ formats }, m_strings{} {}
+
+	[[nodiscard]] v8::Local<v8::Value> get(v8::Local<v8::Object> object, JsKey key) const {
+		return Nan::Get(object, IsolateData::get(m_isolate).key(m_isolate, key)).ToLocalChecked();
+	}
+
+	// values can't contain line breaks, as every value has to stay on its line, and only the last
+	// field of a comma separated entry (the event text) or values of key value lines can contain
+	// commas, otherwise the line reparses into different fields
+	[[nodiscard]] std::expected<FinalStr, v8::Local<v8::Value>>
+	str(v8::Local<v8::Value> value, const std::string& path, bool allow_commas) {
+
+		if(!value->IsString()) {
+			return std::unexpected{ type_error(path, "a string") };
+		}
+
+		std::string& result = m_strings.emplace_back(*Nan::Utf8String(value));
+
+		if(result.find_first_of("\r\n") != std::string::npos) {
+			return std::unexpected{ type_error(path, "a string without line breaks") };
+		}
+
+		if(!allow_commas && result.find(',') != std::string::npos) {
+			return std::unexpected{ type_error(path, "a string without commas") };
+		}
+
+		return { FinalStr{ .start = result.data(), .length = result.size() } };
+	}
+
+	void clear_strings() {
+		m_strings.clear();
+	}
+
+	[[nodiscard]] std::expected<AssScriptInfo, v8::Local<v8::Value>>
+	script_info(v8::Local<v8::Value> value, const std::string& path) {
+
+		if(!value->IsObject()) {
+			return std::unexpected{ type_error(path, "an object") };
+		}
+
+		auto object = value.As<v8::Object>();
+
+		AssScriptInfo result{};
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, FinalStr*>>{
+		        { JsKey::title, &result.title },
+		        { JsKey::original_script, &result.original_script },
+		        { JsKey::original_translation, &result.original_translation },
+		        { JsKey::original_editing, &result.original_editing },
+		        { JsKey::original_timing, &result.original_timing },
+		        { JsKey::synch_point, &result.synch_point },
+		        { JsKey::script_updated_by, &result.script_updated_by },
+		        { JsKey::update_details, &result.update_details },
+		        { JsKey::collisions, &result.collisions },
+		        { JsKey::play_depth, &result.play_depth },
+		        { JsKey::timer, &result.timer },
+		        { JsKey::ycbcr_matrix, &result.ycbcr_matrix } }) {
+
+			auto field = str(get(object, key), field_path(path, key), true);
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, size_t*>>{
+		        { JsKey::play_res_y, &result.play_res_y },
+		        { JsKey::play_res_x, &result.play_res_x },
+		        { JsKey::video_aspect_ratio, &result.video_aspect_ratio },
+		        { JsKey::video_zoom, &result.video_zoom } }) {
+
+			auto field = integer(get(object, key), field_path(path, key),
+			                     std::numeric_limits<size_t>::max());
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		auto script_type =
+		    enum_value(get(object, JsKey::script_type), field_path(path, JsKey::script_type),
+		               { ScriptTypeUnknown, ScriptTypeV4, ScriptTypeV4Plus }, script_type_to_string,
+		               "either 'Unknown', 'V4' or 'V4Plus'");
+
+		if(!script_type.has_value()) {
+			return std::unexpected{ script_type.error() };
+		}
+
+		result.script_type = script_type.value();
+
+		auto wrap_style = integer(get(object, JsKey::wrap_style),
+		                          field_path(path, JsKey::wrap_style), WrapStyleSmartLow);
+
+		if(!wrap_style.has_value()) {
+			return std::unexpected{ wrap_style.error() };
+		}
+
+		result.wrap_style = static_cast<WrapStyle>(wrap_style.value());
+
+		auto scaled_border_and_shadow = boolean(get(object, JsKey::scaled_border_and_shadow),
+		                                        field_path(path, JsKey::scaled_border_and_shadow));
+
+		if(!scaled_border_and_shadow.has_value()) {
+			return std::unexpected{ scaled_border_and_shadow.error() };
+		}
+
+		result.scaled_border_and_shadow = scaled_border_and_shadow.value();
+
+		return { result };
+	}
+
+	[[nodiscard]] std::expected<AssStyleEntry, v8::Local<v8::Value>>
+	style(v8::Local<v8::Value> value, const std::string& path) {
+
+		if(!value->IsObject()) {
+			return std::unexpected{ type_error(path, "an object") };
+		}
+
+		auto object = value.As<v8::Object>();
+
+		AssStyleEntry result{};
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, FinalStr*>>{
+		        { JsKey::name, &result.name }, { JsKey::fontname, &result.fontname } }) {
+
+			auto field = str(get(object, key), field_path(path, key), false);
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, AssColor*>>{
+		        { JsKey::primary_colour, &result.primary_colour },
+		        { JsKey::secondary_colour, &result.secondary_colour },
+		        { JsKey::outline_colour, &result.outline_colour },
+		        { JsKey::back_colour, &result.back_colour } }) {
+
+			auto field = color(get(object, key), field_path(path, key));
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, bool*>>{
+		        { JsKey::bold, &result.bold },
+		        { JsKey::italic, &result.italic },
+		        { JsKey::underline, &result.underline },
+		        { JsKey::strike_out, &result.strike_out } }) {
+
+			auto field = boolean(get(object, key), field_path(path, key));
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, size_t*>>{
+		        { JsKey::fontsize, &result.fontsize },
+		        { JsKey::scale_x, &result.scale_x },
+		        { JsKey::scale_y, &result.scale_y },
+		        { JsKey::margin_l, &result.margin_l },
+		        { JsKey::margin_r, &result.margin_r },
+		        { JsKey::margin_v, &result.margin_v },
+		        { JsKey::encoding, &result.encoding } }) {
+
+			auto field = integer(get(object, key), field_path(path, key),
+			                     std::numeric_limits<size_t>::max());
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, double*>>{
+		        { JsKey::spacing, &result.spacing },
+		        { JsKey::angle, &result.angle },
+		        { JsKey::outline, &result.outline },
+		        { JsKey::shadow, &result.shadow } }) {
+
+			auto field = number(get(object, key), field_path(path, key));
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		auto border_style = integer(get(object, JsKey::border_style),
+		                            field_path(path, JsKey::border_style), BorderStyleOpaqueBox);
+
+		if(!border_style.has_value()) {
+			return std::unexpected{ border_style.error() };
+		}
+
+		result.border_style = static_cast<BorderStyle>(border_style.value());
+
+		auto alignment = integer(get(object, JsKey::alignment), field_path(path, JsKey::alignment),
+		                         AssAlignmentTR);
+
+		if(!alignment.has_value()) {
+			return std::unexpected{ alignment.error() };
+		}
+
+		result.alignment = static_cast<AssAlignment>(alignment.value());
+
+		return { result };
+	}
+
+	[[nodiscard]] std::expected<AssEventEntry, v8::Local<v8::Value>>
+	event(v8::Local<v8::Value> value, const std::string& path) {
+
+		if(!value->IsObject()) {
+			return std::unexpected{ type_error(path, "an object") };
+		}
+
+		auto object = value.As<v8::Object>();
+
+		AssEventEntry result{};
+
+		auto type = enum_value(get(object, JsKey::type), field_path(path, JsKey::type),
+		                       { EventTypeDialogue, EventTypeComment, EventTypePicture,
+		                         EventTypeSound, EventTypeMovie, EventTypeCommand },
+		                       event_type_to_string, "an event type like 'Dialogue'");
+
+		if(!type.has_value()) {
+			return std::unexpected{ type.error() };
+		}
+
+		result.type = type.value();
+
+		auto layer = integer(get(object, JsKey::layer), field_path(path, JsKey::layer),
+		                     std::numeric_limits<size_t>::max());
+
+		if(!layer.has_value()) {
+			return std::unexpected{ layer.error() };
+		}
+
+		result.layer = layer.value();
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, AssTime*>>{
+		        { JsKey::start, &result.start }, { JsKey::end, &result.end } }) {
+
+			auto field = time(get(object, key), field_path(path, key));
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, FinalStr*>>{
+		        { JsKey::style, &result.style },
+		        { JsKey::name, &result.name },
+		        { JsKey::effect, &result.effect },
+		        { JsKey::text, &result.text } }) {
+
+			// the text is the last field, so it is the only one, that can contain commas
+			auto field = str(get(object, key), field_path(path, key), key == JsKey::text);
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		for(auto [key, target] : std::initializer_list<std::pair<JsKey, MarginValue*>>{
+		        { JsKey::margin_l, &result.margin_l },
+		        { JsKey::margin_r, &result.margin_r },
+		        { JsKey::margin_v, &result.margin_v } }) {
+
+			auto field = margin(get(object, key), field_path(path, key));
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			*target = field.value();
+		}
+
+		return { result };
+	}
+
+	// the defaults of the parser for missing file_props
+	[[nodiscard]] std::expected<FileProps, v8::Local<v8::Value>>
+	file_props(v8::Local<v8::Value> value, const std::string& path) const {
+
+		if(value->IsUndefined()) {
+			return { FileProps{ .line_type = LineTypeLf, .file_type = FileTypeUnknown } };
+		}
+
+		if(!value->IsObject()) {
+			return std::unexpected{ type_error(path, "an object") };
+		}
+
+		auto object = value.As<v8::Object>();
+
+		auto line_type = enum_value(get(object, JsKey::line_type),
+		                            field_path(path, JsKey::line_type),
+		                            { LineTypeCrLf, LineTypeLf, LineTypeCr }, line_type_to_string,
+		                            "either 'CrLf', 'Lf' or 'Cr'");
+
+		if(!line_type.has_value()) {
+			return std::unexpected{ line_type.error() };
+		}
+
+		auto file_type = enum_value(get(object, JsKey::file_type),
+		                            field_path(path, JsKey::file_type),
+		                            { FileTypeUnknown, FileTypeUtf8, FileTypeUtf16BE,
+		                              FileTypeUtf16LE, FileTypeUtf32BE, FileTypeUtf32LE },
+		                            file_type_to_string, "a file type like 'UTF-8'");
+
+		if(!file_type.has_value()) {
+			return std::unexpected{ file_type.error() };
+		}
+
+		return { FileProps{ .line_type = line_type.value(), .file_type = file_type.value() } };
+	}
+};
+
+// an array of entries or a LazyList of the given kind
+struct JsEntryList {
+	const LazyList* lazy;
+	v8::Local<v8::Array> array;
+};
+
+[[nodiscard]] static std::expected<JsEntryList, v8::Local<v8::Value>>
+get_entry_list_from_js(v8::Isolate* isolate, v8::Local<v8::Value> value, LazyListKind kind,
+                       const char* path) {
+
+	if(value->IsArray()) {
+		return { JsEntryList{ .lazy = nullptr, .array = value.As<v8::Array>() } };
+	}
+
+	if(const auto* lazy = LazyList::FromValue(isolate, value);
+	   lazy != nullptr && lazy->kind() == kind) {
+		return { JsEntryList{ .lazy = lazy, .array = {} } };
+	}
+
+	std::string message =
+	    std::string{ path } + " needs to be an array or a lazy list (the columnar result mode is " +
+	    "not supported)";
+	return std::unexpected{ Nan::TypeError(message.c_str()) };
+}
+
+// section names end at ']' and field keys at ':', so these can't be written
+[[nodiscard]] static std::expected<std::string, v8::Local<v8::Value>>
+get_extra_section_key_from_js(v8::Local<v8::Value> value, const std::string& path,
+                              const char* forbidden) {
+
+	std::string key{ *Nan::Utf8String(value) };
+
+	if(key.empty() || key.find_first_of(forbidden) != std::string::npos) {
+		std::string message = path + " has an invalid key '" + key + "'";
+		return std::unexpected{ Nan::TypeError(message.c_str()) };
+	}
+
+	return { std::move(key) };
+}
+
+// without a writer, the sections are only validated
+[[nodiscard]] static std::expected<void, v8::Local<v8::Value>>
+write_extra_sections_from_js(JsAssReader& reader, AssWriter* writer, v8::Local<v8::Value> value) {
+
+	if(value->IsUndefined()) {
+		return {};
+	}
+
+	if(!value->IsObject()) {
+		return std::unexpected{ Nan::TypeError("result.extra_sections needs to be an object") };
+	}
+
+	auto context = Nan::GetCurrentContext();
+	auto strings = StringConverter::for_normalized_utf8();
+
+	auto sections = value.As<v8::Object>();
+	auto section_names = sections->GetOwnPropertyNames(context).ToLocalChecked();
+
+	for(uint32_t i = 0; i < section_names->Length(); ++i) {
+		auto js_name = Nan::Get(section_names, i).ToLocalChecked();
+
+		auto name = get_extra_section_key_from_js(js_name, "result.extra_sections", "]\r\n");
+
+		if(!name.has_value()) {
+			return std::unexpected{ name.error() };
+		}
+
+		std::string path = "result.extra_sections['" + name.value() + "']";
+
+		auto section = Nan::Get(sections, js_name).ToLocalChecked();
+
+		if(!section->IsObject()) {
+			return std::unexpected{ Nan::TypeError((path + " needs to be an object").c_str()) };
+		}
+
+		if(writer != nullptr) {
+			writer->begin_section(name.value());
+		}
+
+		auto fields = section.As<v8::Object>();
+		auto field_names = fields->GetOwnPropertyNames(context).ToLocalChecked();
+
+		for(uint32_t j = 0; j < field_names->Length(); ++j) {
+			auto js_key = Nan::Get(field_names, j).ToLocalChecked();
+
+			auto key = get_extra_section_key_from_js(js_key, path, ":\r\n");
+
+			if(!key.has_value()) {
+				return std::unexpected{ key.error() };
+			}
+
+			auto field = reader.str(Nan::Get(fields, js_key).ToLocalChecked(),
+			                        path + "['" + key.value() + "']", true);
+
+			if(!field.has_value()) {
+				return std::unexpected{ field.error() };
+			}
+
+			if(writer != nullptr) {
+				writer->write_field(key.value(), field.value(), strings);
+			}
+
+			reader.clear_strings();
+		}
+	}
+
+	return {};
+}
+
+// reads every plain js entry once without writing it, so that a file descriptor never gets a
+// truncated script, because a later entry was invalid after the first chunk was flushed
+[[nodiscard]] static std::expected<void, v8::Local<v8::Value>>
+validate_entries_from_js(JsAssReader& reader, const JsEntryList& styles, const JsEntryList& events,
+                         v8::Local<v8::Value> extra_sections) {
+
+	if(styles.lazy == nullptr) {
+		for(uint32_t i = 0; i < styles.array->Length(); ++i) {
+			auto style = reader.style(Nan::Get(styles.array, i).ToLocalChecked(),
+			                          "result.styles[" + std::to_string(i) + "]");
+
+			if(!style.has_value()) {
+				return std::unexpected{ style.error() };
+			}
+
+			reader.clear_strings();
+		}
+	}
+
+	if(events.lazy == nullptr) {
+		for(uint32_t i = 0; i < events.array->Length(); ++i) {
+			auto event = reader.event(Nan::Get(events.array, i).ToLocalChecked(),
+			                          "result.events[" + std::to_string(i) + "]");
+
+			if(!event.has_value()) {
+				return std::unexpected{ event.error() };
+			}
+
+			reader.clear_strings();
+		}
+	}
+
+	return write_extra_sections_from_js(reader, nullptr, extra_sections);
+}
+
+[[nodiscard]] std::expected<AssWriter, v8::Local<v8::Value>>
+write_ass_result_from_js(v8::Isolate* isolate, v8::Local<v8::Value> value,
+                         const ValueFormats& formats, int fd) {
+
+	if(!value->IsObject()) {
+		return std::unexpected{ Nan::TypeError("the 'result' argument needs to be an object") };
+	}
+
+	auto object = value.As<v8::Object>();
+
+	JsAssReader reader{ isolate, formats };
+
+	auto file_props =
+	    reader.file_props(reader.get(object, JsKey::file_props), "result.file_props");
+
+	if(!file_props.has_value()) {
+		return std::unexpected{ file_props.error() };
+	}
+
+	auto styles = get_entry_list_from_js(isolate, reader.get(object, JsKey::styles),
+	                                     LazyListKind::Styles, "result.styles");
+
+	if(!styles.has_value()) {
+		return std::unexpected{ styles.error() };
+	}
+
+	auto events = get_entry_list_from_js(isolate, reader.get(object, JsKey::events),
+	                                     LazyListKind::Events, "result.events");
+
+	if(!events.has_value()) {
+		return std::unexpected{ events.error() };
+	}
+
+	// only the output of a file descriptor is flushed before everything was read
+	if(fd >= 0) {
+		auto valid = validate_entries_from_js(reader, styles.value(), events.value(),
+		                                      reader.get(object, JsKey::extra_sections));
+
+		if(!valid.has_value()) {
+			return std::unexpected{ valid.error() };
+		}
+	}
+
+	AssWriter writer{ file_props->line_type, fd };
+
+	// strings read from js are always UTF-8
+	auto strings = StringConverter::for_normalized_utf8();
+
+	// only the native entries of lazy lists have a known size
+	std::span<const AssStyleEntry> native_styles{};
+	std::span<const AssEventEntry> native_events{};
+
+	if(styles->lazy != nullptr) {
+		const AssStyles& entries = styles->lazy->ass_result().styles;
+		native_styles = { entries.entries, ZVEC_LENGTH(entries.entries) };
+	}
+
+	if(events->lazy != nullptr) {
+		const AssEvents& entries = events->lazy->ass_result().events;
+		native_events = { entries.entries, ZVEC_LENGTH(entries.entries) };
+	}
+
+	writer.reserve(estimate_ass_size(native_styles, native_events));
+
+	// the output is always UTF-8, so every source with a BOM gets an UTF-8 BOM
+	if(file_props->file_type != FileTypeUnknown) {
+		writer.write_bom();
+	}
+
+	auto script_info =
+	    reader.script_info(reader.get(object, JsKey::script_info), "result.script_info");
+
+	if(!script_info.has_value()) {
+		return std::unexpected{ script_info.error() };
+	}
+
+	writer.write_script_info(script_info.value(), strings);
+	reader.clear_strings();
+
+	writer.begin_styles();
+
+	if(styles->lazy != nullptr) {
+		auto lazy_strings = styles->lazy->string_converter();
+
+		for(const AssStyleEntry& style : native_styles) {
+			writer.write_style(style, lazy_strings);
+		}
+	} else {
+		for(uint32_t i = 0; i < styles->array->Length(); ++i) {
+			auto style = reader.style(Nan::Get(styles->array, i).ToLocalChecked(),
+			                          "result.styles[" + std::to_string(i) + "]");
+
+			if(!style.has_value()) {
+				return std::unexpected{ style.error() };
+			}
+
+			writer.write_style(style.value(), strings);
+			reader.clear_strings();
+		}
+	}
+
+	writer.begin_events();
+
+	if(events->lazy != nullptr) {
+		auto lazy_strings = events->lazy->string_converter();
+
+		for(const AssEventEntry& event : native_events) {
+			writer.write_event(event, lazy_strings);
+		}
+	} else {
+		for(uint32_t i = 0; i < events->array->Length(); ++i) {
+			auto event = reader.event(Nan::Get(events->array, i).ToLocalChecked(),
+			                          "result.events[" + std::to_string(i) + "]");
+
+			if(!event.has_value()) {
+				return std::unexpected{ event.error() };
+			}
+
+			writer.write_event(event.value(), strings);
+			reader.clear_strings();
+		}
+	}
+
+	auto extra_sections = write_extra_sections_from_js(
+	    reader, &writer, reader.get(object, JsKey::extra_sections));
+
+	if(!extra_sections.has_value()) {
+		return std::unexpected{ extra_sections.error() };
+	}
+
+	return { std::move(writer) };
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "./ass_writer.hpp"
+#include "./convert.hpp"
+
+#include <expected>
+
+// writes an AssResult, as ass_parse_result_to_js returns it in the eager or lazy result mode with
+// the given formats, the values are validated and strings with line breaks (or commas, except in
+// the event text and key value lines) are rejected, events and styles of lazy lists are written
+// directly from their native result, fd is -1 to write into memory, with a file descriptor every
+// entry is validated before anything is written to it, the writer is returned before
+// AssWriter::finish
+[[nodiscard]] std::expected<AssWriter, v8::Local<v8::Value>>
+write_ass_result_from_js(v8::Isolate* isolate, v8::Local<v8::Value> value,
+                         const ValueFormats& formats, int fd);
@@ -0,0 +1,592 @@
+#include "./json_writer.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <stb/ds.h>
+#include <string_view>
+
+// how every byte is written inside of a JSON string
+enum class JsonEscape : uint8_t {
+	None,
+	// \" \\ \b \f \n \r \t
+	Short,
+	// \u00XX for every other control character
+	Unicode,
+};
+
+static constexpr std::array<JsonEscape, 256> json_escapes = [] {
+	std::array<JsonEscape, 256> escapes{};
+
+	for(size_t i = 0; i < 0x20; ++i) {
+		escapes[i] = JsonEscape::Unicode;
+	}
+
+	for(unsigned char byte : { '"', '\\', '\b', '\f', '\n', '\r', '\t' }) {
+		escapes[byte] = JsonEscape::Short;
+	}
+
+	return escapes;
+}();
+
+[[nodiscard]] static char json_short_escape(unsigned char byte) {
+	switch(byte) {
+		case '"': return '"';
+		case '\\': return '\\';
+		case '\b': return 'b';
+		case '\f': return 'f';
+		case '\n': return 'n';
+		case '\r': return 'r';
+		case '\t': return 't';
+		default: {
+			assert(false && "UNREACHABLE");
+			return '?';
+		}
+	}
+}
+
+// writes a finite, non zero double like Number.prototype.toString (and so JSON.stringify): the
+// shortest round trip digits, in plain notation for 1e-6 <= |value| < 1e21, otherwise as d.ddde+XX
+static void append_js_number(std::string& out, double value) {
+
+	// scientific to_chars gives the shortest digits as d.ddde+XX
+	std::array<char, 32> buffer{};
+	auto [end, error] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value,
+	                                  std::chars_format::scientific);
+
+	assert(error == std::errc{} && "the buffer is large enough for every double");
+
+	const std::string_view scientific{ buffer.data(), end };
+	const size_t exponent_start = scientific.find('e');
+
+	assert(exponent_start != std::string_view::npos && "scientific output has an exponent");
+
+	std::string_view mantissa = scientific.substr(0, exponent_start);
+
+	if(mantissa.front() == '-') {
+		out.push_back('-');
+		mantissa.remove_prefix(1);
+	}
+
+	std::array<char, 20> digits{};
+	size_t digit_count = 0;
+
+	for(char character : mantissa) {
+		if(character != '.') {
+			digits[digit_count++] = character;
+		}
+	}
+
+	int exponent = 0;
+	const std::string_view exponent_str = scientific.substr(exponent_start + 1);
+	std::from_chars(exponent_str.data() + (exponent_str.front() == '+' ? 1 : 0),
+	                exponent_str.data() + exponent_str.size(), exponent);
+
+	// the naming of the spec: value = 0.digits * 10^n
+	const int n = exponent + 1;
+	const auto k = static_cast<int>(digit_count);
+
+	if(k <= n && n <= 21) {
+		out.append(digits.data(), digit_count);
+		out.append(static_cast<size_t>(n - k), '0');
+	} else if(0 < n && n <= 21) {
+		out.append(digits.data(), static_cast<size_t>(n));
+		out.push_back('.');
+		out.append(digits.data() + n, static_cast<size_t>(k - n));
+	} else if(-6 < n && n <= 0) {
+		out.append("0.");
+		out.append(static_cast<size_t>(-n), '0');
+		out.append(digits.data(), digit_count);
+	} else {
+		out.push_back(digits[0]);
+
+		if(k > 1) {
+			out.push_back('.');
+			out.append(digits.data() + 1, digit_count - 1);
+		}
+
+		out.push_back('e');
+		out.push_back(n - 1 < 0 ? '-' : '+');
+		out.append(std::to_string(std::abs(n - 1)));
+	}
+}
+
+// a single growing output buffer, commas between values are added automatically
+struct JsonWriter {
+  private:
+	std::string m_out;
+	// the normalized value of strings, that are not already UTF-8
+	std::string m_scratch;
+	StringConverter m_strings;
+	// a value was written in the current object or array
+	bool m_needs_comma;
+
+	void separate() {
+		if(m_needs_comma) {
+			m_out.push_back(',');
+		}
+	}
+
+	void append_escaped(std::string_view value) {
+
+		m_out.push_back('"');
+
+		size_t run_start = 0;
+
+		for(size_t i = 0; i < value.size(); ++i) {
+			const auto byte = static_cast<unsigned char>(value[i]);
+			const JsonEscape escape = json_escapes[byte];
+
+			if(escape == JsonEscape::None) {
+				continue;
+			}
+
+			m_out.append(value.data() + run_start, i - run_start);
+			run_start = i + 1;
+
+			if(escape == JsonEscape::Short) {
+				m_out.push_back('\\');
+				m_out.push_back(json_short_escape(byte));
+				continue;
+			}
+
+			static constexpr std::string_view hex_digits = "0123456789abcdef";
+
+			m_out.append("\\u00");
+			m_out.push_back(hex_digits[byte >> 4U]);
+			m_out.push_back(hex_digits[byte & 0xFU]);
+		}
+
+		m_out.append(value.data() + run_start, value.size() - run_start);
+
+		m_out.push_back('"');
+	}
+
+  public:
+	explicit JsonWriter(FileType file_type)
+	    : m_out{}, m_scratch{}, m_strings{ file_type, nullptr }, m_needs_comma{ false } {}
+
+	void reserve(size_t size) { m_out.reserve(size); }
+
+	void begin_object() {
+		separate();
+		m_out.push_back('{');
+		m_needs_comma = false;
+	}
+
+	void end_object() {
+		m_out.push_back('}');
+		m_needs_comma = true;
+	}
+
+	void begin_array() {
+		separate();
+		m_out.push_back('[');
+		m_needs_comma = false;
+	}
+
+	void end_array() {
+		m_out.push_back(']');
+		m_needs_comma = true;
+	}
+
+	void key(std::string_view name) {
+		separate();
+		append_escaped(name);
+		m_out.push_back(':');
+		m_needs_comma = false;
+	}
+
+	void key(JsKey name) { key(js_key_name(name)); }
+
+	// for constant strings (e.g. of enums) and c strings, that are already UTF-8
+	void string(std::string_view value) {
+		separate();
+		append_escaped(value);
+		m_needs_comma = true;
+	}
+
+	void string(const FinalStr& value) {
+		m_scratch.clear();
+		m_strings.append_utf8(m_scratch, value);
+
+		string(std::string_view{ m_scratch });
+	}
+
+	void boolean(bool value) {
+		separate();
+		m_out.append(value ? "true" : "false");
+		m_needs_comma = true;
+	}
+
+	template <typename T> void integer(T value) {
+		separate();
+
+		std::array<char, 24> buffer{};
+		auto [end, error] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+
+		assert(error == std::errc{} && "the buffer is large enough for every integer");
+
+		m_out.append(buffer.data(), end);
+		m_needs_comma = true;
+	}
+
+	// written exactly like JSON.stringify
+	void number(double value) {
+
+		if(!std::isfinite(value)) {
+			separate();
+			m_out.append("null");
+			m_needs_comma = true;
+			return;
+		}
+
+		// JSON.stringify writes -0 as 0
+		if(value == 0) {
+			integer(0);
+			return;
+		}
+
+		separate();
+		append_js_number(m_out, value);
+		m_needs_comma = true;
+	}
+
+	[[nodiscard]] std::string take() { return std::move(m_out); }
+};
+
+// conversions, in the same order and with the same keys as in convert.cpp
+
+static void file_pos_to_json(JsonWriter& writer, const FilePos& position) {
+	writer.begin_object();
+	writer.key(JsKey::line);
+	writer.integer(position.line);
+	writer.key(JsKey::column);
+	writer.integer(position.column);
+	writer.end_object();
+}
+
+static void diagnostics_to_json(JsonWriter& writer, const Diagnostics& diagnostics) {
+
+	writer.begin_array();
+
+	for(size_t i = 0; i < ZVEC_LENGTH(diagnostics.entries); ++i) {
+		const DiagnosticEntry& diagnostic = diagnostics.entries[i];
+
+		MessageStruct message = get_message_from_entry(diagnostic);
+
+		writer.begin_object();
+		writer.key(JsKey::message);
+		writer.string(std::string_view{ message.message });
+		writer.key(JsKey::severity);
+		writer.string(diagnostic_severity_string(diagnostic.severity));
+
+		if(!is_empty_pos(diagnostic.position)) {
+			writer.key(JsKey::position);
+			file_pos_to_json(writer, diagnostic.position);
+		}
+
+		writer.end_object();
+
+		free_message_struct(message);
+	}
+
+	writer.end_array();
+}
+
+static void script_info_to_json(JsonWriter& writer, const AssScriptInfo& script_info) {
+
+	writer.begin_object();
+
+	writer.key(JsKey::title);
+	writer.string(script_info.title);
+	writer.key(JsKey::original_script);
+	writer.string(script_info.original_script);
+	writer.key(JsKey::original_translation);
+	writer.string(script_info.original_translation);
+	writer.key(JsKey::original_editing);
+	writer.string(script_info.original_editing);
+	writer.key(JsKey::original_timing);
+	writer.string(script_info.original_timing);
+	writer.key(JsKey::synch_point);
+	writer.string(script_info.synch_point);
+	writer.key(JsKey::script_updated_by);
+	writer.string(script_info.script_updated_by);
+	writer.key(JsKey::update_details);
+	writer.string(script_info.update_details);
+	writer.key(JsKey::script_type);
+	writer.string(script_type_to_string(script_info.script_type));
+	writer.key(JsKey::collisions);
+	writer.string(script_info.collisions);
+	writer.key(JsKey::play_res_y);
+	writer.integer(script_info.play_res_y);
+	writer.key(JsKey::play_res_x);
+	writer.integer(script_info.play_res_x);
+	writer.key(JsKey::play_depth);
+	writer.string(script_info.play_depth);
+	writer.key(JsKey::timer);
+	writer.string(script_info.timer);
+	writer.key(JsKey::wrap_style);
+	writer.integer(static_cast<uint32_t>(script_info.wrap_style));
+	writer.key(JsKey::scaled_border_and_shadow);
+	writer.boolean(script_info.scaled_border_and_shadow);
+	writer.key(JsKey::video_aspect_ratio);
+	writer.integer(script_info.video_aspect_ratio);
+	writer.key(JsKey::video_zoom);
+	writer.integer(script_info.video_zoom);
+	writer.key(JsKey::ycbcr_matrix);
+	writer.string(script_info.ycbcr_matrix);
+
+	writer.end_object();
+}
+
+static void ass_color_to_json(JsonWriter& writer, const AssColor& color, ColorFormat format) {
+
+	if(format == ColorFormat::Packed) {
+		writer.integer(ass_color_to_packed(color));
+		return;
+	}
+
+	writer.begin_object();
+	writer.key(JsKey::r);
+	writer.integer(static_cast<uint32_t>(color.r));
+	writer.key(JsKey::g);
+	writer.integer(static_cast<uint32_t>(color.g));
+	writer.key(JsKey::b);
+	writer.integer(static_cast<uint32_t>(color.b));
+	writer.key(JsKey::a);
+	writer.integer(static_cast<uint32_t>(color.a));
+	writer.end_object();
+}
+
+// writes the key and the value, if the key is projected
+template <typename Write>
+static void projected_to_json(JsonWriter& writer, const JsKeySet& fields, JsKey key,
+                              Write&& write) {
+
+	if(!fields.test(static_cast<size_t>(key))) {
+		return;
+	}
+
+	writer.key(key);
+	write();
+}
+
+static void style_to_json(JsonWriter& writer, const AssStyleEntry& style, const JsKeySet& fields,
+                          const ValueFormats& formats) {
+
+	auto color = [&writer, &formats](const AssColor& value) {
+		return [&writer, &formats, &value] { ass_color_to_json(writer, value, formats.color); };
+	};
+
+	writer.begin_object();
+
+	projected_to_json(writer, fields, JsKey::name, [&] { writer.string(style.name); });
+	projected_to_json(writer, fields, JsKey::fontname, [&] { writer.string(style.fontname); });
+	projected_to_json(writer, fields, JsKey::fontsize, [&] { writer.integer(style.fontsize); });
+	projected_to_json(writer, fields, JsKey::primary_colour, color(style.primary_colour));
+	projected_to_json(writer, fields, JsKey::secondary_colour, color(style.secondary_colour));
+	projected_to_json(writer, fields, JsKey::outline_colour, color(style.outline_colour));
+	projected_to_json(writer, fields, JsKey::back_colour, color(style.back_colour));
+	projected_to_json(writer, fields, JsKey::bold, [&] { writer.boolean(style.bold); });
+	projected_to_json(writer, fields, JsKey::italic, [&] { writer.boolean(style.italic); });
+	projected_to_json(writer, fields, JsKey::underline, [&] { writer.boolean(style.underline); });
+	projected_to_json(writer, fields, JsKey::strike_out,
+	                  [&] { writer.boolean(style.strike_out); });
+	projected_to_json(writer, fields, JsKey::scale_x, [&] { writer.integer(style.scale_x); });
+	projected_to_json(writer, fields, JsKey::scale_y, [&] { writer.integer(style.scale_y); });
+	projected_to_json(writer, fields, JsKey::spacing, [&] { writer.number(style.spacing); });
+	projected_to_json(writer, fields, JsKey::angle, [&] { writer.number(style.angle); });
+	projected_to_json(writer, fields, JsKey::border_style,
+	                  [&] { writer.integer(static_cast<uint32_t>(style.border_style)); });
+	projected_to_json(writer, fields, JsKey::outline, [&] { writer.number(style.outline); });
+	projected_to_json(writer, fields, JsKey::shadow, [&] { writer.number(style.shadow); });
+	projected_to_json(writer, fields, JsKey::alignment,
+	                  [&] { writer.integer(static_cast<uint32_t>(style.alignment)); });
+	projected_to_json(writer, fields, JsKey::margin_l, [&] { writer.integer(style.margin_l); });
+	projected_to_json(writer, fields, JsKey::margin_r, [&] { writer.integer(style.margin_r); });
+	projected_to_json(writer, fields, JsKey::margin_v, [&] { writer.integer(style.margin_v); });
+	projected_to_json(writer, fields, JsKey::encoding, [&] { writer.integer(style.encoding); });
+
+	writer.end_object();
+}
+
+static void ass_time_to_json(JsonWriter& writer, const AssTime& time, TimeFormat format) {
+
+	switch(format) {
+		case TimeFormat::Centiseconds: writer.integer(ass_time_to_centiseconds(time)); return;
+		case TimeFormat::Milliseconds: writer.integer(ass_time_to_ms(time)); return;
+		case TimeFormat::Object:
+		default: break;
+	}
+
+	writer.begin_object();
+	writer.key(JsKey::hour);
+	writer.integer(static_cast<uint32_t>(time.hour));
+	writer.key(JsKey::min);
+	writer.integer(static_cast<uint32_t>(time.min));
+	writer.key(JsKey::sec);
+	writer.integer(static_cast<uint32_t>(time.sec));
+	writer.key(JsKey::hundred);
+	writer.integer(static_cast<uint32_t>(time.hundred));
+	writer.end_object();
+}
+
+static void margin_to_json(JsonWriter& writer, const MarginValue& value) {
+
+	if(value.is_default) {
+		writer.string("default");
+		return;
+	}
+
+	writer.integer(value.data.value);
+}
+
+static void event_to_json(JsonWriter& writer, const AssEventEntry& event, const JsKeySet& fields,
+                          const ValueFormats& formats) {
+
+	writer.begin_object();
+
+	projected_to_json(writer, fields, JsKey::type,
+	                  [&] { writer.string(event_type_to_string(event.type)); });
+	projected_to_json(writer, fields, JsKey::layer, [&] { writer.integer(event.layer); });
+	projected_to_json(writer, fields, JsKey::start,
+	                  [&] { ass_time_to_json(writer, event.start, formats.time); });
+	projected_to_json(writer, fields, JsKey::end,
+	                  [&] { ass_time_to_json(writer, event.end, formats.time); });
+	projected_to_json(writer, fields, JsKey::style, [&] { writer.string(event.style); });
+	projected_to_json(writer, fields, JsKey::name, [&] { writer.string(event.name); });
+	projected_to_json(writer, fields, JsKey::margin_l,
+	                  [&] { margin_to_json(writer, event.margin_l); });
+	projected_to_json(writer, fields, JsKey::margin_r,
+	                  [&] { margin_to_json(writer, event.margin_r); });
+	projected_to_json(writer, fields, JsKey::margin_v,
+	                  [&] { margin_to_json(writer, event.margin_v); });
+	projected_to_json(writer, fields, JsKey::effect, [&] { writer.string(event.effect); });
+	projected_to_json(writer, fields, JsKey::text, [&] { writer.string(event.text); });
+
+	writer.end_object();
+}
+
+static void extra_sections_to_json(JsonWriter& writer, const ExtraSections& extra_sections) {
+
+	writer.begin_object();
+
+	size_t sections_length = ZMAP_FOREACH_TODO(extra_sections.entries);
+
+	for(size_t i = 0; i < sections_length; ++i) {
+		const ExtraSectionHashMapEntry& section = extra_sections.entries[i];
+
+		writer.key(std::string_view{ section.key });
+		writer.begin_object();
+
+		size_t fields_length = ZMAP_FOREACH_TODO(section.value.fields);
+
+		for(size_t j = 0; j < fields_length; ++j) {
+			const SectionFieldEntry& field = section.value.fields[j];
+
+			writer.key(std::string_view{ field.key });
+			writer.string(field.value);
+		}
+
+		writer.end_object();
+	}
+
+	writer.end_object();
+}
+
+static void ass_result_to_json(JsonWriter& writer, const AssResult& ass_result,
+                               const ConvertSettings& convert_settings) {
+
+	const Projection& projection = convert_settings.projection;
+	const ValueFormats& formats = convert_settings.formats;
+
+	writer.begin_object();
+
+	projected_to_json(writer, projection.sections, JsKey::script_info,
+	                  [&] { script_info_to_json(writer, ass_result.script_info); });
+
+	projected_to_json(writer, projection.sections, JsKey::styles, [&] {
+		writer.begin_array();
+
+		for(size_t i = 0; i < ZVEC_LENGTH(ass_result.styles.entries); ++i) {
+			style_to_json(writer, ass_result.styles.entries[i], projection.style_fields,
+			              formats);
+		}
+
+		writer.end_array();
+	});
+
+	projected_to_json(writer, projection.sections, JsKey::events, [&] {
+		writer.begin_array();
+
+		for(size_t i = 0; i < ZVEC_LENGTH(ass_result.events.entries); ++i) {
+			event_to_json(writer, ass_result.events.entries[i], projection.event_fields,
+			              formats);
+		}
+
+		writer.end_array();
+	});
+
+	projected_to_json(writer, projection.sections, JsKey::extra_sections,
+	                  [&] { extra_sections_to_json(writer, ass_result.extra_sections); });
+
+	projected_to_json(writer, projection.sections, JsKey::file_props, [&] {
+		writer.begin_object();
+		writer.key(JsKey::line_type);
+		writer.string(line_type_to_string(ass_result.file_props.line_type));
+		writer.key(JsKey::file_type);
+		writer.string(file_type_to_string(ass_result.file_props.file_type));
+		writer.end_object();
+	});
+
+	writer.end_object();
+}
+
+// the JSON of events is mostly their text, so this avoids most reallocations
+[[nodiscard]] static size_t estimate_json_size(const AssResult& ass_result) {
+
+	constexpr size_t bytes_per_event = 256;
+	constexpr size_t bytes_per_style = 512;
+	constexpr size_t base_bytes = 1024;
+
+	return base_bytes + (ZVEC_LENGTH(ass_result.events.entries) * bytes_per_event) +
+	       (ZVEC_LENGTH(ass_result.styles.entries) * bytes_per_style);
+}
+
+[[nodiscard]] std::string write_json(AssParseResultCpp& result,
+                                     const ConvertSettings& convert_settings) {
+
+	auto parse_result = result.result();
+
+	const AssResult* ass_result = nullptr;
+
+	if(const auto* result_ok = std::get_if<AssParseResultOkCpp>(&parse_result);
+	   result_ok != nullptr) {
+		ass_result = &result_ok->result;
+	}
+
+	JsonWriter writer{ ass_result != nullptr ? ass_result->file_props.file_type : FileTypeUtf8 };
+
+	if(ass_result != nullptr) {
+		writer.reserve(estimate_json_size(*ass_result));
+	}
+
+	writer.begin_object();
+
+	writer.key(JsKey::diagnostics);
+	diagnostics_to_json(writer, result.diagnostics());
+
+	writer.key(JsKey::error);
+	writer.boolean(ass_result == nullptr);
+
+	if(ass_result != nullptr) {
+		writer.key(JsKey::result);
+		ass_result_to_json(writer, *ass_result, convert_settings);
+	}
+
+	writer.end_object();
+
+	return writer.take();
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "./convert.hpp"
+
+#include <string>
+
+// writes the same AssParseResult, that ass_parse_result_to_js returns (and JSON.stringify would
+// write), as UTF-8 JSON directly from the native result, without creating any js value, so this
+// can run on any thread
+//
+// the projection and the time and color formats are applied, the result is always written like
+// the eager result mode, profile and event_index are not part of the JSON, numbers, that would be
+// BigInts in js, are written as plain JSON numbers
+[[nodiscard]] std::string write_json(AssParseResultCpp& result,
+                                     const ConvertSettings& convert_settings);
@@ -0,0 +1,314 @@
+#include "./lazy_list.hpp"
+#include "./isolate_data.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+LazyList::LazyList()
+    : m_result{ nullptr },
+      m_ass_result{},
+      m_kind{ LazyListKind::Events },
+      m_fields{},
+      m_formats{ .time = TimeFormat::Object, .color = ColorFormat::Object },
+      m_external_strings{ false },
+      m_isolate{ nullptr },
+      m_external_bytes{ 0 } {}
+
+LazyList::~LazyList() {
+	if(m_isolate != nullptr && m_external_bytes != 0) {
+		m_isolate->AdjustAmountOfExternalAllocatedMemory(-m_external_bytes);
+	}
+}
+
+// an estimate of the native memory of the entries of one list, the entries and their strings, so
+// that the events and styles lists of the same result don't count the same memory twice
+[[nodiscard]] static int64_t estimate_list_bytes(const AssResult& ass_result, LazyListKind kind) {
+
+	size_t bytes = 0;
+
+	switch(kind) {
+		case LazyListKind::Events: {
+			for(size_t i = 0; i < ZVEC_LENGTH(ass_result.events.entries); ++i) {
+				const AssEventEntry& event = ass_result.events.entries[i];
+
+				bytes += sizeof(AssEventEntry) + event.style.length + event.name.length +
+				         event.effect.length + event.text.length;
+			}
+			break;
+		}
+		case LazyListKind::Styles: {
+			for(size_t i = 0; i < ZVEC_LENGTH(ass_result.styles.entries); ++i) {
+				const AssStyleEntry& style = ass_result.styles.entries[i];
+
+				bytes += sizeof(AssStyleEntry) + style.name.length + style.fontname.length;
+			}
+			break;
+		}
+		default: {
+			assert(false && "UNREACHABLE");
+			break;
+		}
+	}
+
+	return static_cast<int64_t>(bytes);
+}
+
+[[nodiscard]] size_t LazyList::length() const {
+	if(m_result == nullptr) {
+		return 0;
+	}
+
+	switch(m_kind) {
+		case LazyListKind::Events: return ZVEC_LENGTH(m_ass_result.events.entries);
+		case LazyListKind::Styles: return ZVEC_LENGTH(m_ass_result.styles.entries);
+		default: {
+			assert(false && "UNREACHABLE");
+			return 0;
+		}
+	}
+}
+
+[[nodiscard]] StringConverter LazyList::string_converter() const {
+	return StringConverter{ m_ass_result.file_props.file_type,
+		                    m_external_strings ? m_result : nullptr };
+}
+
+[[nodiscard]] v8::Local<v8::Value> LazyList::entry_to_js(v8::Isolate* isolate, size_t index,
+                                                         StringConverter& strings) const {
+	switch(m_kind) {
+		case LazyListKind::Events:
+			return event_to_js(isolate, m_ass_result.events.entries[index], m_fields, m_formats,
+			                   strings);
+		case LazyListKind::Styles:
+			return style_to_js(isolate, m_ass_result.styles.entries[index], m_fields, m_formats,
+			                   strings);
+		default: {
+			assert(false && "UNREACHABLE");
+			return Nan::Undefined();
+		}
+	}
+}
+
+NAN_MODULE_INIT(LazyList::Init) {
+
+	UNUSED(target);
+
+	v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+	tpl->SetClassName(Nan::New("LazyList").ToLocalChecked());
+	tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+	Nan::SetAccessor(tpl->InstanceTemplate(), Nan::New("length").ToLocalChecked(), Length);
+
+	Nan::SetPrototypeMethod(tpl, "get", Get);
+	Nan::SetPrototypeMethod(tpl, "slice", Slice);
+
+	// every isolate (e.g. of a worker thread) has its own constructor
+	auto* isolate = v8::Isolate::GetCurrent();
+
+	// the signature makes v8 reject receivers, that are not LazyList instances, before Iterator
+	// unwraps them, like Nan::SetPrototypeMethod does for get and slice
+	tpl->PrototypeTemplate()->Set(
+	    v8::Symbol::GetIterator(isolate),
+	    Nan::New<v8::FunctionTemplate>(Iterator, v8::Local<v8::Value>(),
+	                                   v8::Signature::New(isolate, tpl)));
+
+	IsolateData::get(isolate).set_lazy_list_template(isolate, tpl);
+}
+
+[[nodiscard]] v8::Local<v8::Object>
+LazyList::NewInstance(v8::Isolate* isolate, const std::shared_ptr<AssParseResultCpp>& result,
+                      LazyListKind kind, const ConvertSettings& convert_settings) {
+
+	v8::Local<v8::Function> cons =
+	    Nan::GetFunction(IsolateData::get(isolate).lazy_list_template(isolate)).ToLocalChecked();
+
+	v8::Local<v8::Object> instance = Nan::NewInstance(cons, 0, nullptr).ToLocalChecked();
+
+	auto* list = Nan::ObjectWrap::Unwrap<LazyList>(instance);
+
+	list->m_result = result;
+	list->m_kind = kind;
+	list->m_fields = kind == LazyListKind::Events ? convert_settings.projection.event_fields
+	                                              : convert_settings.projection.style_fields;
+	list->m_formats = convert_settings.formats;
+	list->m_external_strings = convert_settings.external_strings;
+
+	std::visit(helper::Overloaded{
+	               [list](const AssParseResultErrorCpp&) -> void { list->m_result = nullptr; },
+	               [list](const AssParseResultOkCpp& result_ok) -> void {
+		               list->m_ass_result = result_ok.result;
+	               },
+	           },
+	           result->result());
+
+	// the native result is only freed, after the list was collected, so v8 has to know about it to
+	// collect large results in time
+	list->m_isolate = isolate;
+	list->m_external_bytes =
+	    list->m_result == nullptr ? 0 : estimate_list_bytes(list->m_ass_result, kind);
+	isolate->AdjustAmountOfExternalAllocatedMemory(list->m_external_bytes);
+
+	return instance;
+}
+
+[[nodiscard]] const LazyList* LazyList::FromValue(v8::Isolate* isolate,
+                                                  v8::Local<v8::Value> value) {
+
+	if(!value->IsObject() ||
+	   !IsolateData::get(isolate).lazy_list_template(isolate)->HasInstance(value)) {
+		return nullptr;
+	}
+
+	return Nan::ObjectWrap::Unwrap<LazyList>(value.As<v8::Object>());
+}
+
+[[nodiscard]] LazyListKind LazyList::kind() const {
+	return m_kind;
+}
+
+[[nodiscard]] const AssResult& LazyList::ass_result() const {
+	return m_ass_result;
+}
+
+NAN_METHOD(LazyList::New) {
+
+	if(!info.IsConstructCall()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("LazyList can only be created by the ass_parser"));
+		return;
+	}
+
+	auto* list = new LazyList();
+	list->Wrap(info.This());
+
+	info.GetReturnValue().Set(info.This());
+}
+
+NAN_GETTER(LazyList::Length) {
+
+	UNUSED(property);
+
+	auto* list = Nan::ObjectWrap::Unwrap<LazyList>(info.Holder());
+
+	info.GetReturnValue().Set(static_cast<double>(list->length()));
+}
+
+NAN_METHOD(LazyList::Get) {
+
+	auto* list = Nan::ObjectWrap::Unwrap<LazyList>(info.Holder());
+
+	if(info.Length() != 1 || !info[0]->IsNumber()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'index' argument needs to be a number"));
+		return;
+	}
+
+	double index = Nan::To<double>(info[0]).FromJust();
+
+	if(index < 0 || index >= static_cast<double>(list->length()) ||
+	   index != static_cast<double>(static_cast<size_t>(index))) {
+		info.GetReturnValue().Set(Nan::Undefined());
+		return;
+	}
+
+	auto strings = list->string_converter();
+
+	info.GetReturnValue().Set(
+	    list->entry_to_js(info.GetIsolate(), static_cast<size_t>(index), strings));
+}
+
+[[nodiscard]] size_t resolve_slice_index(v8::Local<v8::Value> value, size_t length,
+                                         size_t default_value) {
+
+	if(value->IsUndefined()) {
+		return default_value;
+	}
+
+	double index = Nan::To<double>(value).FromMaybe(0);
+
+	if(std::isnan(index)) {
+		return 0;
+	}
+
+	index = std::trunc(index);
+
+	if(index < 0) {
+		return static_cast<size_t>(std::max(static_cast<double>(length) + index, 0.0));
+	}
+
+	return static_cast<size_t>(std::min(index, static_cast<double>(length)));
+}
+
+NAN_METHOD(LazyList::Slice) {
+
+	auto* list = Nan::ObjectWrap::Unwrap<LazyList>(info.Holder());
+
+	size_t length = list->length();
+
+	size_t start = resolve_slice_index(info[0], length, 0);
+
+	size_t end = resolve_slice_index(info[1], length, length);
+
+	std::vector<v8::Local<v8::Value>> values{};
+
+	auto strings = list->string_converter();
+
+	for(size_t i = start; i < end; ++i) {
+		values.push_back(list->entry_to_js(info.GetIsolate(), i, strings));
+	}
+
+	info.GetReturnValue().Set(v8::Array::New(info.GetIsolate(), values.data(), values.size()));
+}
+
+NAN_METHOD(LazyList::Iterator) {
+
+	auto* isolate = info.GetIsolate();
+
+	auto context = isolate->GetCurrentContext();
+
+	// the iterator state lives in the data of the next function: [list, next_index]
+	v8::Local<v8::Value> state_values[] = { info.Holder(), Nan::New<v8::Number>(0) };
+
+	v8::Local<v8::Array> state = v8::Array::New(isolate, state_values, 2);
+
+	v8::Local<v8::Function> next = v8::Function::New(context, IteratorNext, state).ToLocalChecked();
+
+	v8::Local<v8::Object> iterator = Nan::New<v8::Object>();
+
+	Nan::Set(iterator, Nan::New("next").ToLocalChecked(), next).Check();
+
+	info.GetReturnValue().Set(iterator);
+}
+
+NAN_METHOD(LazyList::IteratorNext) {
+
+	auto* isolate = info.GetIsolate();
+
+	auto state = info.Data().As<v8::Array>();
+
+	auto holder = Nan::Get(state, 0).ToLocalChecked().As<v8::Object>();
+
+	auto* list = Nan::ObjectWrap::Unwrap<LazyList>(holder);
+
+	auto index_value = Nan::To<double>(Nan::Get(state, 1).ToLocalChecked()).FromJust();
+
+	auto index = static_cast<size_t>(index_value);
+
+	v8::Local<v8::Object> result = Nan::New<v8::Object>();
+
+	if(index >= list->length()) {
+		Nan::Set(result, Nan::New("done").ToLocalChecked(), Nan::True()).Check();
+		Nan::Set(result, Nan::New("value").ToLocalChecked(), Nan::Undefined()).Check();
+	} else {
+		Nan::Set(state, 1, Nan::New<v8::Number>(static_cast<double>(index + 1))).Check();
+
+		Nan::Set(result, Nan::New("done").ToLocalChecked(), Nan::False()).Check();
+		auto strings = list->string_converter();
+
+		Nan::Set(result, Nan::New("value").ToLocalChecked(),
+		         list->entry_to_js(isolate, index, strings))
+		    .Check();
+	}
+
+	info.GetReturnValue().Set(result);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "./convert.hpp"
+
+// resolves a relative index, like Array.prototype.slice does, default_value is used for undefined
+[[nodiscard]] size_t resolve_slice_index(v8::Local<v8::Value> value, size_t length,
+                                         size_t default_value);
+
+enum class LazyListKind : uint8_t {
+	Events,
+	Styles,
+};
+
+// a read only list, backed by the native parse result, entries are only converted to js, when
+// they are accessed, the native result is freed, after every list referencing it was garbage
+// collected
+class LazyList : public Nan::ObjectWrap {
+  private:
+	std::shared_ptr<AssParseResultCpp> m_result;
+	AssResult m_ass_result;
+	LazyListKind m_kind;
+	// the projected fields of every entry
+	JsKeySet m_fields;
+	ValueFormats m_formats;
+	bool m_external_strings;
+	// the isolate, that was told about the native memory kept alive by this list
+	v8::Isolate* m_isolate;
+	int64_t m_external_bytes;
+
+	LazyList();
+
+	~LazyList() override;
+
+	[[nodiscard]] size_t length() const;
+
+	[[nodiscard]] v8::Local<v8::Value> entry_to_js(v8::Isolate* isolate, size_t index,
+	                                               StringConverter& strings) const;
+
+	static NAN_METHOD(New);
+
+	static NAN_GETTER(Length);
+
+	static NAN_METHOD(Get);
+
+	static NAN_METHOD(Slice);
+
+	static NAN_METHOD(Iterator);
+
+	static NAN_METHOD(IteratorNext);
+
+  public:
+	static NAN_MODULE_INIT(Init);
+
+	[[nodiscard]] static v8::Local<v8::Object>
+	NewInstance(v8::Isolate* isolate, const std::shared_ptr<AssParseResultCpp>& result,
+	            LazyListKind kind, const ConvertSettings& convert_settings);
+
+	// nullptr, if the value is not a LazyList instance
+	[[nodiscard]] static const LazyList* FromValue(v8::Isolate* isolate,
+	                                               v8::Local<v8::Value> value);
+
+	[[nodiscard]] LazyListKind kind() const;
+
+	// the entries of kind() are the entries of the list, empty for error results
+	[[nodiscard]] const AssResult& ass_result() const;
+
+	// the string converter only lives for one call, e.g. one slice
+	[[nodiscard]] StringConverter string_converter() const;
+};
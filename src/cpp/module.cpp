@@ -1,8 +1,20 @@
 
+#include "./ass_writer.hpp"
+#include "./cache.hpp"
+#include "./compiled_settings.hpp"
 #include "./convert.hpp"
+#include "./document.hpp"
+#include "./event_index.hpp"
+#include "./js_ass_reader.hpp"
+#include "./json_writer.hpp"
+#include "./lazy_list.hpp"
+#include "./stream_parser.hpp"
+#include "./worker.hpp"
 
 #include <ass_parser_lib.h>
 
+#include <chrono>
+
 NAN_METHOD(parse_ass) {
 
 	if(info.Length() != 2) {
@@ -24,17 +36,798 @@ NAN_METHOD(parse_ass) {
 		return;
 	}
 
-	auto parsed = parse_ass_cpp(source.value(), settings.value());
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	ParseProfile profile{};
+	ParseProfile* profile_ptr = convert_settings->profile ? &profile : nullptr;
+
+	auto parsed = ParseCache::instance().parse(source.value(), settings.value(), profile_ptr);
+
+	auto result = ass_parse_result_to_js(info.GetIsolate(), std::move(parsed),
+	                                     convert_settings.value(), profile_ptr, nullptr);
+
+	info.GetReturnValue().Set(result);
+}
+
+// the same result as parse_ass, but as a Buffer with its JSON, no js value of the result is created
+NAN_METHOD(parse_ass_json) {
+
+	if(info.Length() != 2) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	auto source = get_ass_source_from_info(info[0]);
+
+	if(not source.has_value()) {
+		info.GetIsolate()->ThrowException(source.error());
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	auto parsed = ParseCache::instance().parse(source.value(), settings.value(), nullptr);
+
+	auto buffer = string_to_js_buffer(write_json(*parsed, convert_settings.value()));
+
+	if(not buffer.has_value()) {
+		info.GetIsolate()->ThrowException(buffer.error());
+		return;
+	}
+
+	info.GetReturnValue().Set(buffer.value());
+}
+
+NAN_METHOD(parse_ass_json_async) {
+
+	if(info.Length() != 3) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[2]->IsFunction()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'callback' argument needs to be a function"));
+		return;
+	}
+
+	auto source = get_ass_source_from_info(info[0]);
+
+	if(not source.has_value()) {
+		info.GetIsolate()->ThrowException(source.error());
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	auto* callback = new Nan::Callback(info[2].As<v8::Function>());
+
+	auto* worker = new ParseJsonWorker(callback, std::move(source.value()), settings.value(),
+	                                   convert_settings.value());
+
+	// buffer sources are not copied, so they have to be kept alive until the worker is done
+	worker->SaveToPersistent("source", info[0]);
+
+	Nan::AsyncQueueWorker(worker);
+}
+
+[[nodiscard]] static std::expected<int, v8::Local<v8::Value>>
+get_fd_from_info(v8::Local<v8::Value> value) {
+
+	if(!value->IsInt32() || value.As<v8::Int32>()->Value() < 0) {
+		return std::unexpected{ Nan::TypeError("the 'fd' argument needs to be a file descriptor") };
+	}
+
+	return { value.As<v8::Int32>()->Value() };
+}
+
+// writes a result (see write_ass_result_from_js) as an ass script, only the time and color
+// formats of the settings are used, the script is returned as a Buffer, or, if a file descriptor
+// is given, written to it and the number of written bytes is returned, that write(2) blocks the
+// calling thread like fs.writeSync, see write_ass_async for writing on the libuv threadpool
+NAN_METHOD(write_ass) {
+
+	if(info.Length() != 3) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	int fd = -1;
+
+	if(!info[2]->IsUndefined()) {
+		auto js_fd = get_fd_from_info(info[2]);
+
+		if(not js_fd.has_value()) {
+			info.GetIsolate()->ThrowException(js_fd.error());
+			return;
+		}
+
+		fd = js_fd.value();
+	}
+
+	auto writer = write_ass_result_from_js(info.GetIsolate(), info[0],
+	                                       convert_settings->formats, fd);
+
+	if(not writer.has_value()) {
+		info.GetIsolate()->ThrowException(writer.error());
+		return;
+	}
+
+	auto written = writer->finish();
+
+	if(not written.has_value()) {
+		info.GetIsolate()->ThrowException(Nan::Error(written.error().c_str()));
+		return;
+	}
+
+	if(fd >= 0) {
+		info.GetReturnValue().Set(Nan::New<v8::Number>(static_cast<double>(written.value())));
+		return;
+	}
+
+	auto buffer = string_to_js_buffer(writer->take());
+
+	if(not buffer.has_value()) {
+		info.GetIsolate()->ThrowException(buffer.error());
+		return;
+	}
+
+	info.GetReturnValue().Set(buffer.value());
+}
+
+// like write_ass with a file descriptor, but only the reading of the js result happens on the
+// main thread, the script is written into memory first and then to the file descriptor on the
+// libuv threadpool, the callback gets the number of written bytes
+NAN_METHOD(write_ass_async) {
+
+	if(info.Length() != 4) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[3]->IsFunction()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'callback' argument needs to be a function"));
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	auto fd = get_fd_from_info(info[2]);
+
+	if(not fd.has_value()) {
+		info.GetIsolate()->ThrowException(fd.error());
+		return;
+	}
+
+	auto writer =
+	    write_ass_result_from_js(info.GetIsolate(), info[0], convert_settings->formats, -1);
+
+	if(not writer.has_value()) {
+		info.GetIsolate()->ThrowException(writer.error());
+		return;
+	}
+
+	auto* callback = new Nan::Callback(info[3].As<v8::Function>());
+
+	Nan::AsyncQueueWorker(new WriteAssWorker(callback, fd.value(), writer->take()));
+}
+
+// only validates the source, the native result is freed before returning and the cache is not
+// used, so that nothing but the diagnostics is kept or converted
+NAN_METHOD(lint_ass) {
+
+	if(info.Length() != 2) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	auto source = get_ass_source_from_info(info[0]);
+
+	if(not source.has_value()) {
+		info.GetIsolate()->ThrowException(source.error());
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto parsed = parse_ass_cpp(source.value(), settings.value(), nullptr);
+
+	auto result = ass_parse_result_to_lint_js(info.GetIsolate(), *parsed);
+
+	info.GetReturnValue().Set(result);
+}
+
+// parses the source and returns a snapshot of the result as a Buffer, see snapshot.hpp
+NAN_METHOD(serialize_ass) {
+
+	if(info.Length() != 2) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	auto source = get_ass_source_from_info(info[0]);
+
+	if(not source.has_value()) {
+		info.GetIsolate()->ThrowException(source.error());
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto parsed = ParseCache::instance().parse(source.value(), settings.value(), nullptr);
+
+	auto result = ass_parse_result_to_snapshot_js(info.GetIsolate(), *parsed);
+
+	if(not result.has_value()) {
+		info.GetIsolate()->ThrowException(result.error());
+		return;
+	}
+
+	info.GetReturnValue().Set(result.value());
+}
+
+// converts a snapshot to the same result, that parse_ass returns, only the conversion settings
+// are used
+NAN_METHOD(deserialize_ass) {
+
+	if(info.Length() != 2) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[0]->IsUint8Array()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'snapshot' argument needs to be a Uint8Array"));
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	// the strings of the result are read directly from the backing store
+	Nan::TypedArrayContents<uint8_t> contents{ info[0] };
+
+	auto result = snapshot_to_ass_parse_result_js(info.GetIsolate(), *contents, contents.length(),
+	                                              convert_settings.value());
+
+	if(not result.has_value()) {
+		info.GetIsolate()->ThrowException(result.error());
+		return;
+	}
+
+	info.GetReturnValue().Set(result.value());
+}
+
+// builds an event index from start and end times in milliseconds, e.g. the start_ms and end_ms
+// columns of a columnar result
+NAN_METHOD(create_event_index) {
+
+	if(info.Length() != 2) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[0]->IsInt32Array() || !info[1]->IsInt32Array()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'start_ms' and 'end_ms' arguments need to be Int32Arrays"));
+		return;
+	}
+
+	Nan::TypedArrayContents<int32_t> starts{ info[0] };
+	Nan::TypedArrayContents<int32_t> ends{ info[1] };
+
+	if(starts.length() != ends.length()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'start_ms' and 'end_ms' arguments need to have the same length"));
+		return;
+	}
+
+	auto event_index = EventIntervalIndex::from_times(
+	    std::vector<int32_t>(*starts, *starts + starts.length()),
+	    std::vector<int32_t>(*ends, *ends + ends.length()));
+
+	info.GetReturnValue().Set(EventIndex::NewInstance(info.GetIsolate(), std::move(event_index)));
+}
+
+// parses the content once and returns an AssDocument, that reparses only the changed lines on
+// edits, the parse settings and the conversion settings of events and styles are kept
+NAN_METHOD(create_document) {
+
+	if(info.Length() != 2) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[0]->IsString()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'content' argument needs to be a string"));
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	Nan::Utf8String content{ info[0] };
+
+	auto state = DocumentState::from_text({ *content, static_cast<size_t>(content.length()) },
+	                                      settings.value());
+
+	info.GetReturnValue().Set(
+	    AssDocument::NewInstance(info.GetIsolate(), std::move(state), convert_settings.value()));
+}
+
+// returns a StreamParser, that parses the fed bytes of a UTF-8 script in parts, every batch_size
+// event lines are emitted as one chunk
+NAN_METHOD(create_stream_parser) {
+
+	if(info.Length() != 2) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[1]->IsUint32() || Nan::To<uint32_t>(info[1]).FromJust() == 0) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'batch_size' argument needs to be a positive integer"));
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[0]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[0]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	if(convert_settings->result_mode != ResultMode::Eager) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the stream parser only supports the result_mode 'eager'"));
+		return;
+	}
+
+	auto batch_size = static_cast<size_t>(Nan::To<uint32_t>(info[1]).FromJust());
+
+	auto state = std::make_unique<StreamParserState>(settings.value(), batch_size);
+
+	info.GetReturnValue().Set(
+	    StreamParser::NewInstance(info.GetIsolate(), std::move(state), convert_settings.value()));
+}
+
+NAN_METHOD(parse_ass_async) {
+
+	if(info.Length() != 3) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[2]->IsFunction()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'callback' argument needs to be a function"));
+		return;
+	}
+
+	auto source = get_ass_source_from_info(info[0]);
+
+	if(not source.has_value()) {
+		info.GetIsolate()->ThrowException(source.error());
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	auto* callback = new Nan::Callback(info[2].As<v8::Function>());
+
+	auto* worker = new ParseAssWorker(callback, std::move(source.value()), settings.value(),
+	                                  convert_settings.value());
+
+	// buffer sources are not copied, so they have to be kept alive until the worker is done
+	worker->SaveToPersistent("source", info[0]);
+
+	Nan::AsyncQueueWorker(worker);
+}
+
+NAN_METHOD(parse_ass_batch) {
+
+	if(info.Length() != 4) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[0]->IsArray()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'sources' argument needs to be an array"));
+		return;
+	}
+
+	if(!info[2]->IsUint32()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'concurrency' argument needs to be a non negative integer"));
+		return;
+	}
+
+	if(!info[3]->IsFunction()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'callback' argument needs to be a function"));
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	auto js_sources = info[0].As<v8::Array>();
+
+	std::vector<std::optional<AssSourceCpp>> sources{};
+	sources.reserve(js_sources->Length());
+
+	std::vector<std::pair<size_t, v8::Local<v8::Value>>> source_errors{};
+
+	for(uint32_t i = 0; i < js_sources->Length(); ++i) {
+		auto source = get_ass_source_from_info(Nan::Get(js_sources, i).ToLocalChecked());
+
+		if(not source.has_value()) {
+			source_errors.emplace_back(i, source.error());
+			sources.emplace_back(std::nullopt);
+			continue;
+		}
+
+		sources.emplace_back(std::move(source.value()));
+	}
+
+	auto concurrency = Nan::To<uint32_t>(info[2]).FromJust();
+
+	auto* callback = new Nan::Callback(info[3].As<v8::Function>());
+
+	auto* job = new BatchParseJob(callback, std::move(sources), js_sources, settings.value(),
+	                              convert_settings.value(), concurrency);
+
+	for(const auto& [index, error] : source_errors) {
+		job->set_source_error(index, error);
+	}
+
+	job->start();
+}
+
+// validates the settings once, the returned handle can be passed to every parse function instead
+// of the settings object
+NAN_METHOD(compile_settings) {
+
+	if(info.Length() != 1) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[0]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[0]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	info.GetReturnValue().Set(CompiledSettings::NewInstance(info.GetIsolate(), settings.value(),
+	                                                        convert_settings.value()));
+}
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+[[nodiscard]] static v8::Local<v8::Number> elapsed_ns_to_js(BenchmarkClock::time_point start,
+                                                            BenchmarkClock::time_point end) {
+	auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+	return Nan::New<v8::Number>(static_cast<double>(elapsed.count()));
+}
+
+// times parse_ass_cpp and ass_parse_result_to_js separately, for the benchmarks, the cache is not
+// used, returns { parse_ns: number[], convert_ns: number[] }, one entry per iteration
+NAN_METHOD(benchmark_phases) {
+
+	if(info.Length() != 3) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[2]->IsUint32()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'iterations' argument needs to be a non negative integer"));
+		return;
+	}
+
+	auto source = get_ass_source_from_info(info[0]);
+
+	if(not source.has_value()) {
+		info.GetIsolate()->ThrowException(source.error());
+		return;
+	}
+
+	auto settings = get_parse_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not settings.has_value()) {
+		info.GetIsolate()->ThrowException(settings.error());
+		return;
+	}
+
+	auto convert_settings = get_convert_settings_from_info(info.GetIsolate(), info[1]);
+
+	if(not convert_settings.has_value()) {
+		info.GetIsolate()->ThrowException(convert_settings.error());
+		return;
+	}
+
+	auto iterations = Nan::To<uint32_t>(info[2]).FromJust();
+
+	v8::Local<v8::Array> parse_ns = Nan::New<v8::Array>(iterations);
+	v8::Local<v8::Array> convert_ns = Nan::New<v8::Array>(iterations);
+
+	for(uint32_t i = 0; i < iterations; ++i) {
+		auto parse_start = BenchmarkClock::now();
+
+		std::shared_ptr<AssParseResultCpp> parsed =
+		    parse_ass_cpp(source.value(), settings.value(), nullptr);
+
+		auto parse_end = BenchmarkClock::now();
+
+		{
+			// the converted result is thrown away after every iteration
+			Nan::HandleScope scope;
+
+			auto convert_start = BenchmarkClock::now();
+
+			auto result = ass_parse_result_to_js(info.GetIsolate(), std::move(parsed),
+			                                     convert_settings.value(), nullptr, nullptr);
+
+			auto convert_end = BenchmarkClock::now();
+
+			UNUSED(result);
 
-	auto result = ass_parse_result_to_js(info.GetIsolate(), std::move(parsed));
+			Nan::Set(convert_ns, i, elapsed_ns_to_js(convert_start, convert_end));
+		}
+
+		Nan::Set(parse_ns, i, elapsed_ns_to_js(parse_start, parse_end));
+	}
+
+	v8::Local<v8::Object> result = Nan::New<v8::Object>();
+
+	Nan::Set(result, Nan::New("parse_ns").ToLocalChecked(), parse_ns);
+	Nan::Set(result, Nan::New("convert_ns").ToLocalChecked(), convert_ns);
+
+	info.GetReturnValue().Set(result);
+}
+
+// options: { enabled: boolean, max_bytes: number }
+NAN_METHOD(cache_configure) {
+
+	if(info.Length() != 1) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("Wrong number of arguments"));
+		return;
+	}
+
+	if(!info[0]->IsObject()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'options' argument needs to be an object"));
+		return;
+	}
+
+	auto options = info[0]->ToObject(Nan::GetCurrentContext()).ToLocalChecked();
+
+	auto enabled_value = Nan::Get(options, Nan::New("enabled").ToLocalChecked()).ToLocalChecked();
+
+	if(!enabled_value->IsBoolean()) {
+		info.GetIsolate()->ThrowException(Nan::TypeError("options.enabled needs to be a boolean"));
+		return;
+	}
+
+	auto max_bytes_value =
+	    Nan::Get(options, Nan::New("max_bytes").ToLocalChecked()).ToLocalChecked();
+
+	if(!max_bytes_value->IsNumber() || Nan::To<double>(max_bytes_value).FromJust() < 0) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("options.max_bytes needs to be a non negative number"));
+		return;
+	}
+
+	auto enabled = Nan::To<bool>(enabled_value).FromJust();
+
+	auto max_bytes = static_cast<size_t>(Nan::To<double>(max_bytes_value).FromJust());
+
+	ParseCache::instance().configure(enabled, max_bytes);
+}
+
+NAN_METHOD(cache_stats) {
+
+	auto stats = ParseCache::instance().stats();
+
+	v8::Local<v8::Object> result = Nan::New<v8::Object>();
+
+	Nan::Set(result, Nan::New("enabled").ToLocalChecked(), Nan::New<v8::Boolean>(stats.enabled));
+	Nan::Set(result, Nan::New("max_bytes").ToLocalChecked(),
+	         Nan::New<v8::Number>(static_cast<double>(stats.max_bytes)));
+	Nan::Set(result, Nan::New("bytes").ToLocalChecked(),
+	         Nan::New<v8::Number>(static_cast<double>(stats.bytes)));
+	Nan::Set(result, Nan::New("entries").ToLocalChecked(),
+	         Nan::New<v8::Number>(static_cast<double>(stats.entries)));
+	Nan::Set(result, Nan::New("hits").ToLocalChecked(),
+	         Nan::New<v8::Number>(static_cast<double>(stats.hits)));
+	Nan::Set(result, Nan::New("misses").ToLocalChecked(),
+	         Nan::New<v8::Number>(static_cast<double>(stats.misses)));
+	Nan::Set(result, Nan::New("evictions").ToLocalChecked(),
+	         Nan::New<v8::Number>(static_cast<double>(stats.evictions)));
 
 	info.GetReturnValue().Set(result);
 }
 
+NAN_METHOD(cache_clear) {
+
+	UNUSED(info);
+
+	ParseCache::instance().clear();
+}
+
 NAN_MODULE_INIT(InitAll) {
+	LazyList::Init(target);
+	EventIndex::Init(target);
+	AssDocument::Init(target);
+	StreamParser::Init(target);
+	CompiledSettings::Init(target);
+
 	Nan::Set(target, Nan::New("parse_ass").ToLocalChecked(),
 	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(parse_ass)).ToLocalChecked());
 
+	Nan::Set(target, Nan::New("parse_ass_async").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(parse_ass_async)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("parse_ass_batch").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(parse_ass_batch)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("parse_ass_json").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(parse_ass_json)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("parse_ass_json_async").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(parse_ass_json_async))
+	             .ToLocalChecked());
+
+	Nan::Set(target, Nan::New("write_ass").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(write_ass)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("write_ass_async").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(write_ass_async)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("lint_ass").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(lint_ass)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("compile_settings").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(compile_settings)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("serialize_ass").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(serialize_ass)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("deserialize_ass").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(deserialize_ass)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("create_document").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(create_document)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("create_stream_parser").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(create_stream_parser))
+	             .ToLocalChecked());
+
+	Nan::Set(target, Nan::New("create_event_index").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(create_event_index))
+	             .ToLocalChecked());
+
+	Nan::Set(target, Nan::New("benchmark_phases").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(benchmark_phases)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("cache_configure").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(cache_configure)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("cache_stats").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(cache_stats)).ToLocalChecked());
+
+	Nan::Set(target, Nan::New("cache_clear").ToLocalChecked(),
+	         Nan::GetFunction(Nan::New<v8::FunctionTemplate>(cache_clear)).ToLocalChecked());
+
 	Nan::Set(target, Nan::New("version").ToLocalChecked(),
 	         Nan::New<v8::String>(ass_parser_lib_version()).ToLocalChecked());
 
@@ -42,4 +835,11 @@ NAN_MODULE_INIT(InitAll) {
 	         Nan::New<v8::String>(ass_parser_lib_commit_hash()).ToLocalChecked());
 }
 
-NODE_MODULE(AssParserWrapper, InitAll)
+// context aware, so that it can be loaded in multiple worker threads, this is what
+// NAN_MODULE_WORKER_ENABLED expands to, but without the unused parameter warnings
+NODE_MODULE_INIT() {
+	UNUSED(module);
+	UNUSED(context);
+
+	InitAll(exports);
+}
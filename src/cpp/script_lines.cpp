@@ -0,0 +1,104 @@
+#include "./script_lines.hpp"
+
+#include <algorithm>
+#include <array>
+
+[[nodiscard]] std::vector<std::string> split_lines(std::string_view text) {
+
+	std::vector<std::string> lines{};
+
+	while(true) {
+		size_t end = text.find('\n');
+
+		std::string_view line = text.substr(0, end);
+
+		if(line.ends_with('\r')) {
+			line.remove_suffix(1);
+		}
+
+		lines.emplace_back(line);
+
+		if(end == std::string_view::npos) {
+			return lines;
+		}
+
+		text.remove_prefix(end + 1);
+	}
+}
+
+[[nodiscard]] std::string_view trim_line(std::string_view line) {
+
+	size_t start = line.find_first_not_of(" \t");
+
+	if(start == std::string_view::npos) {
+		return {};
+	}
+
+	size_t end = line.find_last_not_of(" \t");
+
+	return line.substr(start, end - start + 1);
+}
+
+[[nodiscard]] bool is_section_header(std::string_view line) {
+	return trim_line(line).starts_with('[');
+}
+
+[[nodiscard]] bool is_script_info_header(std::string_view line) {
+	return trim_line(line) == "[Script Info]";
+}
+
+[[nodiscard]] bool is_events_header(std::string_view line) {
+	return trim_line(line) == "[Events]";
+}
+
+[[nodiscard]] bool is_styles_header(std::string_view line) {
+	std::string_view trimmed = trim_line(line);
+
+	return trimmed == "[V4+ Styles]" || trimmed == "[V4 Styles]";
+}
+
+[[nodiscard]] bool is_format_line(std::string_view line) {
+	return trim_line(line).starts_with("Format:");
+}
+
+[[nodiscard]] bool is_event_line(std::string_view line) {
+
+	static constexpr std::array<std::string_view, 6> event_prefixes = {
+		"Dialogue:", "Comment:", "Picture:", "Sound:", "Movie:", "Command:",
+	};
+
+	std::string_view trimmed = trim_line(line);
+
+	return std::ranges::any_of(event_prefixes, [trimmed](std::string_view prefix) {
+		return trimmed.starts_with(prefix);
+	});
+}
+
+[[nodiscard]] std::string join_lines(std::span<const std::string> lines) {
+
+	std::string text{};
+
+	for(size_t i = 0; i < lines.size(); ++i) {
+		if(i != 0) {
+			text.push_back('\n');
+		}
+
+		text.append(lines[i]);
+	}
+
+	return text;
+}
+
+[[nodiscard]] size_t count_event_lines(std::span<const std::string> lines) {
+	return static_cast<size_t>(
+	    std::ranges::count_if(lines, [](const std::string& line) { return is_event_line(line); }));
+}
+
+[[nodiscard]] ParseSettings part_parse_settings(ParseSettings settings) {
+
+	settings.validate_settings.validate_styles = false;
+	settings.validate_settings.font_settings.preset =
+	    static_cast<FontPreset>(parse_font_preset("disabled"));
+
+	return settings;
+}
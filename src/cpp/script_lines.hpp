@@ -0,0 +1,40 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ass_parser_lib.h>
+
+// helpers for the parts of the parser, that work on the lines of a script before parsing them
+// (the document and the stream parser), lines never contain line breaks
+
+// splits at '\n', a '\r' before it is removed as well
+[[nodiscard]] std::vector<std::string> split_lines(std::string_view text);
+
+// joins with '\n'
+[[nodiscard]] std::string join_lines(std::span<const std::string> lines);
+
+// without leading and trailing spaces and tabs
+[[nodiscard]] std::string_view trim_line(std::string_view line);
+
+[[nodiscard]] bool is_section_header(std::string_view line);
+
+[[nodiscard]] bool is_script_info_header(std::string_view line);
+
+[[nodiscard]] bool is_events_header(std::string_view line);
+
+[[nodiscard]] bool is_styles_header(std::string_view line);
+
+[[nodiscard]] bool is_format_line(std::string_view line);
+
+// every event line is one entry of AssEvents
+[[nodiscard]] bool is_event_line(std::string_view line);
+
+[[nodiscard]] size_t count_event_lines(std::span<const std::string> lines);
+
+// for parsing some lines behind the header of a script (everything up to the Format line of the
+// [Events] section), that was already parsed and validated, so the styles and their fonts are not
+// validated again
+[[nodiscard]] ParseSettings part_parse_settings(ParseSettings settings);
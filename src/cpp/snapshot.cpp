@@ -0,0 +1,859 @@
+#include "./snapshot.hpp"
+#include "./string_converter.hpp"
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stb/ds.h>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+// records, these are copied from and to the snapshot as they are, so every padding byte is an
+// explicit field, that is always zero
+
+static constexpr std::array<char, 8> snapshot_magic = { 'A', 'S', 'S', 'S', 'N', 'A', 'P', '\0' };
+
+// written as is, so it reads differently on a machine with another byte order
+static constexpr uint32_t snapshot_byte_order_mark = 0x01020304;
+
+struct SnapshotBlock {
+	uint64_t offset;
+	uint64_t count;
+};
+
+struct SnapshotHeader {
+	std::array<char, 8> magic;
+	uint32_t version;
+	uint32_t byte_order;
+	uint32_t line_type;
+	uint32_t file_type;
+	SnapshotBlock script_info;
+	SnapshotBlock styles;
+	SnapshotBlock events;
+	SnapshotBlock diagnostics;
+	SnapshotBlock extra_sections;
+	SnapshotBlock extra_fields;
+	// count is the size in bytes
+	SnapshotBlock strings;
+};
+
+// an offset into the string table and a length in bytes
+struct SnapshotStr {
+	uint32_t offset;
+	uint32_t length;
+};
+
+struct SnapshotTime {
+	uint8_t hour;
+	uint8_t min;
+	uint8_t sec;
+	uint8_t hundred;
+};
+
+struct SnapshotColor {
+	uint8_t r;
+	uint8_t g;
+	uint8_t b;
+	uint8_t a;
+};
+
+struct SnapshotScriptInfo {
+	SnapshotStr title;
+	SnapshotStr original_script;
+	SnapshotStr original_translation;
+	SnapshotStr original_editing;
+	SnapshotStr original_timing;
+	SnapshotStr synch_point;
+	SnapshotStr script_updated_by;
+	SnapshotStr update_details;
+	SnapshotStr collisions;
+	SnapshotStr play_depth;
+	SnapshotStr timer;
+	SnapshotStr ycbcr_matrix;
+	uint64_t play_res_y;
+	uint64_t play_res_x;
+	uint64_t video_aspect_ratio;
+	uint64_t video_zoom;
+	uint32_t script_type;
+	uint32_t wrap_style;
+	uint8_t scaled_border_and_shadow;
+	std::array<uint8_t, 7> reserved;
+};
+
+struct SnapshotStyle {
+	SnapshotStr name;
+	SnapshotStr fontname;
+	uint64_t fontsize;
+	uint64_t scale_x;
+	uint64_t scale_y;
+	uint64_t margin_l;
+	uint64_t margin_r;
+	uint64_t margin_v;
+	uint64_t encoding;
+	double spacing;
+	double angle;
+	double outline;
+	double shadow;
+	SnapshotColor primary_colour;
+	SnapshotColor secondary_colour;
+	SnapshotColor outline_colour;
+	SnapshotColor back_colour;
+	uint32_t border_style;
+	uint32_t alignment;
+	uint8_t bold;
+	uint8_t italic;
+	uint8_t underline;
+	uint8_t strike_out;
+	std::array<uint8_t, 4> reserved;
+};
+
+// bits of SnapshotEvent::default_margins
+static constexpr uint8_t snapshot_margin_l_default = 1U << 0U;
+static constexpr uint8_t snapshot_margin_r_default = 1U << 1U;
+static constexpr uint8_t snapshot_margin_v_default = 1U << 2U;
+
+struct SnapshotEvent {
+	uint64_t layer;
+	// the value of default margins is 0
+	uint64_t margin_l;
+	uint64_t margin_r;
+	uint64_t margin_v;
+	SnapshotStr style;
+	SnapshotStr name;
+	SnapshotStr effect;
+	SnapshotStr text;
+	SnapshotTime start;
+	SnapshotTime end;
+	uint32_t type;
+	uint8_t default_margins;
+	std::array<uint8_t, 3> reserved;
+};
+
+struct SnapshotDiagnosticRecord {
+	SnapshotStr message;
+	uint64_t line;
+	uint64_t column;
+	uint32_t severity;
+	uint8_t has_position;
+	std::array<uint8_t, 3> reserved;
+};
+
+struct SnapshotSection {
+	SnapshotStr name;
+	uint64_t first_field;
+	uint64_t field_count;
+};
+
+struct SnapshotField {
+	SnapshotStr key;
+	SnapshotStr value;
+};
+
+// the layout is part of the format, changing any of these requires a new snapshot_version
+static_assert(sizeof(SnapshotHeader) == 136);
+static_assert(sizeof(SnapshotScriptInfo) == 144);
+static_assert(sizeof(SnapshotStyle) == 136);
+static_assert(sizeof(SnapshotEvent) == 80);
+static_assert(sizeof(SnapshotDiagnosticRecord) == 32);
+static_assert(sizeof(SnapshotSection) == 24);
+static_assert(sizeof(SnapshotField) == 16);
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader> &&
+              std::is_trivially_copyable_v<SnapshotScriptInfo> &&
+              std::is_trivially_copyable_v<SnapshotStyle> &&
+              std::is_trivially_copyable_v<SnapshotEvent> &&
+              std::is_trivially_copyable_v<SnapshotDiagnosticRecord> &&
+              std::is_trivially_copyable_v<SnapshotSection> &&
+              std::is_trivially_copyable_v<SnapshotField>);
+
+static constexpr size_t snapshot_alignment = 8;
+
+[[nodiscard]] static size_t align_snapshot_offset(size_t offset) {
+	return (offset + snapshot_alignment - 1) & ~(snapshot_alignment - 1);
+}
+
+// writing
+
+// the string table, values of FinalStr slices are deduplicated by their raw bytes, which stay
+// valid while writing
+struct SnapshotStringTable {
+  private:
+	const StringConverter& m_strings;
+	std::string m_data;
+	std::unordered_map<std::string_view, SnapshotStr> m_offsets;
+
+  public:
+	explicit SnapshotStringTable(const StringConverter& strings)
+	    : m_strings{ strings }, m_data{}, m_offsets{} {}
+
+	[[nodiscard]] SnapshotStr add(const FinalStr& str) {
+
+		if(str.length == 0 || str.start == nullptr) {
+			return SnapshotStr{ .offset = 0, .length = 0 };
+		}
+
+		std::string_view raw{ str.start, str.length };
+
+		auto iter = m_offsets.find(raw);
+
+		if(iter != m_offsets.end()) {
+			return iter->second;
+		}
+
+		size_t offset = m_data.size();
+
+		m_strings.append_utf8(m_data, str);
+
+		SnapshotStr result = { .offset = static_cast<uint32_t>(offset),
+			                   .length = static_cast<uint32_t>(m_data.size() - offset) };
+
+		m_offsets.emplace(raw, result);
+
+		return result;
+	}
+
+	// for values, that are already UTF-8 and that don't outlive the call (e.g. messages)
+	[[nodiscard]] SnapshotStr add_utf8(std::string_view value) {
+
+		size_t offset = m_data.size();
+
+		m_data.append(value);
+
+		return SnapshotStr{ .offset = static_cast<uint32_t>(offset),
+			                .length = static_cast<uint32_t>(value.size()) };
+	}
+
+	// offsets and lengths are 32 bit
+	[[nodiscard]] bool fits() const {
+		return m_data.size() <= std::numeric_limits<uint32_t>::max();
+	}
+
+	[[nodiscard]] const std::string& data() const { return m_data; }
+};
+
+[[nodiscard]] static SnapshotTime ass_time_to_snapshot(const AssTime& time) {
+	return SnapshotTime{
+		.hour = time.hour, .min = time.min, .sec = time.sec, .hundred = time.hundred
+	};
+}
+
+[[nodiscard]] static SnapshotColor ass_color_to_snapshot(const AssColor& color) {
+	return SnapshotColor{ .r = color.r, .g = color.g, .b = color.b, .a = color.a };
+}
+
+[[nodiscard]] static SnapshotScriptInfo script_info_to_snapshot(const AssScriptInfo& script_info,
+                                                                SnapshotStringTable& table) {
+	return SnapshotScriptInfo{
+		.title = table.add(script_info.title),
+		.original_script = table.add(script_info.original_script),
+		.original_translation = table.add(script_info.original_translation),
+		.original_editing = table.add(script_info.original_editing),
+		.original_timing = table.add(script_info.original_timing),
+		.synch_point = table.add(script_info.synch_point),
+		.script_updated_by = table.add(script_info.script_updated_by),
+		.update_details = table.add(script_info.update_details),
+		.collisions = table.add(script_info.collisions),
+		.play_depth = table.add(script_info.play_depth),
+		.timer = table.add(script_info.timer),
+		.ycbcr_matrix = table.add(script_info.ycbcr_matrix),
+		.play_res_y = script_info.play_res_y,
+		.play_res_x = script_info.play_res_x,
+		.video_aspect_ratio = script_info.video_aspect_ratio,
+		.video_zoom = script_info.video_zoom,
+		.script_type = static_cast<uint32_t>(script_info.script_type),
+		.wrap_style = static_cast<uint32_t>(script_info.wrap_style),
+		.scaled_border_and_shadow = static_cast<uint8_t>(script_info.scaled_border_and_shadow),
+		.reserved = {},
+	};
+}
+
+[[nodiscard]] static SnapshotStyle style_to_snapshot(const AssStyleEntry& style,
+                                                     SnapshotStringTable& table) {
+	return SnapshotStyle{
+		.name = table.add(style.name),
+		.fontname = table.add(style.fontname),
+		.fontsize = style.fontsize,
+		.scale_x = style.scale_x,
+		.scale_y = style.scale_y,
+		.margin_l = style.margin_l,
+		.margin_r = style.margin_r,
+		.margin_v = style.margin_v,
+		.encoding = style.encoding,
+		.spacing = style.spacing,
+		.angle = style.angle,
+		.outline = style.outline,
+		.shadow = style.shadow,
+		.primary_colour = ass_color_to_snapshot(style.primary_colour),
+		.secondary_colour = ass_color_to_snapshot(style.secondary_colour),
+		.outline_colour = ass_color_to_snapshot(style.outline_colour),
+		.back_colour = ass_color_to_snapshot(style.back_colour),
+		.border_style = static_cast<uint32_t>(style.border_style),
+		.alignment = static_cast<uint32_t>(style.alignment),
+		.bold = static_cast<uint8_t>(style.bold),
+		.italic = static_cast<uint8_t>(style.italic),
+		.underline = static_cast<uint8_t>(style.underline),
+		.strike_out = static_cast<uint8_t>(style.strike_out),
+		.reserved = {},
+	};
+}
+
+[[nodiscard]] static uint64_t margin_to_snapshot(const MarginValue& value, uint8_t default_bit,
+                                                 uint8_t& default_margins) {
+	if(value.is_default) {
+		default_margins |= default_bit;
+		return 0;
+	}
+
+	return value.data.value;
+}
+
+[[nodiscard]] static SnapshotEvent event_to_snapshot(const AssEventEntry& event,
+                                                     SnapshotStringTable& table) {
+
+	uint8_t default_margins = 0;
+
+	SnapshotEvent result{
+		.layer = event.layer,
+		.margin_l =
+		    margin_to_snapshot(event.margin_l, snapshot_margin_l_default, default_margins),
+		.margin_r =
+		    margin_to_snapshot(event.margin_r, snapshot_margin_r_default, default_margins),
+		.margin_v =
+		    margin_to_snapshot(event.margin_v, snapshot_margin_v_default, default_margins),
+		.style = table.add(event.style),
+		.name = table.add(event.name),
+		.effect = table.add(event.effect),
+		.text = table.add(event.text),
+		.start = ass_time_to_snapshot(event.start),
+		.end = ass_time_to_snapshot(event.end),
+		.type = static_cast<uint32_t>(event.type),
+		.default_margins = 0,
+		.reserved = {},
+	};
+
+	result.default_margins = default_margins;
+
+	return result;
+}
+
+[[nodiscard]] static SnapshotDiagnosticRecord
+diagnostic_to_snapshot(const DiagnosticEntry& diagnostic, SnapshotStringTable& table) {
+
+	MessageStruct message = get_message_from_entry(diagnostic);
+
+	auto message_str = table.add_utf8(message.message);
+
+	free_message_struct(message);
+
+	bool has_position = !is_empty_pos(diagnostic.position);
+
+	return SnapshotDiagnosticRecord{
+		.message = message_str,
+		.line = has_position ? diagnostic.position.line : 0,
+		.column = has_position ? diagnostic.position.column : 0,
+		.severity = static_cast<uint32_t>(diagnostic.severity),
+		.has_position = static_cast<uint8_t>(has_position),
+		.reserved = {},
+	};
+}
+
+template <typename T> static void append_records(std::string& out, const std::vector<T>& records) {
+	out.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(T));
+}
+
+// appends the block, 8 byte aligned and returns its position
+[[nodiscard]] static SnapshotBlock append_block(std::string& out, const char* data, size_t size,
+                                                uint64_t count) {
+
+	out.resize(align_snapshot_offset(out.size()), '\0');
+
+	SnapshotBlock block = { .offset = out.size(), .count = count };
+
+	out.append(data, size);
+
+	return block;
+}
+
+template <typename T>
+[[nodiscard]] static SnapshotBlock append_block(std::string& out, const std::vector<T>& records) {
+	return append_block(out, reinterpret_cast<const char*>(records.data()),
+	                    records.size() * sizeof(T), records.size());
+}
+
+[[nodiscard]] std::expected<std::string, std::string>
+write_snapshot(const AssResult& result, const Diagnostics& diagnostics) {
+
+	// only used for append_utf8, so it never creates js strings
+	StringConverter strings{ result.file_props.file_type, nullptr };
+
+	SnapshotStringTable table{ strings };
+
+	std::vector<SnapshotScriptInfo> script_info{ script_info_to_snapshot(result.script_info,
+		                                                                 table) };
+
+	std::vector<SnapshotStyle> styles{};
+	styles.reserve(ZVEC_LENGTH(result.styles.entries));
+
+	for(size_t i = 0; i < ZVEC_LENGTH(result.styles.entries); ++i) {
+		styles.push_back(style_to_snapshot(result.styles.entries[i], table));
+	}
+
+	std::vector<SnapshotEvent> events{};
+	events.reserve(ZVEC_LENGTH(result.events.entries));
+
+	for(size_t i = 0; i < ZVEC_LENGTH(result.events.entries); ++i) {
+		events.push_back(event_to_snapshot(result.events.entries[i], table));
+	}
+
+	std::vector<SnapshotDiagnosticRecord> diagnostic_records{};
+	diagnostic_records.reserve(ZVEC_LENGTH(diagnostics.entries));
+
+	for(size_t i = 0; i < ZVEC_LENGTH(diagnostics.entries); ++i) {
+		diagnostic_records.push_back(diagnostic_to_snapshot(diagnostics.entries[i], table));
+	}
+
+	std::vector<SnapshotSection> sections{};
+	std::vector<SnapshotField> fields{};
+
+	size_t sections_length = ZMAP_FOREACH_TODO(result.extra_sections.entries);
+
+	for(size_t i = 0; i < sections_length; ++i) {
+		const ExtraSectionHashMapEntry& section = result.extra_sections.entries[i];
+
+		size_t first_field = fields.size();
+
+		size_t fields_length = ZMAP_FOREACH_TODO(section.value.fields);
+
+		for(size_t j = 0; j < fields_length; ++j) {
+			const SectionFieldEntry& field = section.value.fields[j];
+
+			fields.push_back(SnapshotField{ .key = table.add_utf8(field.key),
+			                                .value = table.add(field.value) });
+		}
+
+		sections.push_back(SnapshotSection{ .name = table.add_utf8(section.key),
+		                                     .first_field = first_field,
+		                                     .field_count = fields.size() - first_field });
+	}
+
+	if(!table.fits()) {
+		return std::unexpected{ "the strings of the result exceed the 4 GiB limit of snapshots" };
+	}
+
+	std::string out{};
+	out.resize(sizeof(SnapshotHeader), '\0');
+
+	SnapshotHeader header{
+		.magic = snapshot_magic,
+		.version = snapshot_version,
+		.byte_order = snapshot_byte_order_mark,
+		.line_type = static_cast<uint32_t>(result.file_props.line_type),
+		.file_type = static_cast<uint32_t>(result.file_props.file_type),
+		.script_info = append_block(out, script_info),
+		.styles = append_block(out, styles),
+		.events = append_block(out, events),
+		.diagnostics = append_block(out, diagnostic_records),
+		.extra_sections = append_block(out, sections),
+		.extra_fields = append_block(out, fields),
+		.strings = append_block(out, table.data().data(), table.data().size(),
+		                        table.data().size()),
+	};
+
+	std::memcpy(out.data(), &header, sizeof(SnapshotHeader));
+
+	return { std::move(out) };
+}
+
+// reading
+
+[[nodiscard]] static bool is_valid_event_type(uint32_t value) {
+	switch(static_cast<EventType>(value)) {
+		case EventTypeDialogue:
+		case EventTypeComment:
+		case EventTypePicture:
+		case EventTypeSound:
+		case EventTypeMovie:
+		case EventTypeCommand: return true;
+		default: return false;
+	}
+}
+
+[[nodiscard]] static bool is_valid_script_type(uint32_t value) {
+	switch(static_cast<ScriptType>(value)) {
+		case ScriptTypeUnknown:
+		case ScriptTypeV4:
+		case ScriptTypeV4Plus: return true;
+		default: return false;
+	}
+}
+
+[[nodiscard]] static bool is_valid_severity(uint32_t value) {
+	switch(static_cast<DiagnosticSeverity>(value)) {
+		case DiagnosticSeverityError:
+		case DiagnosticSeverityWarning: return true;
+		default: return false;
+	}
+}
+
+[[nodiscard]] static bool is_valid_line_type(uint32_t value) {
+	switch(static_cast<LineType>(value)) {
+		case LineTypeCrLf:
+		case LineTypeLf:
+		case LineTypeCr: return true;
+		default: return false;
+	}
+}
+
+[[nodiscard]] static bool is_valid_file_type(uint32_t value) {
+	switch(static_cast<FileType>(value)) {
+		case FileTypeUnknown:
+		case FileTypeUtf8:
+		case FileTypeUtf16BE:
+		case FileTypeUtf16LE:
+		case FileTypeUtf32BE:
+		case FileTypeUtf32LE: return true;
+		default: return false;
+	}
+}
+
+struct SnapshotReader {
+  private:
+	const uint8_t* m_data;
+	size_t m_size;
+	const char* m_strings;
+	uint64_t m_strings_size;
+
+  public:
+	SnapshotReader(const uint8_t* data, size_t size)
+	    : m_data{ data }, m_size{ size }, m_strings{ nullptr }, m_strings_size{ 0 } {}
+
+	// checks, that count records of the given size fit into the snapshot at the block
+	[[nodiscard]] bool contains(const SnapshotBlock& block, size_t record_size) const {
+
+		if(block.offset > m_size || block.offset % snapshot_alignment != 0) {
+			return false;
+		}
+
+		return block.count <= (m_size - block.offset) / record_size;
+	}
+
+	void set_strings(const SnapshotBlock& block) {
+		m_strings = reinterpret_cast<const char*>(m_data + block.offset);
+		m_strings_size = block.count;
+	}
+
+	template <typename T> [[nodiscard]] T record(const SnapshotBlock& block, size_t index) const {
+		T value{};
+		std::memcpy(&value, m_data + block.offset + (index * sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	// nullopt, if the string is not inside of the string table
+	[[nodiscard]] std::optional<FinalStr> str(const SnapshotStr& str) const {
+
+		if(static_cast<uint64_t>(str.offset) + str.length > m_strings_size) {
+			return std::nullopt;
+		}
+
+		// the parser never writes through these, neither does the conversion
+		return FinalStr{ .start = const_cast<char*>(m_strings + str.offset), .length = str.length };
+	}
+};
+
+static constexpr const char* invalid_string_error = "a string is outside of the string table";
+
+[[nodiscard]] static AssTime snapshot_to_ass_time(const SnapshotTime& time) {
+	return AssTime{ .hour = time.hour, .min = time.min, .sec = time.sec, .hundred = time.hundred };
+}
+
+[[nodiscard]] static AssColor snapshot_to_ass_color(const SnapshotColor& color) {
+	return AssColor{ .r = color.r, .g = color.g, .b = color.b, .a = color.a };
+}
+
+[[nodiscard]] static MarginValue snapshot_to_margin(uint64_t value, uint8_t default_margins,
+                                                    uint8_t default_bit) {
+	MarginValue result{};
+
+	if((default_margins & default_bit) != 0) {
+		result.is_default = true;
+		return result;
+	}
+
+	result.is_default = false;
+	result.data.value = static_cast<size_t>(value);
+
+	return result;
+}
+
+[[nodiscard]] static std::expected<AssScriptInfo, std::string>
+snapshot_to_script_info(const SnapshotReader& reader, const SnapshotScriptInfo& record) {
+
+	if(!is_valid_script_type(record.script_type)) {
+		return std::unexpected{ "invalid script type" };
+	}
+
+	auto title = reader.str(record.title);
+	auto original_script = reader.str(record.original_script);
+	auto original_translation = reader.str(record.original_translation);
+	auto original_editing = reader.str(record.original_editing);
+	auto original_timing = reader.str(record.original_timing);
+	auto synch_point = reader.str(record.synch_point);
+	auto script_updated_by = reader.str(record.script_updated_by);
+	auto update_details = reader.str(record.update_details);
+	auto collisions = reader.str(record.collisions);
+	auto play_depth = reader.str(record.play_depth);
+	auto timer = reader.str(record.timer);
+	auto ycbcr_matrix = reader.str(record.ycbcr_matrix);
+
+	if(!title || !original_script || !original_translation || !original_editing ||
+	   !original_timing || !synch_point || !script_updated_by || !update_details || !collisions ||
+	   !play_depth || !timer || !ycbcr_matrix) {
+		return std::unexpected{ invalid_string_error };
+	}
+
+	AssScriptInfo script_info{};
+
+	script_info.title = title.value();
+	script_info.original_script = original_script.value();
+	script_info.original_translation = original_translation.value();
+	script_info.original_editing = original_editing.value();
+	script_info.original_timing = original_timing.value();
+	script_info.synch_point = synch_point.value();
+	script_info.script_updated_by = script_updated_by.value();
+	script_info.update_details = update_details.value();
+	script_info.script_type = static_cast<ScriptType>(record.script_type);
+	script_info.collisions = collisions.value();
+	script_info.play_res_y = static_cast<size_t>(record.play_res_y);
+	script_info.play_res_x = static_cast<size_t>(record.play_res_x);
+	script_info.play_depth = play_depth.value();
+	script_info.timer = timer.value();
+	script_info.wrap_style = static_cast<WrapStyle>(record.wrap_style);
+	script_info.scaled_border_and_shadow = record.scaled_border_and_shadow != 0;
+	script_info.video_aspect_ratio = static_cast<size_t>(record.video_aspect_ratio);
+	script_info.video_zoom = static_cast<size_t>(record.video_zoom);
+	script_info.ycbcr_matrix = ycbcr_matrix.value();
+
+	return { script_info };
+}
+
+[[nodiscard]] static std::expected<AssStyleEntry, std::string>
+snapshot_to_style(const SnapshotReader& reader, const SnapshotStyle& record) {
+
+	auto name = reader.str(record.name);
+	auto fontname = reader.str(record.fontname);
+
+	if(!name || !fontname) {
+		return std::unexpected{ invalid_string_error };
+	}
+
+	AssStyleEntry style{};
+
+	style.name = name.value();
+	style.fontname = fontname.value();
+	style.fontsize = static_cast<size_t>(record.fontsize);
+	style.primary_colour = snapshot_to_ass_color(record.primary_colour);
+	style.secondary_colour = snapshot_to_ass_color(record.secondary_colour);
+	style.outline_colour = snapshot_to_ass_color(record.outline_colour);
+	style.back_colour = snapshot_to_ass_color(record.back_colour);
+	style.bold = record.bold != 0;
+	style.italic = record.italic != 0;
+	style.underline = record.underline != 0;
+	style.strike_out = record.strike_out != 0;
+	style.scale_x = static_cast<size_t>(record.scale_x);
+	style.scale_y = static_cast<size_t>(record.scale_y);
+	style.spacing = record.spacing;
+	style.angle = record.angle;
+	style.border_style = static_cast<BorderStyle>(record.border_style);
+	style.outline = record.outline;
+	style.shadow = record.shadow;
+	style.alignment = static_cast<AssAlignment>(record.alignment);
+	style.margin_l = static_cast<size_t>(record.margin_l);
+	style.margin_r = static_cast<size_t>(record.margin_r);
+	style.margin_v = static_cast<size_t>(record.margin_v);
+	style.encoding = static_cast<size_t>(record.encoding);
+
+	return { style };
+}
+
+[[nodiscard]] static std::expected<AssEventEntry, std::string>
+snapshot_to_event(const SnapshotReader& reader, const SnapshotEvent& record) {
+
+	if(!is_valid_event_type(record.type)) {
+		return std::unexpected{ "invalid event type" };
+	}
+
+	auto style = reader.str(record.style);
+	auto name = reader.str(record.name);
+	auto effect = reader.str(record.effect);
+	auto text = reader.str(record.text);
+
+	if(!style || !name || !effect || !text) {
+		return std::unexpected{ invalid_string_error };
+	}
+
+	AssEventEntry event{};
+
+	event.type = static_cast<EventType>(record.type);
+	event.layer = static_cast<size_t>(record.layer);
+	event.start = snapshot_to_ass_time(record.start);
+	event.end = snapshot_to_ass_time(record.end);
+	event.style = style.value();
+	event.name = name.value();
+	event.margin_l =
+	    snapshot_to_margin(record.margin_l, record.default_margins, snapshot_margin_l_default);
+	event.margin_r =
+	    snapshot_to_margin(record.margin_r, record.default_margins, snapshot_margin_r_default);
+	event.margin_v =
+	    snapshot_to_margin(record.margin_v, record.default_margins, snapshot_margin_v_default);
+	event.effect = effect.value();
+	event.text = text.value();
+
+	return { event };
+}
+
+[[nodiscard]] std::expected<AssSnapshot, std::string> read_snapshot(const uint8_t* data,
+                                                                    size_t size) {
+
+	if(size < sizeof(SnapshotHeader)) {
+		return std::unexpected{ "the snapshot is too small" };
+	}
+
+	SnapshotHeader header{};
+	std::memcpy(&header, data, sizeof(SnapshotHeader));
+
+	if(header.magic != snapshot_magic) {
+		return std::unexpected{ "the data is not a snapshot" };
+	}
+
+	if(header.version != snapshot_version) {
+		return std::unexpected{ "unsupported snapshot version " + std::to_string(header.version) +
+			                    ", expected " + std::to_string(snapshot_version) };
+	}
+
+	if(header.byte_order != snapshot_byte_order_mark) {
+		return std::unexpected{ "the snapshot was written with a different byte order" };
+	}
+
+	if(!is_valid_line_type(header.line_type) || !is_valid_file_type(header.file_type)) {
+		return std::unexpected{ "invalid file props" };
+	}
+
+	SnapshotReader reader{ data, size };
+
+	if(header.script_info.count != 1 ||
+	   !reader.contains(header.script_info, sizeof(SnapshotScriptInfo)) ||
+	   !reader.contains(header.styles, sizeof(SnapshotStyle)) ||
+	   !reader.contains(header.events, sizeof(SnapshotEvent)) ||
+	   !reader.contains(header.diagnostics, sizeof(SnapshotDiagnosticRecord)) ||
+	   !reader.contains(header.extra_sections, sizeof(SnapshotSection)) ||
+	   !reader.contains(header.extra_fields, sizeof(SnapshotField)) ||
+	   !reader.contains(header.strings, 1)) {
+		return std::unexpected{ "a block is outside of the snapshot" };
+	}
+
+	reader.set_strings(header.strings);
+
+	AssSnapshot snapshot{};
+
+	snapshot.file_props = FileProps{ .line_type = static_cast<LineType>(header.line_type),
+		                             .file_type = static_cast<FileType>(header.file_type) };
+
+	auto script_info = snapshot_to_script_info(
+	    reader, reader.record<SnapshotScriptInfo>(header.script_info, 0));
+
+	if(not script_info.has_value()) {
+		return std::unexpected{ script_info.error() };
+	}
+
+	snapshot.script_info = script_info.value();
+
+	snapshot.styles.reserve(header.styles.count);
+
+	for(size_t i = 0; i < header.styles.count; ++i) {
+		auto style = snapshot_to_style(reader, reader.record<SnapshotStyle>(header.styles, i));
+
+		if(not style.has_value()) {
+			return std::unexpected{ style.error() };
+		}
+
+		snapshot.styles.push_back(style.value());
+	}
+
+	snapshot.events.reserve(header.events.count);
+
+	for(size_t i = 0; i < header.events.count; ++i) {
+		auto event = snapshot_to_event(reader, reader.record<SnapshotEvent>(header.events, i));
+
+		if(not event.has_value()) {
+			return std::unexpected{ event.error() };
+		}
+
+		snapshot.events.push_back(event.value());
+	}
+
+	snapshot.diagnostics.reserve(header.diagnostics.count);
+
+	for(size_t i = 0; i < header.diagnostics.count; ++i) {
+		auto record = reader.record<SnapshotDiagnosticRecord>(header.diagnostics, i);
+
+		auto message = reader.str(record.message);
+
+		if(not message.has_value()) {
+			return std::unexpected{ invalid_string_error };
+		}
+
+		if(!is_valid_severity(record.severity)) {
+			return std::unexpected{ "invalid diagnostic severity" };
+		}
+
+		snapshot.diagnostics.push_back(SnapshotDiagnostic{
+		    .message = message.value(),
+		    .severity = static_cast<DiagnosticSeverity>(record.severity),
+		    .has_position = record.has_position != 0,
+		    .position = FilePos{ .line = static_cast<size_t>(record.line),
+		                         .column = static_cast<size_t>(record.column) },
+		});
+	}
+
+	snapshot.extra_fields.reserve(header.extra_fields.count);
+
+	for(size_t i = 0; i < header.extra_fields.count; ++i) {
+		auto record = reader.record<SnapshotField>(header.extra_fields, i);
+
+		auto key = reader.str(record.key);
+		auto value = reader.str(record.value);
+
+		if(!key || !value) {
+			return std::unexpected{ invalid_string_error };
+		}
+
+		snapshot.extra_fields.push_back(
+		    SnapshotSectionField{ .key = key.value(), .value = value.value() });
+	}
+
+	snapshot.extra_sections.reserve(header.extra_sections.count);
+
+	for(size_t i = 0; i < header.extra_sections.count; ++i) {
+		auto record = reader.record<SnapshotSection>(header.extra_sections, i);
+
+		auto name = reader.str(record.name);
+
+		if(not name.has_value()) {
+			return std::unexpected{ invalid_string_error };
+		}
+
+		if(record.first_field > header.extra_fields.count ||
+		   record.field_count > header.extra_fields.count - record.first_field) {
+			return std::unexpected{ "the fields of an extra section are outside of the snapshot" };
+		}
+
+		snapshot.extra_sections.push_back(
+		    SnapshotExtraSection{ .name = name.value(),
+		                          .first_field = static_cast<size_t>(record.first_field),
+		                          .field_count = static_cast<size_t>(record.field_count) });
+	}
+
+	return { std::move(snapshot) };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <vector>
+
+#include <ass_parser_lib.h>
+
+// a versioned binary snapshot of a successful parse result (including its diagnostics), so that
+// a script can be parsed once and loaded somewhere else without parsing it again
+//
+// layout, every block starts 8 byte aligned, all offsets are from the start of the snapshot:
+// - header: magic, version, byte order, file props and offset + count of every block
+// - script info: one fixed width record
+// - styles, events, diagnostics, extra sections, extra section fields: fixed width records
+// - string table: the normalized UTF-8 data of every string, records reference it by offset and
+//   length, repeated values (e.g. the style of events) are only stored once
+//
+// the snapshot is written in the byte order of the machine, snapshots of a different byte order
+// or version are rejected
+
+inline constexpr uint32_t snapshot_version = 1;
+
+// the snapshot of the result and its diagnostics, an error if it exceeds the limits of the format
+[[nodiscard]] std::expected<std::string, std::string>
+write_snapshot(const AssResult& result, const Diagnostics& diagnostics);
+
+struct SnapshotDiagnostic {
+	FinalStr message;
+	DiagnosticSeverity severity;
+	bool has_position;
+	FilePos position;
+};
+
+struct SnapshotSectionField {
+	FinalStr key;
+	FinalStr value;
+};
+
+struct SnapshotExtraSection {
+	FinalStr name;
+	// into AssSnapshot::extra_fields
+	size_t first_field;
+	size_t field_count;
+};
+
+// the records of a snapshot, every FinalStr points into the snapshot data, so that has to outlive
+// this, the strings are already normalized UTF-8
+struct AssSnapshot {
+	std::vector<SnapshotDiagnostic> diagnostics;
+	AssScriptInfo script_info;
+	std::vector<AssStyleEntry> styles;
+	std::vector<AssEventEntry> events;
+	std::vector<SnapshotExtraSection> extra_sections;
+	std::vector<SnapshotSectionField> extra_fields;
+	FileProps file_props;
+};
+
+// validates the snapshot, the records are read in one pass, strings are not copied
+[[nodiscard]] std::expected<AssSnapshot, std::string> read_snapshot(const uint8_t* data,
+                                                                    size_t size);
@@ -0,0 +1,394 @@
+#include "./stream_parser.hpp"
+#include "./isolate_data.hpp"
+#include "./script_lines.hpp"
+
+#include <algorithm>
+
+StreamParserState::StreamParserState(ParseSettings settings, size_t batch_size)
+    : m_settings{ settings },
+      m_batch_size{ std::max<size_t>(batch_size, 1) },
+      m_phase{ Phase::Header },
+      m_pending{},
+      m_line_count{ 0 },
+      m_line_type{ LineTypeLf },
+      m_in_events_section{ false },
+      m_header{},
+      m_batch_prefix{},
+      m_batch_prefix_lines{ 0 },
+      m_header_result{ nullptr },
+      m_batch{},
+      m_batch_first_line{ 0 },
+      m_batch_events{ 0 },
+      m_trailing{},
+      m_trailing_first_line{ 0 } {}
+
+[[nodiscard]] std::shared_ptr<AssParseResultCpp>
+StreamParserState::parse_part(std::string_view prefix, std::span<const std::string> lines,
+                              const ParseSettings& settings) {
+
+	std::string text{ prefix };
+
+	if(!lines.empty()) {
+		text.push_back('\n');
+		text.append(join_lines(lines));
+	}
+
+	return parse_ass_cpp(StringSourceCpp{ .str = std::move(text) }, settings, nullptr);
+}
+
+bool StreamParserState::emit_part(StreamChunkKind kind, std::shared_ptr<AssParseResultCpp> result,
+                                  size_t prefix_lines, size_t first_stream_line,
+                                  std::vector<StreamChunk>& chunks) {
+
+	const bool is_error = std::holds_alternative<AssParseResultErrorCpp>(result->result());
+
+	chunks.push_back(StreamChunk{ .kind = is_error ? StreamChunkKind::Error : kind,
+	                              .result = std::move(result),
+	                              .message = {},
+	                              .first_line = prefix_lines,
+	                              .line_offset = first_stream_line - prefix_lines,
+	                              .line_type = m_line_type });
+
+	if(is_error) {
+		m_phase = Phase::Finished;
+	}
+
+	return !is_error;
+}
+
+void StreamParserState::parse_header(std::vector<StreamChunk>& chunks) {
+
+	m_header_result = parse_part(join_lines(m_header), {}, m_settings);
+
+	// the first line of the header is the first line of the stream
+	chunks.push_back(StreamChunk{ .kind = StreamChunkKind::Header,
+	                              .result = m_header_result,
+	                              .message = {},
+	                              .first_line = 0,
+	                              .line_offset = 0,
+	                              .line_type = m_line_type });
+
+	if(std::holds_alternative<AssParseResultErrorCpp>(m_header_result->result())) {
+		chunks.back().kind = StreamChunkKind::Error;
+		m_phase = Phase::Finished;
+		return;
+	}
+
+	// lines before the first section header (e.g. with a BOM) are kept as well
+	bool keep = true;
+	std::vector<std::string> prefix{};
+
+	for(const std::string& line : m_header) {
+		if(is_section_header(line)) {
+			keep = is_script_info_header(line) || is_styles_header(line) || is_events_header(line);
+		}
+
+		if(keep) {
+			prefix.push_back(line);
+		}
+	}
+
+	m_batch_prefix = join_lines(prefix);
+	m_batch_prefix_lines = prefix.size();
+
+	m_phase = Phase::Events;
+	m_batch_first_line = m_line_count;
+}
+
+void StreamParserState::flush_batch(std::vector<StreamChunk>& chunks) {
+
+	if(m_batch.empty()) {
+		return;
+	}
+
+	auto result = parse_part(m_batch_prefix, m_batch, part_parse_settings(m_settings));
+
+	emit_part(StreamChunkKind::Events, std::move(result), m_batch_prefix_lines, m_batch_first_line,
+	          chunks);
+
+	m_batch.clear();
+	m_batch_first_line = m_line_count;
+	m_batch_events = 0;
+}
+
+void StreamParserState::fail(std::string message, std::vector<StreamChunk>& chunks) {
+
+	chunks.push_back(StreamChunk{ .kind = StreamChunkKind::Error,
+	                              .result = nullptr,
+	                              .message = std::move(message),
+	                              .first_line = 0,
+	                              .line_offset = 0,
+	                              .line_type = m_line_type });
+
+	m_phase = Phase::Finished;
+}
+
+void StreamParserState::add_line(std::string line, std::vector<StreamChunk>& chunks) {
+
+	if(line.ends_with('\r')) {
+		line.pop_back();
+
+		if(m_line_count == 0) {
+			m_line_type = LineTypeCrLf;
+		}
+	}
+
+	if(m_line_count == 0 && (line.starts_with("\xFF\xFE") || line.starts_with("\xFE\xFF") ||
+	                         line.starts_with(std::string_view{ "\0\0\xFE\xFF", 4 }))) {
+		fail("the stream parser only supports UTF-8 scripts", chunks);
+		return;
+	}
+
+	const size_t line_index = m_line_count++;
+
+	switch(m_phase) {
+		case Phase::Header: {
+			if(is_section_header(line)) {
+				m_in_events_section = is_events_header(line);
+			} else if(m_in_events_section && is_event_line(line)) {
+				fail("the [Events] section needs a Format line before the first event", chunks);
+				return;
+			}
+
+			const bool is_events_format = m_in_events_section && is_format_line(line);
+
+			m_header.push_back(std::move(line));
+
+			if(is_events_format) {
+				parse_header(chunks);
+			}
+
+			return;
+		}
+		case Phase::Events: {
+			if(is_section_header(line)) {
+				flush_batch(chunks);
+
+				if(m_phase == Phase::Finished) {
+					return;
+				}
+
+				m_phase = Phase::Trailing;
+				m_trailing_first_line = line_index;
+				break;
+			}
+
+			if(is_event_line(line)) {
+				++m_batch_events;
+			}
+
+			m_batch.push_back(std::move(line));
+
+			if(m_batch_events >= m_batch_size) {
+				flush_batch(chunks);
+			}
+
+			return;
+		}
+		case Phase::Trailing: break;
+		case Phase::Finished:
+		default: return;
+	}
+
+	// the header was already emitted, so it can't change anymore
+	if(is_events_header(line) || is_styles_header(line)) {
+		fail("the stream parser only supports scripts, that have one [Events] section after the "
+		     "styles",
+		     chunks);
+		return;
+	}
+
+	m_trailing.push_back(std::move(line));
+}
+
+[[nodiscard]] std::vector<StreamChunk> StreamParserState::feed(std::span<const uint8_t> data) {
+
+	std::vector<StreamChunk> chunks{};
+
+	const auto* begin = reinterpret_cast<const char*>(data.data());
+	const auto* end = begin + data.size();
+
+	while(begin != end && m_phase != Phase::Finished) {
+		const auto* newline = std::find(begin, end, '\n');
+
+		m_pending.append(begin, newline);
+
+		if(newline == end) {
+			break;
+		}
+
+		add_line(std::move(m_pending), chunks);
+		m_pending.clear();
+
+		begin = newline + 1;
+	}
+
+	return chunks;
+}
+
+[[nodiscard]] std::vector<StreamChunk> StreamParserState::end() {
+
+	std::vector<StreamChunk> chunks{};
+
+	if(m_phase != Phase::Finished && !m_pending.empty()) {
+		add_line(std::move(m_pending), chunks);
+		m_pending.clear();
+	}
+
+	switch(m_phase) {
+		case Phase::Header: {
+			// there were no events to stream, so everything is parsed at once
+			auto result = parse_part(join_lines(m_header), {}, m_settings);
+
+			chunks.push_back(StreamChunk{ .kind = StreamChunkKind::Header,
+			                              .result = result,
+			                              .message = {},
+			                              .first_line = 0,
+			                              .line_offset = 0,
+			                              .line_type = m_line_type });
+
+			if(std::holds_alternative<AssParseResultErrorCpp>(result->result())) {
+				chunks.back().kind = StreamChunkKind::Error;
+				break;
+			}
+
+			// the diagnostics were all reported with the header
+			emit_part(StreamChunkKind::Events, result, m_header.size(), m_header.size(), chunks);
+			emit_part(StreamChunkKind::End, std::move(result), m_header.size(), m_header.size(),
+			          chunks);
+			break;
+		}
+		case Phase::Events: {
+			flush_batch(chunks);
+
+			if(m_phase == Phase::Finished) {
+				break;
+			}
+
+			emit_part(StreamChunkKind::End, m_header_result, m_header.size(), m_header.size(),
+			          chunks);
+			break;
+		}
+		case Phase::Trailing: {
+			// the whole header, so that the extra sections before the events are part of the result
+			auto result =
+			    parse_part(join_lines(m_header), m_trailing, part_parse_settings(m_settings));
+
+			emit_part(StreamChunkKind::End, std::move(result), m_header.size(),
+			          m_trailing_first_line, chunks);
+			break;
+		}
+		case Phase::Finished:
+		default: break;
+	}
+
+	m_phase = Phase::Finished;
+	m_header_result = nullptr;
+	m_batch_prefix.clear();
+	m_batch.clear();
+	m_trailing.clear();
+
+	return chunks;
+}
+
+[[nodiscard]] bool StreamParserState::finished() const {
+	return m_phase == Phase::Finished;
+}
+
+// js
+
+StreamParser::StreamParser()
+    : m_state{ nullptr },
+      m_convert_settings{ .result_mode = ResultMode::Eager,
+	                      .projection = {},
+	                      .formats = { .time = TimeFormat::Object, .color = ColorFormat::Object },
+	                      .external_strings = false,
+	                      .profile = false,
+	                      .event_index = false } {}
+
+[[nodiscard]] v8::Local<v8::Value>
+StreamParser::chunks_to_js(v8::Isolate* isolate, const std::vector<StreamChunk>& chunks) const {
+
+	std::vector<v8::Local<v8::Value>> values{};
+	values.reserve(chunks.size());
+
+	for(const StreamChunk& chunk : chunks) {
+		values.push_back(stream_chunk_to_js(isolate, chunk, m_convert_settings));
+	}
+
+	return v8::Array::New(isolate, values.data(), values.size());
+}
+
+NAN_MODULE_INIT(StreamParser::Init) {
+
+	UNUSED(target);
+
+	v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+	tpl->SetClassName(Nan::New("StreamParser").ToLocalChecked());
+	tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+	Nan::SetPrototypeMethod(tpl, "feed", Feed);
+	Nan::SetPrototypeMethod(tpl, "end", End);
+
+	// every isolate (e.g. of a worker thread) has its own constructor
+	auto* isolate = v8::Isolate::GetCurrent();
+
+	IsolateData::get(isolate).set_stream_parser_constructor(
+	    isolate, Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+[[nodiscard]] v8::Local<v8::Object>
+StreamParser::NewInstance(v8::Isolate* isolate, std::unique_ptr<StreamParserState> state,
+                          const ConvertSettings& convert_settings) {
+
+	v8::Local<v8::Function> cons = IsolateData::get(isolate).stream_parser_constructor(isolate);
+
+	v8::Local<v8::Object> instance = Nan::NewInstance(cons, 0, nullptr).ToLocalChecked();
+
+	auto* parser = Nan::ObjectWrap::Unwrap<StreamParser>(instance);
+
+	parser->m_state = std::move(state);
+	parser->m_convert_settings = convert_settings;
+
+	return instance;
+}
+
+NAN_METHOD(StreamParser::New) {
+
+	if(!info.IsConstructCall()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("StreamParser can only be created by the ass_parser"));
+		return;
+	}
+
+	auto* parser = new StreamParser();
+	parser->Wrap(info.This());
+
+	info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(StreamParser::Feed) {
+
+	auto* parser = Nan::ObjectWrap::Unwrap<StreamParser>(info.Holder());
+
+	if(info.Length() != 1 || !info[0]->IsUint8Array()) {
+		info.GetIsolate()->ThrowException(
+		    Nan::TypeError("the 'chunk' argument needs to be a Uint8Array"));
+		return;
+	}
+
+	Nan::TypedArrayContents<uint8_t> contents{ info[0] };
+
+	auto chunks = parser->m_state->feed({ *contents, contents.length() });
+
+	info.GetReturnValue().Set(parser->chunks_to_js(info.GetIsolate(), chunks));
+}
+
+NAN_METHOD(StreamParser::End) {
+
+	auto* parser = Nan::ObjectWrap::Unwrap<StreamParser>(info.Holder());
+
+	auto chunks = parser->m_state->end();
+
+	info.GetReturnValue().Set(parser->chunks_to_js(info.GetIsolate(), chunks));
+}
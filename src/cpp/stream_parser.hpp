@@ -0,0 +1,123 @@
+#pragma once
+
+#include "./convert.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+enum class StreamChunkKind : uint8_t {
+	// script_info and styles, after the Format line of the [Events] section
+	Header,
+	// a batch of events
+	Events,
+	// extra_sections and file_props, after the stream ended
+	End,
+	// nothing else is emitted after it
+	Error,
+};
+
+// one part of the stream, that was parsed on its own, the lines of the parsed text from
+// first_line on are the lines of the stream from first_line + line_offset on, only their
+// diagnostics are reported (except for the Header and Error chunks, that report every diagnostic)
+struct StreamChunk {
+	StreamChunkKind kind;
+	// nullptr, if the error was found before parsing
+	std::shared_ptr<AssParseResultCpp> result;
+	// an error, that was found before parsing, e.g. an unsupported encoding
+	std::string message;
+	size_t first_line;
+	size_t line_offset;
+	// the text of parts is always joined with '\n', so this is the line type of the stream
+	LineType line_type;
+};
+
+// splits the bytes of a UTF-8 script into lines and parses them in parts: the header (everything
+// up to the Format line of the [Events] section) once, then every batch_size event lines behind
+// the script info and styles of the header and at last the sections after the events behind the
+// whole header, so only the header, one batch and the sections after the events are kept in memory
+struct StreamParserState {
+  private:
+	enum class Phase : uint8_t {
+		Header,
+		Events,
+		Trailing,
+		Finished,
+	};
+
+	ParseSettings m_settings;
+	size_t m_batch_size;
+	Phase m_phase;
+	// the bytes of the line, that is not terminated yet
+	std::string m_pending;
+	size_t m_line_count;
+	LineType m_line_type;
+	// in the header phase, the last section header was [Events]
+	bool m_in_events_section;
+	std::vector<std::string> m_header;
+	// the part of the header, that the events depend on ([Script Info], the styles and the
+	// [Events] section up to its Format line), without e.g. [Fonts] or [Graphics], joined once, so
+	// that every batch only parses this again
+	std::string m_batch_prefix;
+	size_t m_batch_prefix_lines;
+	// kept for the End chunk, if no section follows the events
+	std::shared_ptr<AssParseResultCpp> m_header_result;
+	std::vector<std::string> m_batch;
+	size_t m_batch_first_line;
+	size_t m_batch_events;
+	std::vector<std::string> m_trailing;
+	size_t m_trailing_first_line;
+
+	void add_line(std::string line, std::vector<StreamChunk>& chunks);
+
+	// parses the joined prefix lines together with the lines
+	[[nodiscard]] static std::shared_ptr<AssParseResultCpp>
+	parse_part(std::string_view prefix, std::span<const std::string> lines,
+	           const ParseSettings& settings);
+
+	// true, if parsing succeeded, prefix_lines is the number of lines before the ones of the part
+	bool emit_part(StreamChunkKind kind, std::shared_ptr<AssParseResultCpp> result,
+	               size_t prefix_lines, size_t first_stream_line, std::vector<StreamChunk>& chunks);
+
+	void parse_header(std::vector<StreamChunk>& chunks);
+
+	void flush_batch(std::vector<StreamChunk>& chunks);
+
+	void fail(std::string message, std::vector<StreamChunk>& chunks);
+
+  public:
+	StreamParserState(ParseSettings settings, size_t batch_size);
+
+	[[nodiscard]] std::vector<StreamChunk> feed(std::span<const uint8_t> data);
+
+	[[nodiscard]] std::vector<StreamChunk> end();
+
+	[[nodiscard]] bool finished() const;
+};
+
+// the js side of StreamParserState, feed and end return the converted chunks
+class StreamParser : public Nan::ObjectWrap {
+  private:
+	std::unique_ptr<StreamParserState> m_state;
+	ConvertSettings m_convert_settings;
+
+	StreamParser();
+
+	[[nodiscard]] v8::Local<v8::Value> chunks_to_js(v8::Isolate* isolate,
+	                                                const std::vector<StreamChunk>& chunks) const;
+
+	static NAN_METHOD(New);
+
+	static NAN_METHOD(Feed);
+
+	static NAN_METHOD(End);
+
+  public:
+	static NAN_MODULE_INIT(Init);
+
+	[[nodiscard]] static v8::Local<v8::Object> NewInstance(v8::Isolate* isolate,
+	                                                       std::unique_ptr<StreamParserState> state,
+	                                                       const ConvertSettings& convert_settings);
+};
@@ -0,0 +1,160 @@
+#include "./string_converter.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+// shorter strings are copied into the js heap, as that is cheaper than the external resource
+static constexpr size_t external_string_min_length = 64;
+
+// checks 8 bytes at a time, plain ASCII means, that no byte has the high bit set and that there
+// is no zero byte, which rules out UTF-16 and UTF-32 code units as well
+[[nodiscard]] static bool is_plain_ascii(const char* data, size_t length) {
+
+	constexpr uint64_t high_bits = 0x8080808080808080ULL;
+	constexpr uint64_t low_bits = 0x0101010101010101ULL;
+
+	size_t i = 0;
+
+	for(; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+		uint64_t value{};
+		std::memcpy(&value, data + i, sizeof(uint64_t));
+
+		// if no high bit is set, value - low_bits only sets a high bit in bytes, that were zero
+		if(((value | (value - low_bits)) & high_bits) != 0) {
+			return false;
+		}
+	}
+
+	for(; i < length; ++i) {
+		auto byte = static_cast<unsigned char>(data[i]);
+
+		if(byte == 0 || byte >= 0x80) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// the bytes are owned by the parse result, which is kept alive by the resource
+struct ParseResultExternalString : public v8::String::ExternalOneByteStringResource {
+  private:
+	std::shared_ptr<AssParseResultCpp> m_owner;
+	const char* m_data;
+	size_t m_length;
+
+  public:
+	ParseResultExternalString(std::shared_ptr<AssParseResultCpp> owner, const char* data,
+	                          size_t length)
+	    : m_owner{ std::move(owner) }, m_data{ data }, m_length{ length } {}
+
+	[[nodiscard]] const char* data() const override { return m_data; }
+
+	[[nodiscard]] size_t length() const override { return m_length; }
+};
+
+StringConverter::StringConverter(FileType file_type,
+                                 std::shared_ptr<AssParseResultCpp> external_owner)
+    : m_ascii_compatible{ file_type == FileTypeUtf8 || file_type == FileTypeUnknown },
+      m_normalized{ false },
+      m_external_owner{ std::move(external_owner) },
+      m_interned{},
+      m_created{ 0 } {}
+
+[[nodiscard]] StringConverter StringConverter::for_normalized_utf8() {
+	StringConverter result{ FileTypeUtf8, nullptr };
+	result.m_normalized = true;
+	return result;
+}
+
+[[nodiscard]] v8::Local<v8::String> StringConverter::convert(v8::Isolate* isolate,
+                                                             const FinalStr& str) {
+
+	if(str.length == 0 || str.start == nullptr) {
+		return Nan::EmptyString();
+	}
+
+	++m_created;
+
+	if(m_ascii_compatible && is_plain_ascii(str.start, str.length)) {
+		return v8::String::NewFromOneByte(isolate, reinterpret_cast<const uint8_t*>(str.start),
+		                                  v8::NewStringType::kNormal, static_cast<int>(str.length))
+		    .ToLocalChecked();
+	}
+
+	if(m_normalized) {
+		return v8::String::NewFromUtf8(isolate, str.start, v8::NewStringType::kNormal,
+		                               static_cast<int>(str.length))
+		    .ToLocalChecked();
+	}
+
+	char* value = get_normalized_string(str);
+
+	auto result = v8::String::NewFromUtf8(isolate, value, v8::NewStringType::kNormal,
+	                                      static_cast<int>(std::strlen(value)))
+	                  .ToLocalChecked();
+
+	free(value);
+
+	return result;
+}
+
+[[nodiscard]] v8::Local<v8::String> StringConverter::intern(v8::Isolate* isolate,
+                                                            const FinalStr& str) {
+
+	if(str.length == 0 || str.start == nullptr) {
+		return Nan::EmptyString();
+	}
+
+	std::string_view raw{ str.start, str.length };
+
+	auto iter = m_interned.find(raw);
+
+	if(iter != m_interned.end()) {
+		return iter->second;
+	}
+
+	auto result = convert(isolate, str);
+
+	m_interned.emplace(raw, result);
+
+	return result;
+}
+
+[[nodiscard]] v8::Local<v8::String> StringConverter::convert_large(v8::Isolate* isolate,
+                                                                   const FinalStr& str) {
+
+	if(m_external_owner == nullptr || str.length < external_string_min_length ||
+	   !m_ascii_compatible || !is_plain_ascii(str.start, str.length)) {
+		return convert(isolate, str);
+	}
+
+	++m_created;
+
+	// v8 takes ownership of the resource and disposes it, when the string is collected
+	auto* resource = new ParseResultExternalString(m_external_owner, str.start, str.length);
+
+	return v8::String::NewExternalOneByte(isolate, resource).ToLocalChecked();
+}
+
+[[nodiscard]] uint64_t StringConverter::created() const {
+	return m_created;
+}
+
+void StringConverter::append_utf8(std::string& out, const FinalStr& str) const {
+
+	if(str.length == 0 || str.start == nullptr) {
+		return;
+	}
+
+	if(m_normalized || (m_ascii_compatible && is_plain_ascii(str.start, str.length))) {
+		out.append(str.start, str.length);
+		return;
+	}
+
+	char* value = get_normalized_string(str);
+
+	out.append(value, std::strlen(value));
+
+	free(value);
+}
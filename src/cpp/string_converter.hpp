@@ -0,0 +1,62 @@
+#pragma once
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wtemplate-id-cdtor"
+#endif
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+#include <nan.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <ass_parser_lib.h>
+
+#include "./wrapper.hpp"
+
+// converts the FinalStr slices of one parse result to js strings, only lives as long as one
+// conversion (it holds local handles)
+struct StringConverter {
+  private:
+	// slices of ASCII compatible sources, that only contain ASCII, are already normalized and are
+	// used directly, without going through get_normalized_string
+	bool m_ascii_compatible;
+	// the slices are already normalized UTF-8 (e.g. of snapshots) and never need
+	// get_normalized_string
+	bool m_normalized;
+	// large ASCII slices become external strings, that point into the parse result and keep it
+	// alive, nullptr if that is disabled
+	std::shared_ptr<AssParseResultCpp> m_external_owner;
+	// keyed by the raw bytes, which stay valid for the whole conversion
+	std::unordered_map<std::string_view, v8::Local<v8::String>> m_interned;
+	// the number of js strings created so far, interned and empty strings are not counted
+	uint64_t m_created;
+
+  public:
+	StringConverter(FileType file_type, std::shared_ptr<AssParseResultCpp> external_owner);
+
+	[[nodiscard]] static StringConverter for_normalized_utf8();
+
+	[[nodiscard]] v8::Local<v8::String> convert(v8::Isolate* isolate, const FinalStr& str);
+
+	// for values, that repeat a lot (like the style, name and effect of events), every distinct
+	// value is only converted once
+	[[nodiscard]] v8::Local<v8::String> intern(v8::Isolate* isolate, const FinalStr& str);
+
+	// for large immutable values (like the text of events), these may be external strings
+	[[nodiscard]] v8::Local<v8::String> convert_large(v8::Isolate* isolate, const FinalStr& str);
+
+	[[nodiscard]] uint64_t created() const;
+
+	// appends the normalized UTF-8 value to out
+	void append_utf8(std::string& out, const FinalStr& str) const;
+};
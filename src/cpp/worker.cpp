@@ -0,0 +1,238 @@
+#include "./worker.hpp"
+#include "./ass_writer.hpp"
+#include "./json_writer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+ParseAssWorker::ParseAssWorker(Nan::Callback* callback, AssSourceCpp source,
+                               ParseSettings settings, ConvertSettings convert_settings)
+    : Nan::AsyncWorker{ callback, "ass_parser:ParseAssWorker" },
+      m_source{ std::move(source) },
+      m_settings{ settings },
+      m_convert_settings{ convert_settings },
+      m_result{ nullptr },
+      m_profile{},
+      m_event_index{ nullptr } {}
+
+void ParseAssWorker::Execute() {
+	m_result = ParseCache::instance().parse(m_source, m_settings,
+	                                        m_convert_settings.profile ? &m_profile : nullptr);
+
+	if(m_convert_settings.event_index) {
+		m_event_index = build_event_index(*m_result);
+	}
+}
+
+void ParseAssWorker::HandleOKCallback() {
+	Nan::HandleScope scope;
+
+	auto result = ass_parse_result_to_js(
+	    v8::Isolate::GetCurrent(), std::move(m_result), m_convert_settings,
+	    m_convert_settings.profile ? &m_profile : nullptr, std::move(m_event_index));
+
+	v8::Local<v8::Value> argv[] = { Nan::Null(), result };
+
+	callback->Call(2, argv, async_resource);
+}
+
+ParseJsonWorker::ParseJsonWorker(Nan::Callback* callback, AssSourceCpp source,
+                                 ParseSettings settings, ConvertSettings convert_settings)
+    : Nan::AsyncWorker{ callback, "ass_parser:ParseJsonWorker" },
+      m_source{ std::move(source) },
+      m_settings{ settings },
+      m_convert_settings{ convert_settings },
+      m_json{} {}
+
+void ParseJsonWorker::Execute() {
+	auto result = ParseCache::instance().parse(m_source, m_settings, nullptr);
+
+	m_json = write_json(*result, m_convert_settings);
+}
+
+void ParseJsonWorker::HandleOKCallback() {
+	Nan::HandleScope scope;
+
+	auto buffer = string_to_js_buffer(std::move(m_json));
+
+	if(not buffer.has_value()) {
+		v8::Local<v8::Value> argv[] = { buffer.error() };
+
+		callback->Call(1, argv, async_resource);
+		return;
+	}
+
+	v8::Local<v8::Value> argv[] = { Nan::Null(), buffer.value() };
+
+	callback->Call(2, argv, async_resource);
+}
+
+WriteAssWorker::WriteAssWorker(Nan::Callback* callback, int fd, std::string script)
+    : Nan::AsyncWorker{ callback, "ass_parser:WriteAssWorker" },
+      m_fd{ fd },
+      m_script{ std::move(script) },
+      m_written{ 0 } {}
+
+void WriteAssWorker::Execute() {
+	auto written = write_to_fd(m_fd, m_script);
+
+	if(not written.has_value()) {
+		SetErrorMessage(written.error().c_str());
+		return;
+	}
+
+	m_written = written.value();
+}
+
+void WriteAssWorker::HandleOKCallback() {
+	Nan::HandleScope scope;
+
+	v8::Local<v8::Value> argv[] = { Nan::Null(),
+		                            Nan::New<v8::Number>(static_cast<double>(m_written)) };
+
+	callback->Call(2, argv, async_resource);
+}
+
+BatchParseJob::BatchParseJob(Nan::Callback* callback,
+                             std::vector<std::optional<AssSourceCpp>> sources,
+                             v8::Local<v8::Value> js_sources, ParseSettings settings,
+                             ConvertSettings convert_settings, size_t concurrency)
+    : m_sources{ std::move(sources) },
+      m_settings{ settings },
+      m_convert_settings{ convert_settings },
+      m_concurrency{ concurrency == 0
+	                     ? std::max<size_t>(std::thread::hardware_concurrency(), 1)
+	                     : concurrency },
+      m_next{ 0 },
+      m_running{ 0 },
+      m_remaining{ 0 },
+      m_callback{ callback },
+      m_results{},
+      m_js_sources{} {
+
+	m_results.Reset(v8::Array::New(v8::Isolate::GetCurrent(),
+	                               static_cast<int>(m_sources.size())));
+	m_js_sources.Reset(js_sources);
+
+	m_remaining = static_cast<size_t>(std::count_if(
+	    m_sources.begin(), m_sources.end(), [](const auto& source) { return source.has_value(); }));
+}
+
+void BatchParseJob::set_source_error(size_t index, v8::Local<v8::Value> error) {
+	Nan::Set(Nan::New(m_results), static_cast<uint32_t>(index),
+	         error_to_ass_parse_result_js(v8::Isolate::GetCurrent(), error))
+	    .Check();
+}
+
+void BatchParseJob::start() {
+
+	if(m_remaining == 0) {
+		Nan::AsyncQueueWorker(new BatchItemWorker(this, std::nullopt));
+		return;
+	}
+
+	queue_items();
+}
+
+void BatchParseJob::queue_items() {
+
+	while(m_running < m_concurrency && m_next < m_sources.size()) {
+		const size_t index = m_next++;
+
+		if(not m_sources[index].has_value()) {
+			continue;
+		}
+
+		++m_running;
+		Nan::AsyncQueueWorker(new BatchItemWorker(this, index));
+	}
+}
+
+[[nodiscard]] const AssSourceCpp& BatchParseJob::source(size_t index) const {
+	return m_sources[index].value();
+}
+
+[[nodiscard]] const ParseSettings& BatchParseJob::settings() const {
+	return m_settings;
+}
+
+[[nodiscard]] const ConvertSettings& BatchParseJob::convert_settings() const {
+	return m_convert_settings;
+}
+
+void BatchParseJob::complete(size_t index, std::shared_ptr<AssParseResultCpp> result,
+                             ParseProfile* profile,
+                             std::shared_ptr<const EventIntervalIndex> event_index,
+                             Nan::AsyncResource* async_resource) {
+
+	Nan::Set(Nan::New(m_results), static_cast<uint32_t>(index),
+	         ass_parse_result_to_js(v8::Isolate::GetCurrent(), std::move(result),
+	                                m_convert_settings, profile, std::move(event_index)))
+	    .Check();
+
+	--m_running;
+	--m_remaining;
+
+	if(m_remaining == 0) {
+		finish(async_resource);
+		return;
+	}
+
+	queue_items();
+}
+
+void BatchParseJob::complete_empty(Nan::AsyncResource* async_resource) {
+	finish(async_resource);
+}
+
+void BatchParseJob::finish(Nan::AsyncResource* async_resource) {
+
+	v8::Local<v8::Value> argv[] = { Nan::Null(), Nan::New(m_results) };
+
+	m_results.Reset();
+	m_js_sources.Reset();
+
+	auto callback = std::move(m_callback);
+
+	delete this;
+
+	callback->Call(2, argv, async_resource);
+}
+
+BatchItemWorker::BatchItemWorker(BatchParseJob* job, std::optional<size_t> index)
+    : Nan::AsyncWorker{ nullptr, "ass_parser:BatchItemWorker" },
+      m_job{ job },
+      m_index{ index },
+      m_result{ nullptr },
+      m_profile{},
+      m_event_index{ nullptr } {}
+
+// only reads the job, which is not modified, while items are running
+void BatchItemWorker::Execute() {
+
+	if(not m_index.has_value()) {
+		return;
+	}
+
+	const ConvertSettings& convert_settings = m_job->convert_settings();
+
+	m_result = ParseCache::instance().parse(m_job->source(m_index.value()), m_job->settings(),
+	                                        convert_settings.profile ? &m_profile : nullptr);
+
+	if(convert_settings.event_index) {
+		m_event_index = build_event_index(*m_result);
+	}
+}
+
+void BatchItemWorker::HandleOKCallback() {
+	Nan::HandleScope scope;
+
+	if(not m_index.has_value()) {
+		m_job->complete_empty(async_resource);
+		return;
+	}
+
+	m_job->complete(m_index.value(), std::move(m_result),
+	                m_job->convert_settings().profile ? &m_profile : nullptr,
+	                std::move(m_event_index), async_resource);
+}
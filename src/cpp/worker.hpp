@@ -0,0 +1,144 @@
+#pragma once
+
+#include "./cache.hpp"
+#include "./convert.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+// runs parse_ass_cpp (reading, parsing and validating) and builds the event index on the libuv
+// threadpool, only the conversion to js happens on the main thread again
+struct ParseAssWorker : public Nan::AsyncWorker {
+  private:
+	AssSourceCpp m_source;
+	ParseSettings m_settings;
+	ConvertSettings m_convert_settings;
+	std::shared_ptr<AssParseResultCpp> m_result;
+	ParseProfile m_profile;
+	// only built, if m_convert_settings.event_index is set
+	std::shared_ptr<const EventIntervalIndex> m_event_index;
+
+  public:
+	ParseAssWorker(Nan::Callback* callback, AssSourceCpp source, ParseSettings settings,
+	               ConvertSettings convert_settings);
+
+	void Execute() override;
+
+  protected:
+	void HandleOKCallback() override;
+};
+
+// parses and writes the JSON of the result (see json_writer.hpp) on the libuv threadpool, the
+// main thread only wraps it in a Buffer
+struct ParseJsonWorker : public Nan::AsyncWorker {
+  private:
+	AssSourceCpp m_source;
+	ParseSettings m_settings;
+	ConvertSettings m_convert_settings;
+	std::string m_json;
+
+  public:
+	ParseJsonWorker(Nan::Callback* callback, AssSourceCpp source, ParseSettings settings,
+	                ConvertSettings convert_settings);
+
+	void Execute() override;
+
+  protected:
+	void HandleOKCallback() override;
+};
+
+// writes a script, that was written into memory on the main thread (reading the js result needs
+// the isolate), to a file descriptor on the libuv threadpool, so the blocking write(2) doesn't
+// stall the event loop
+struct WriteAssWorker : public Nan::AsyncWorker {
+  private:
+	int m_fd;
+	std::string m_script;
+	size_t m_written;
+
+  public:
+	WriteAssWorker(Nan::Callback* callback, int fd, std::string script);
+
+	void Execute() override;
+
+  protected:
+	void HandleOKCallback() override;
+};
+
+// parses many sources with the same settings, every source is its own work item on the libuv
+// threadpool, which is shared by every batch and bounded by UV_THREADPOOL_SIZE (4 by default), at
+// most concurrency items of one batch are queued at the same time, so no threads are created here
+// and a concurrency above the size of the pool only queues more items
+//
+// every result is converted to js as soon as its item is done, so the native results don't pile
+// up until the whole batch is finished, the results are reported in input order, sources that
+// failed validation are reported as error results, the job lives on the main thread and deletes
+// itself after the callback was called
+struct BatchParseJob {
+  private:
+	std::vector<std::optional<AssSourceCpp>> m_sources;
+	ParseSettings m_settings;
+	ConvertSettings m_convert_settings;
+	size_t m_concurrency;
+	// the next source to queue
+	size_t m_next;
+	size_t m_running;
+	// the sources, whose result is not in m_results yet
+	size_t m_remaining;
+	std::unique_ptr<Nan::Callback> m_callback;
+	Nan::Persistent<v8::Array> m_results;
+	// buffer sources are not copied, so they have to be kept alive until the job is done
+	Nan::Persistent<v8::Value> m_js_sources;
+
+	void queue_items();
+
+	void finish(Nan::AsyncResource* async_resource);
+
+  public:
+	BatchParseJob(Nan::Callback* callback, std::vector<std::optional<AssSourceCpp>> sources,
+	              v8::Local<v8::Value> js_sources, ParseSettings settings,
+	              ConvertSettings convert_settings, size_t concurrency);
+
+	BatchParseJob(const BatchParseJob& other) = delete;
+	BatchParseJob& operator=(const BatchParseJob& other) = delete;
+
+	// the error result of a source, that failed validation, only call this before start
+	void set_source_error(size_t index, v8::Local<v8::Value> error);
+
+	void start();
+
+	[[nodiscard]] const AssSourceCpp& source(size_t index) const;
+
+	[[nodiscard]] const ParseSettings& settings() const;
+
+	[[nodiscard]] const ConvertSettings& convert_settings() const;
+
+	// called on the main thread, when the item of the source at index is done
+	void complete(size_t index, std::shared_ptr<AssParseResultCpp> result, ParseProfile* profile,
+	              std::shared_ptr<const EventIntervalIndex> event_index,
+	              Nan::AsyncResource* async_resource);
+
+	// called on the main thread by the item, that is only queued for batches without any valid
+	// source, so that the callback is always called asynchronously
+	void complete_empty(Nan::AsyncResource* async_resource);
+};
+
+// parses one source of a BatchParseJob, see ParseAssWorker, nullopt as index means, that there is
+// nothing to parse
+struct BatchItemWorker : public Nan::AsyncWorker {
+  private:
+	BatchParseJob* m_job;
+	std::optional<size_t> m_index;
+	std::shared_ptr<AssParseResultCpp> m_result;
+	ParseProfile m_profile;
+	std::shared_ptr<const EventIntervalIndex> m_event_index;
+
+  public:
+	BatchItemWorker(BatchParseJob* job, std::optional<size_t> index);
+
+	void Execute() override;
+
+  protected:
+	void HandleOKCallback() override;
+};
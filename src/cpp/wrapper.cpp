@@ -1,6 +1,101 @@
 #include "./wrapper.hpp"
 
-AssParseResultCpp::AssParseResultCpp(AssParseResult* c_pointer) : m_c_value{ c_pointer } {}
+#include <filesystem>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(void* data, size_t size) : m_data{ data }, m_size{ size } {}
+
+[[nodiscard]] std::optional<MappedFile> MappedFile::map(const std::string& file) {
+#if defined(_WIN32)
+	UNUSED(file);
+	return std::nullopt;
+#else
+	int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if(fd < 0) {
+		return std::nullopt;
+	}
+
+	struct stat file_stat {};
+
+	if(fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size <= 0) {
+		close(fd);
+		return std::nullopt;
+	}
+
+	auto size = static_cast<size_t>(file_stat.st_size);
+
+	void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid after closing the file descriptor
+	close(fd);
+
+	if(data == MAP_FAILED) {
+		return std::nullopt;
+	}
+
+	madvise(data, size, MADV_SEQUENTIAL);
+
+	return MappedFile{ data, size };
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data{ other.m_data },
+      m_size{ other.m_size } {
+	other.m_data = nullptr;
+	other.m_size = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if(this != &other) {
+		unmap();
+
+		m_data = other.m_data;
+		m_size = other.m_size;
+		other.m_data = nullptr;
+		other.m_size = 0;
+	}
+
+	return *this;
+}
+
+MappedFile::~MappedFile() {
+	unmap();
+}
+
+void MappedFile::unmap() {
+#if !defined(_WIN32)
+	if(m_data != nullptr) {
+		munmap(m_data, m_size);
+	}
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
+
+[[nodiscard]] const void* MappedFile::data() const {
+	return m_data;
+}
+
+[[nodiscard]] size_t MappedFile::size() const {
+	return m_size;
+}
+
+AssParseResultCpp::AssParseResultCpp(AssParseResult* c_pointer)
+    : m_c_value{ c_pointer },
+      m_mapped_file{ std::nullopt } {}
+
+AssParseResultCpp::AssParseResultCpp(AssParseResult* c_pointer,
+                                     std::optional<MappedFile> mapped_file)
+    : m_c_value{ c_pointer },
+      m_mapped_file{ std::move(mapped_file) } {}
 
 AssParseResultCpp::~AssParseResultCpp() {
 	free_parse_result(m_c_value);
@@ -27,27 +122,93 @@ AssParseResultCpp::result() {
 	return AssParseResultOkCpp{ .result = parse_result_get_value(m_c_value) };
 }
 
-[[nodiscard]] std::unique_ptr<AssParseResultCpp> parse_ass_cpp(AssSourceCpp source,
-                                                               ParseSettings settings) {
+[[nodiscard]] uint64_t elapsed_ns(ProfileClock::time_point start, ProfileClock::time_point end) {
+	return static_cast<uint64_t>(
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// only used for profiling, the library reads file sources itself
+[[nodiscard]] static uint64_t file_size_or_zero(const std::string& file) {
+	std::error_code error{};
 
-	AssSourceCpp copy = source;
+	auto size = std::filesystem::file_size(file, error);
+
+	return error ? 0 : static_cast<uint64_t>(size);
+}
+
+[[nodiscard]] std::unique_ptr<AssParseResultCpp>
+parse_ass_cpp(const AssSourceCpp& source, ParseSettings settings, ParseProfile* profile) {
+
+	// moved into the result, so that it outlives it
+	std::optional<MappedFile> mapped_file = std::nullopt;
 
 	AssSource c_source = std::visit(
 	    helper::Overloaded{
-	        [](const FileSourceCpp& file_source) -> AssSource {
+	        [profile](const FileSourceCpp& file_source) -> AssSource {
+		        if(profile != nullptr) {
+			        profile->bytes_read = file_size_or_zero(file_source.file);
+		        }
+
 		        return { .type = AssSourceTypeFile, .data = { .file = file_source.file.c_str() } };
 	        },
-	        [](const StringSourceCpp& string_source) -> AssSource {
+	        [&mapped_file, profile](const MappedFileSourceCpp& mapped_source) -> AssSource {
+		        auto map_start =
+		            profile != nullptr ? ProfileClock::now() : ProfileClock::time_point{};
+
+		        mapped_file = MappedFile::map(mapped_source.file);
+
+		        if(profile != nullptr) {
+			        profile->read_ns = elapsed_ns(map_start, ProfileClock::now());
+		        }
+
+		        // let the parser read the file itself, so that errors get reported as usual
+		        if(not mapped_file.has_value()) {
+			        if(profile != nullptr) {
+				        profile->bytes_read = file_size_or_zero(mapped_source.file);
+			        }
+
+			        return { .type = AssSourceTypeFile,
+				             .data = { .file = mapped_source.file.c_str() } };
+		        }
+
+		        if(profile != nullptr) {
+			        profile->bytes_read = mapped_file->size();
+		        }
+
+		        SizedPtr str = { .data = const_cast<void*>(mapped_file->data()),
+			                     .len = mapped_file->size() };
+		        return { .type = AssSourceTypeStr, .data = { .str = str } };
+	        },
+	        [profile](const StringSourceCpp& string_source) -> AssSource {
+		        if(profile != nullptr) {
+			        profile->bytes_read = string_source.str.size();
+		        }
+
 		        SizedPtr str = { .data = (void*)string_source.str.c_str(),
 			                     .len = string_source.str.size() };
-		        return { .type = AssSourceTypeFile, .data = { .str = str } };
+		        return { .type = AssSourceTypeStr, .data = { .str = str } };
+	        },
+	        [profile](const BufferSourceCpp& buffer_source) -> AssSource {
+		        if(profile != nullptr) {
+			        profile->bytes_read = buffer_source.size;
+		        }
+
+		        SizedPtr str = { .data = (void*)buffer_source.data, .len = buffer_source.size };
+		        return { .type = AssSourceTypeStr, .data = { .str = str } };
 	        },
 	    },
-	    copy);
+	    source);
+
+	if(profile == nullptr) {
+		return std::make_unique<AssParseResultCpp>(parse_ass(c_source, settings),
+		                                           std::move(mapped_file));
+	}
+
+	auto parse_start = ProfileClock::now();
 
 	auto* result = parse_ass(c_source, settings);
 
-	auto final_result = std::make_unique<AssParseResultCpp>(result);
+	profile->parse_ns = elapsed_ns(parse_start, ProfileClock::now());
 
-	return final_result;
+	return std::make_unique<AssParseResultCpp>(result, std::move(mapped_file));
 }
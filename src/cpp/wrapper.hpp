@@ -1,7 +1,10 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <variant>
 
@@ -11,11 +14,25 @@ struct FileSourceCpp {
 	std::string file;
 };
 
+// like FileSourceCpp, but the parser works on a read-only mapping of the file instead of a heap
+// copy of it
+struct MappedFileSourceCpp {
+	std::string file;
+};
+
 struct StringSourceCpp {
 	std::string str;
 };
 
-using AssSourceCpp = std::variant<FileSourceCpp, StringSourceCpp>;
+// a non owning view into a js Uint8Array, the caller has to keep it alive (and not detach it)
+// until parsing finished
+struct BufferSourceCpp {
+	const uint8_t* data;
+	size_t size;
+};
+
+using AssSourceCpp =
+    std::variant<FileSourceCpp, MappedFileSourceCpp, StringSourceCpp, BufferSourceCpp>;
 
 using AssParseResultErrorCpp = std::monostate;
 
@@ -33,13 +50,42 @@ template <class... Ts> Overloaded(Ts...) -> Overloaded<Ts...>;
 
 #define UNUSED(v) ((void)(v))
 
+struct MappedFile {
+  private:
+	void* m_data;
+	size_t m_size;
+
+	MappedFile(void* data, size_t size);
+
+	void unmap();
+
+  public:
+	// returns nullopt, if the file can't be mapped (e.g. it doesn't exist or is empty)
+	[[nodiscard]] static std::optional<MappedFile> map(const std::string& file);
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile& other) = delete;
+	MappedFile& operator=(const MappedFile& other) = delete;
+
+	~MappedFile();
+
+	[[nodiscard]] const void* data() const;
+	[[nodiscard]] size_t size() const;
+};
+
 struct AssParseResultCpp {
   private:
 	AssParseResult* m_c_value;
+	// the mapping of mapped file sources, the slices of the result may point into it, so it is
+	// only unmapped after the result was freed
+	std::optional<MappedFile> m_mapped_file;
 
   public:
 	explicit AssParseResultCpp(AssParseResult* c_pointer);
 
+	AssParseResultCpp(AssParseResult* c_pointer, std::optional<MappedFile> mapped_file);
+
 	AssParseResultCpp operator=(const AssParseResultCpp& c_pointerresult) = delete;
 	AssParseResultCpp(const AssParseResultCpp& c_pointerresult) = delete;
 
@@ -49,5 +95,25 @@ struct AssParseResultCpp {
 	[[nodiscard]] std::variant<AssParseResultErrorCpp, AssParseResultOkCpp> result();
 };
 
-[[nodiscard]] std::unique_ptr<AssParseResultCpp> parse_ass_cpp(AssSourceCpp source,
-                                                               ParseSettings settings);
+using ProfileClock = std::chrono::steady_clock;
+
+[[nodiscard]] uint64_t elapsed_ns(ProfileClock::time_point start, ProfileClock::time_point end);
+
+// filled in while parsing and converting a single source, if settings.profile is set, all times
+// are in nanoseconds
+struct ParseProfile {
+	// mapping the file of mapped file sources, other files are read by the library in parse_ns
+	uint64_t read_ns;
+	// reading, detecting the encoding, parsing and validating, this all happens in parse_ass
+	uint64_t parse_ns;
+	uint64_t convert_ns;
+	uint64_t bytes_read;
+	// the number of js strings created by the conversion (not counting lazily converted entries)
+	uint64_t strings_created;
+	// the result came from the ParseCache, nothing was read or parsed
+	bool cached;
+};
+
+// profile may be nullptr, if it isn't requested
+[[nodiscard]] std::unique_ptr<AssParseResultCpp>
+parse_ass_cpp(const AssSourceCpp& source, ParseSettings settings, ParseProfile* profile);
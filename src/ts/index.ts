@@ -1,4 +1,6 @@
 import path from "path"
+import { Transform, type TransformCallback } from "stream"
+import { TextDecoder } from "util"
 
 const rootDir = path.join(
 	__dirname,
@@ -43,16 +45,60 @@ export interface ValidateSettings {
 	validate_text: boolean
 }
 
-export interface ParseSettings {
+// "eager": events and styles are plain arrays
+// "lazy": events and styles are native backed lists, that only convert an entry on access
+// "columnar": events are stored as typed arrays per field, see AssEventColumns
+export type ResultMode = "eager" | "lazy" | "columnar"
+
+// only the listed keys are converted, a list, that is not given, means every key
+export interface Projection {
+	sections?: (keyof AssResult)[]
+	event_fields?: (keyof AssEvent)[]
+	style_fields?: (keyof AssStyle)[]
+}
+
+// "object": AssTime objects
+// "centiseconds" | "milliseconds": integers since 0:00:00.00, these can be compared directly
+// columnar events always have millisecond columns
+export type TimeFormat = "object" | "centiseconds" | "milliseconds"
+
+// "object": AssColor objects
+// "packed": unsigned integers in the order of the ass format (&HAABBGGRR), see PackedColor
+export type ColorFormat = "object" | "packed"
+
+// settings, that only affect how the result is returned, not how it is parsed
+export interface ConvertSettings {
+	result_mode?: ResultMode
+	time_format?: TimeFormat
+	color_format?: ColorFormat
+	// keys, that are not projected, are missing in the result, even if the types say otherwise
+	projection?: Projection
+	// large ASCII event texts point into the native result, instead of being copied, the native
+	// result is then kept alive, until all of these strings are garbage collected
+	external_strings?: boolean
+	// adds timings and counters to the parse result
+	profile?: boolean
+	// adds an index of the event times to the parse result, see AssEventIndex
+	event_index?: boolean
+}
+
+export interface ParseSettings extends ConvertSettings {
 	strict_settings: StrictSettings
 	validate_settings: ValidateSettings
 }
 
+declare const compiled_settings_brand: unique symbol
+
+// an opaque native handle, that holds already validated settings, see AssParser.compile_settings
+export interface CompiledSettings<S extends ParseSettingsTS = ParseSettingsTS> {
+	readonly [compiled_settings_brand]: S
+}
+
 export type StrictSettingsTS = "strict" | "non-strict" | StrictSettings
 
 export type ValidateSettingsTS = "everything" | "nothing" | ValidateSettings
 
-export interface ParseSettingsTS {
+export interface ParseSettingsTS extends ConvertSettings {
 	strict_settings: StrictSettingsTS
 	validate_settings: ValidateSettingsTS
 }
@@ -93,13 +139,13 @@ export type EventType =
 	| "Movie"
 	| "Command"
 
-export interface AssEvent {
+export interface AssEvent<Time = AssTime> {
 	// marks different event_types
 	type: EventType
 	// original fields
 	layer: SizeT
-	start: AssTime
-	end: AssTime
+	start: Time
+	end: Time
 	style: string
 	name: string
 	margin_l: MarginValue
@@ -136,14 +182,14 @@ export interface AssColor {
 	a: U8
 }
 
-export interface AssStyle {
+export interface AssStyle<Color = AssColor> {
 	name: string
 	fontname: string
 	fontsize: SizeT
-	primary_colour: AssColor
-	secondary_colour: AssColor
-	outline_colour: AssColor
-	back_colour: AssColor
+	primary_colour: Color
+	secondary_colour: Color
+	outline_colour: Color
+	back_colour: Color
 	bold: boolean
 	italic: boolean
 	underline: boolean
@@ -189,16 +235,90 @@ export interface AssScriptInfo {
 	ycbcr_matrix: string
 }
 
-export interface AssResult {
+export interface AssResult<Time = AssTime, Color = AssColor> {
 	script_info: AssScriptInfo
-	styles: AssStyle[]
-	events: AssEvent[]
+	styles: AssStyle<Color>[]
+	events: AssEvent<Time>[]
 	//fonts: AssFonts
 	//graphics: AssGraphics
 	extra_sections: ExtraSections
 	file_props: FileProps
 }
 
+export interface LazyList<T> extends Iterable<T> {
+	readonly length: number
+	get(index: number): T | undefined
+	slice(start?: number, end?: number): T[]
+}
+
+export interface AssLazyResult<Time = AssTime, Color = AssColor>
+	extends Omit<AssResult<Time, Color>, "styles" | "events"> {
+	styles: LazyList<AssStyle<Color>>
+	events: LazyList<AssEvent<Time>>
+}
+
+// the index into this array is the value of AssEventColumns.type
+export const EVENT_TYPES: readonly EventType[] = [
+	"Dialogue",
+	"Comment",
+	"Picture",
+	"Sound",
+	"Movie",
+	"Command",
+]
+
+// the value of the margin columns, if the margin is "default"
+export const COLUMN_MARGIN_DEFAULT = -1
+
+export type EventStringColumn = "style" | "name" | "effect" | "text"
+
+export type EventStringOffsets = Uint32Array | Float64Array
+
+export interface AssEventColumns {
+	length: number
+	type: Uint8Array
+	layer: Uint32Array
+	start_ms: Int32Array
+	end_ms: Int32Array
+	margin_l: Int32Array
+	margin_r: Int32Array
+	margin_v: Int32Array
+	// the UTF-8 data of all string columns
+	strings: ArrayBuffer
+	// length + 1 byte offsets into strings each, the string of event i is [offsets[i], offsets[i + 1]),
+	// Float64Arrays instead of Uint32Arrays, if strings is larger than 4 GiB
+	style: EventStringOffsets
+	name: EventStringOffsets
+	effect: EventStringOffsets
+	text: EventStringOffsets
+}
+
+export interface AssColumnarResult<Color = AssColor>
+	extends Omit<AssResult<AssTime, Color>, "events"> {
+	events: AssEventColumns
+}
+
+export type AssTimeFor<S extends ConvertSettings> = [S["time_format"]] extends [
+	"centiseconds" | "milliseconds",
+]
+	? number
+	: AssTime
+
+export type AssColorFor<S extends ConvertSettings> = [
+	S["color_format"],
+] extends ["packed"]
+	? number
+	: AssColor
+
+// the shape of the result, depending on the conversion settings
+export type AssResultFor<S extends ConvertSettings> = [
+	S["result_mode"],
+] extends ["lazy"]
+	? AssLazyResult<AssTimeFor<S>, AssColorFor<S>>
+	: [S["result_mode"]] extends ["columnar"]
+		? AssColumnarResult<AssColorFor<S>>
+		: AssResult<AssTimeFor<S>, AssColorFor<S>>
+
 export type DiagnosticSeverity = "warning" | "error"
 
 export interface FilePos {
@@ -211,25 +331,332 @@ export interface Diagnostic {
 	position?: FilePos
 }
 
+// in nanoseconds
+export interface ParseTimings {
+	// mapping the file, only for files parsed with mmap, other files are read while parsing
+	read_ns: number
+	// reading, detecting the encoding, parsing and validating (e.g. the fonts) in the library
+	parse_ns: number
+	// converting the native result to js
+	convert_ns: number
+}
+
+export interface ParseCounters {
+	bytes_read: number
+	events: number
+	styles: number
+	// entries of lazy lists, that are converted later, are not counted
+	strings_created: number
+	diagnostics: number
+	// the result came from the cache, so nothing was read or parsed
+	cached: boolean
+}
+
 export interface AssParseResultBase {
 	diagnostics: Diagnostic[]
+	// only present, if settings.profile is set
+	timings?: ParseTimings
+	counters?: ParseCounters
 }
 
 export interface AssParseResultError {
 	error: true
 }
 
-export interface AssParseResultSuccess {
+// answers which events are shown at a time, without going through every event, an event is
+// shown from its start (inclusive) to its end (exclusive), times are in milliseconds
+export interface AssEventIndex {
+	// the number of indexed events
+	readonly length: number
+	// the indices of the events, that are shown at the time, ascending
+	active_at(time: number): Uint32Array
+	// the indices of the events, that are shown at some point in [start, end), ascending
+	range(start: number, end: number): Uint32Array
+}
+
+export interface AssParseResultSuccess<R = AssResult> {
 	error: false
-	result: AssResult
+	result: R
+	// only present, if settings.event_index is set
+	event_index?: AssEventIndex
 }
 
-export type AssParseResult = AssParseResultBase &
-	(AssParseResultError | AssParseResultSuccess)
+export type AssParseResult<R = AssResult> = AssParseResultBase &
+	(AssParseResultError | AssParseResultSuccess<R>)
+
+// the result of linting, the parse result itself is never converted
+export interface AssLintResult {
+	error: boolean
+	diagnostics: Diagnostic[]
+}
+
+// the entries [start, start + removed) were replaced by [start, start + inserted)
+export interface AssEntrySplice {
+	start: number
+	removed: number
+	inserted: number
+}
+
+export interface AssDocumentEdit {
+	// every diagnostic of the document after the edit
+	diagnostics: Diagnostic[]
+	error: boolean
+	// the edit was not only in event lines, so the whole document was parsed again, events and
+	// styles then cover every entry
+	full_reparse: boolean
+	events: AssEntrySplice
+	styles: AssEntrySplice
+}
+
+// a parsed script for editors, edits of event lines only parse the changed lines, lines are
+// indices into the lines of the script, without line breaks
+export interface AssDocument<Time = AssTime, Color = AssColor> {
+	readonly line_count: number
+	readonly error: boolean
+	diagnostics(): Diagnostic[]
+	// the range is resolved like Array.prototype.slice
+	events(start?: number, end?: number): AssEvent<Time>[]
+	styles(start?: number, end?: number): AssStyle<Color>[]
+	// the lines joined with "\n"
+	text(): string
+	// replaces the lines [start, end) with lines
+	edit(start: number, end: number, lines: string[]): AssDocumentEdit
+}
+
+// the chunks of a stream parser, in this order: one "header" chunk, once the Format line of the
+// [Events] section was read, then "events" chunks with up to batch_size events each and one "end"
+// chunk, "error" is always the last chunk, the positions of diagnostics are lines of the whole
+// stream, header diagnostics are only reported with the "header" chunk
+export interface AssStreamHeaderChunk<Color = AssColor> {
+	kind: "header"
+	diagnostics: Diagnostic[]
+	script_info: AssScriptInfo
+	styles: AssStyle<Color>[]
+}
+
+export interface AssStreamEventsChunk<Time = AssTime> {
+	kind: "events"
+	diagnostics: Diagnostic[]
+	events: AssEvent<Time>[]
+}
+
+export interface AssStreamEndChunk {
+	kind: "end"
+	diagnostics: Diagnostic[]
+	extra_sections: ExtraSections
+	file_props: FileProps
+}
+
+export interface AssStreamErrorChunk {
+	kind: "error"
+	diagnostics: Diagnostic[]
+}
+
+export type AssStreamChunk<Time = AssTime, Color = AssColor> =
+	| AssStreamHeaderChunk<Color>
+	| AssStreamEventsChunk<Time>
+	| AssStreamEndChunk
+	| AssStreamErrorChunk
+
+// parses the bytes of a UTF-8 script, while they are fed, only the header, one batch of events and
+// the sections after the events are kept in memory, input after an "error" chunk is ignored
+export interface AssStreamParser<Time = AssTime, Color = AssColor> {
+	feed(chunk: Uint8Array): AssStreamChunk<Time, Color>[]
+	end(): AssStreamChunk<Time, Color>[]
+}
+
+export interface StreamOptions {
+	// events per "events" chunk, defaults to 1000
+	batch_size?: number
+}
+
+// a Transform, that takes the bytes of a script and emits its AssStreamChunks as objects
+export class AssParseStream<Time = AssTime, Color = AssColor> extends Transform {
+	private readonly parser: AssStreamParser<Time, Color>
+
+	constructor(parser: AssStreamParser<Time, Color>) {
+		super({ readableObjectMode: true })
+		this.parser = parser
+	}
+
+	private push_chunks(chunks: AssStreamChunk<Time, Color>[]): void {
+		for (const chunk of chunks) {
+			this.push(chunk)
+		}
+	}
+
+	_transform(
+		chunk: Buffer,
+		_encoding: BufferEncoding,
+		callback: TransformCallback
+	): void {
+		try {
+			this.push_chunks(this.parser.feed(chunk))
+			callback()
+		} catch (err) {
+			callback(err as Error)
+		}
+	}
 
-type AssSource =
-	| { type: "file"; name: string }
+	_flush(callback: TransformCallback): void {
+		try {
+			this.push_chunks(this.parser.end())
+			callback()
+		} catch (err) {
+			callback(err as Error)
+		}
+	}
+}
+
+export type AssSource =
+	| { type: "file"; name: string; mmap?: boolean }
 	| { type: "string"; content: string }
+	| { type: "buffer"; data: Uint8Array }
+
+export interface FileOptions {
+	// parse a read-only memory mapping of the file, instead of reading it into memory first
+	mmap?: boolean
+}
+
+export interface BatchOptions {
+	// maximum number of files queued on the libuv threadpool at the same time, 0 means one per cpu
+	// core, the files are parsed by the threads of the pool, so no more than UV_THREADPOOL_SIZE
+	// (4 by default) are parsed at the same time, for more parallelism UV_THREADPOOL_SIZE needs to
+	// be set in the environment before node starts
+	concurrency?: number
+}
+
+export interface IterateOptions {
+	// events converted per event loop turn, defaults to 1000
+	batch_size?: number
+}
+
+export interface WriteOptions {
+	// an open file descriptor (e.g. of fs.openSync), the script is written to it in chunks and
+	// the number of written bytes is returned instead of a Buffer, the writes block like
+	// fs.writeSync, use write_ass_async to write on the libuv threadpool, not supported on windows
+	fd?: number
+}
+
+// the results write_ass accepts, with the time and color format of the settings it is given
+export type WritableAssResult =
+	| AssResult<AssTime | number, AssColor | number>
+	| AssLazyResult<AssTime | number, AssColor | number>
+
+// thrown by AssParser.iterate_events, if the script could not be parsed
+export class AssParseError extends Error {
+	readonly diagnostics: Diagnostic[]
+
+	constructor(diagnostics: Diagnostic[]) {
+		const error = diagnostics.find(
+			(diagnostic) => diagnostic.severity === "error"
+		)
+
+		super(error?.message ?? "the script could not be parsed")
+		this.name = "AssParseError"
+		this.diagnostics = diagnostics
+	}
+}
+
+function next_event_loop_turn(): Promise<void> {
+	return new Promise<void>((resolve) => setImmediate(resolve))
+}
+
+const utf8_decoder = new TextDecoder("utf-8")
+
+// every handle returned by compile_settings, these are passed to the native side as they are
+const compiled_settings = new WeakSet<object>()
+
+// helpers, to read single values of columnar events, strings are only decoded, when requested
+export class AssEventColumnsReader {
+	static string(
+		columns: AssEventColumns,
+		column: EventStringColumn,
+		index: number
+	): string {
+		const offsets = columns[column]
+
+		return utf8_decoder.decode(
+			new Uint8Array(
+				columns.strings,
+				offsets[index],
+				offsets[index + 1] - offsets[index]
+			)
+		)
+	}
+
+	static ms_to_time(ms: number): AssTime {
+		return {
+			hour: Math.floor(ms / 3_600_000),
+			min: Math.floor(ms / 60_000) % 60,
+			sec: Math.floor(ms / 1000) % 60,
+			hundred: Math.floor(ms / 10) % 100,
+		}
+	}
+
+	static margin(column: Int32Array, index: number): MarginValue {
+		const value = column[index]
+
+		return value === COLUMN_MARGIN_DEFAULT ? "default" : value
+	}
+
+	// the same object, the eager result mode returns for this event
+	static event(columns: AssEventColumns, index: number): AssEvent {
+		return {
+			type: EVENT_TYPES[columns.type[index]],
+			layer: columns.layer[index],
+			start: AssEventColumnsReader.ms_to_time(columns.start_ms[index]),
+			end: AssEventColumnsReader.ms_to_time(columns.end_ms[index]),
+			style: AssEventColumnsReader.string(columns, "style", index),
+			name: AssEventColumnsReader.string(columns, "name", index),
+			margin_l: AssEventColumnsReader.margin(columns.margin_l, index),
+			margin_r: AssEventColumnsReader.margin(columns.margin_r, index),
+			margin_v: AssEventColumnsReader.margin(columns.margin_v, index),
+			effect: AssEventColumnsReader.string(columns, "effect", index),
+			text: AssEventColumnsReader.string(columns, "text", index),
+		}
+	}
+}
+
+// helpers for the "packed" color_format
+export class PackedColor {
+	static unpack(packed: number): AssColor {
+		return {
+			r: packed & 0xff,
+			g: (packed >>> 8) & 0xff,
+			b: (packed >>> 16) & 0xff,
+			a: (packed >>> 24) & 0xff,
+		}
+	}
+
+	static pack(color: AssColor): number {
+		return (
+			((color.a << 24) | (color.b << 16) | (color.g << 8) | color.r) >>> 0
+		)
+	}
+}
+
+/** @internal in nanoseconds, one entry per iteration, only used by bench/suite.ts */
+export interface PhaseTimings {
+	parse_ns: number[]
+	convert_ns: number[]
+}
+
+export interface CacheOptions {
+	enabled: boolean
+	// budget for the estimated size of all cached results
+	max_bytes: number
+}
+
+export interface CacheStats {
+	enabled: boolean
+	max_bytes: number
+	bytes: number
+	entries: number
+	hits: number
+	misses: number
+	evictions: number
+}
 
 export class AssParser {
 	static resolve_strict_settings(
@@ -287,50 +714,554 @@ export class AssParser {
 	}
 
 	static resolve_parse_settings(settings_ts: ParseSettingsTS): ParseSettings {
+		const { strict_settings, validate_settings, ...convert_settings } =
+			settings_ts
+
+		return {
+			...convert_settings,
+			strict_settings: AssParser.resolve_strict_settings(strict_settings),
+			validate_settings:
+				AssParser.resolve_validate_settings(validate_settings),
+		}
+	}
+
+	// validates the settings once, the handle can be passed to every parse and lint function
+	// instead of the settings, which skips resolving and validating them on every call
+	static compile_settings<S extends ParseSettingsTS>(
+		settings_ts: S
+	): CompiledSettings<S> {
+		const handle: CompiledSettings<S> = ass_parser.compile_settings(
+			AssParser.resolve_parse_settings(settings_ts)
+		)
+
+		compiled_settings.add(handle)
+
+		return handle
+	}
+
+	private static resolve_settings_arg(
+		settings_ts: ParseSettingsTS | CompiledSettings
+	): ParseSettings | CompiledSettings {
+		if (compiled_settings.has(settings_ts)) {
+			return settings_ts as CompiledSettings
+		}
+
+		return AssParser.resolve_parse_settings(settings_ts as ParseSettingsTS)
+	}
+
+	private static error_result(
+		err: unknown
+	): AssParseResultBase & AssParseResultError {
 		return {
-			strict_settings: AssParser.resolve_strict_settings(
-				settings_ts.strict_settings
-			),
-			validate_settings: AssParser.resolve_validate_settings(
-				settings_ts.validate_settings
-			),
+			error: true,
+			diagnostics: [
+				{ message: (err as Error).message, severity: "error" },
+			],
 		}
 	}
 
-	private static parse_ass(
+	private static parse_ass<S extends ParseSettingsTS>(
 		source: AssSource,
-		settings_ts: ParseSettingsTS
-	): AssParseResult {
+		settings_ts: S | CompiledSettings<S>
+	): AssParseResult<AssResultFor<S>> {
 		try {
-			const settings: ParseSettings =
-				AssParser.resolve_parse_settings(settings_ts)
+			const settings = AssParser.resolve_settings_arg(settings_ts)
 
 			// this throws, when the argument are not as expected, just to be safe for JS land
 			return ass_parser.parse_ass(source, settings)
 		} catch (err) {
-			return {
-				error: true,
-				diagnostics: [
-					{ message: (err as Error).message, severity: "error" },
-				],
-			}
+			return AssParser.error_result(err)
 		}
 	}
 
-	static parse_ass_file(
+	private static parse_ass_async<S extends ParseSettingsTS>(
+		source: AssSource,
+		settings_ts: S | CompiledSettings<S>
+	): Promise<AssParseResult<AssResultFor<S>>> {
+		return new Promise<AssParseResult<AssResultFor<S>>>((resolve) => {
+			try {
+				const settings = AssParser.resolve_settings_arg(settings_ts)
+
+				// the parsing happens on the libuv threadpool, only the conversion to js runs on the main thread
+				ass_parser.parse_ass_async(
+					source,
+					settings,
+					(
+						err: Error | null,
+						result: AssParseResult<AssResultFor<S>>
+					) => {
+						if (err) {
+							resolve(AssParser.error_result(err))
+							return
+						}
+
+						resolve(result)
+					}
+				)
+			} catch (err) {
+				resolve(AssParser.error_result(err))
+			}
+		})
+	}
+
+	static parse_ass_file<S extends ParseSettingsTS>(
 		file: string,
-		settings: ParseSettingsTS
-	): AssParseResult {
-		return AssParser.parse_ass({ type: "file", name: file }, settings)
+		settings: S | CompiledSettings<S>,
+		options: FileOptions = {}
+	): AssParseResult<AssResultFor<S>> {
+		return AssParser.parse_ass(
+			{ type: "file", name: file, mmap: options.mmap },
+			settings
+		)
 	}
 
-	static parse_ass_string(
+	static parse_ass_string<S extends ParseSettingsTS>(
 		file: string,
-		settings: ParseSettingsTS
-	): AssParseResult {
+		settings: S | CompiledSettings<S>
+	): AssParseResult<AssResultFor<S>> {
 		return AssParser.parse_ass({ type: "string", content: file }, settings)
 	}
 
+	// the raw bytes are parsed without copying them, so the encoding (e.g. UTF-16) is detected by the parser
+	static parse_ass_buffer<S extends ParseSettingsTS>(
+		buffer: Uint8Array,
+		settings: S | CompiledSettings<S>
+	): AssParseResult<AssResultFor<S>> {
+		return AssParser.parse_ass({ type: "buffer", data: buffer }, settings)
+	}
+
+	static parse_ass_file_async<S extends ParseSettingsTS>(
+		file: string,
+		settings: S | CompiledSettings<S>,
+		options: FileOptions = {}
+	): Promise<AssParseResult<AssResultFor<S>>> {
+		return AssParser.parse_ass_async(
+			{ type: "file", name: file, mmap: options.mmap },
+			settings
+		)
+	}
+
+	static parse_ass_string_async<S extends ParseSettingsTS>(
+		file: string,
+		settings: S | CompiledSettings<S>
+	): Promise<AssParseResult<AssResultFor<S>>> {
+		return AssParser.parse_ass_async(
+			{ type: "string", content: file },
+			settings
+		)
+	}
+
+	static parse_ass_buffer_async<S extends ParseSettingsTS>(
+		buffer: Uint8Array,
+		settings: S | CompiledSettings<S>
+	): Promise<AssParseResult<AssResultFor<S>>> {
+		return AssParser.parse_ass_async(
+			{ type: "buffer", data: buffer },
+			settings
+		)
+	}
+
+	private static json_error_result(err: unknown): Buffer {
+		return Buffer.from(JSON.stringify(AssParser.error_result(err)), "utf8")
+	}
+
+	private static parse_ass_json(
+		source: AssSource,
+		settings_ts: ParseSettingsTS | CompiledSettings
+	): Buffer {
+		try {
+			const settings = AssParser.resolve_settings_arg(settings_ts)
+
+			return ass_parser.parse_ass_json(source, settings)
+		} catch (err) {
+			return AssParser.json_error_result(err)
+		}
+	}
+
+	private static parse_ass_json_async(
+		source: AssSource,
+		settings_ts: ParseSettingsTS | CompiledSettings
+	): Promise<Buffer> {
+		return new Promise<Buffer>((resolve) => {
+			try {
+				const settings = AssParser.resolve_settings_arg(settings_ts)
+
+				// the JSON is written on the libuv threadpool as well
+				ass_parser.parse_ass_json_async(
+					source,
+					settings,
+					(err: Error | null, result: Buffer) => {
+						if (err) {
+							resolve(AssParser.json_error_result(err))
+							return
+						}
+
+						resolve(result)
+					}
+				)
+			} catch (err) {
+				resolve(AssParser.json_error_result(err))
+			}
+		})
+	}
+
+	// the UTF-8 JSON of the AssParseResult, that parse_ass_file returns, written natively without
+	// creating the js objects first, the result is always written like the "eager" result_mode,
+	// profile and event_index are ignored
+	static parse_ass_file_json(
+		file: string,
+		settings: ParseSettingsTS | CompiledSettings,
+		options: FileOptions = {}
+	): Buffer {
+		return AssParser.parse_ass_json(
+			{ type: "file", name: file, mmap: options.mmap },
+			settings
+		)
+	}
+
+	static parse_ass_string_json(
+		file: string,
+		settings: ParseSettingsTS | CompiledSettings
+	): Buffer {
+		return AssParser.parse_ass_json({ type: "string", content: file }, settings)
+	}
+
+	static parse_ass_buffer_json(
+		buffer: Uint8Array,
+		settings: ParseSettingsTS | CompiledSettings
+	): Buffer {
+		return AssParser.parse_ass_json({ type: "buffer", data: buffer }, settings)
+	}
+
+	static parse_ass_file_json_async(
+		file: string,
+		settings: ParseSettingsTS | CompiledSettings,
+		options: FileOptions = {}
+	): Promise<Buffer> {
+		return AssParser.parse_ass_json_async(
+			{ type: "file", name: file, mmap: options.mmap },
+			settings
+		)
+	}
+
+	static parse_ass_string_json_async(
+		file: string,
+		settings: ParseSettingsTS | CompiledSettings
+	): Promise<Buffer> {
+		return AssParser.parse_ass_json_async(
+			{ type: "string", content: file },
+			settings
+		)
+	}
+
+	static parse_ass_buffer_json_async(
+		buffer: Uint8Array,
+		settings: ParseSettingsTS | CompiledSettings
+	): Promise<Buffer> {
+		return AssParser.parse_ass_json_async(
+			{ type: "buffer", data: buffer },
+			settings
+		)
+	}
+
+	// writes a result as an ass script, that parses to the same result, the script is UTF-8 and
+	// starts with a BOM, if file_props.file_type is not "Unknown", the time_format and
+	// color_format of the settings need to be the ones, the result was parsed with, results of the
+	// "columnar" result_mode and values, that can't be written (e.g. strings with line breaks, or
+	// commas in any field but the event text), are thrown as TypeError, with options.fd before
+	// anything is written
+	static write_ass(
+		result: WritableAssResult,
+		settings?: ConvertSettings | CompiledSettings
+	): Buffer
+	static write_ass(
+		result: WritableAssResult,
+		settings: ConvertSettings | CompiledSettings,
+		options: WriteOptions & { fd: number }
+	): number
+	static write_ass(
+		result: WritableAssResult,
+		settings: ConvertSettings | CompiledSettings = {},
+		options: WriteOptions = {}
+	): Buffer | number {
+		return ass_parser.write_ass(result, settings, options.fd)
+	}
+
+	// like write_ass with options.fd, but the script is written to fd on the libuv threadpool,
+	// only reading the result happens on the main thread, so the whole script is kept in memory
+	// until it is written, resolves with the number of written bytes, errors reject the promise
+	static write_ass_async(
+		result: WritableAssResult,
+		settings: ConvertSettings | CompiledSettings,
+		fd: number
+	): Promise<number> {
+		return new Promise<number>((resolve, reject) => {
+			try {
+				ass_parser.write_ass_async(
+					result,
+					settings,
+					fd,
+					(err: Error | null, written: number) => {
+						if (err) {
+							reject(err)
+							return
+						}
+
+						resolve(written)
+					}
+				)
+			} catch (err) {
+				reject(err)
+			}
+		})
+	}
+
+	// parses on the libuv threadpool and then converts the events in batches of
+	// options.batch_size, the next batch is only converted, when the consumer asks for it, and
+	// never in the same event loop turn as the previous one, compiled settings should use the
+	// "lazy" result_mode, otherwise every event is converted at once, before the first one is
+	// returned, parse errors are thrown as AssParseError
+	static async *iterate_events<S extends ParseSettingsTS>(
+		source: AssSource,
+		settings_ts: S | CompiledSettings<S>,
+		options: IterateOptions = {}
+	): AsyncGenerator<AssEvent<AssTimeFor<S>>, void, undefined> {
+		const batch_size = options.batch_size ?? 1000
+
+		if (!Number.isInteger(batch_size) || batch_size <= 0) {
+			throw new TypeError(
+				"options.batch_size needs to be a positive integer"
+			)
+		}
+
+		const settings: S | CompiledSettings<S> = compiled_settings.has(
+			settings_ts
+		)
+			? settings_ts
+			: { ...(settings_ts as S), result_mode: "lazy" as const }
+
+		const parsed = await AssParser.parse_ass_async(source, settings)
+
+		if (parsed.error) {
+			throw new AssParseError(parsed.diagnostics)
+		}
+
+		// an array, if the compiled settings use the "eager" result_mode
+		const events = parsed.result.events as unknown as
+			| LazyList<AssEvent<AssTimeFor<S>>>
+			| AssEvent<AssTimeFor<S>>[]
+
+		if (typeof events.slice !== "function") {
+			throw new TypeError(
+				"iterate_events does not support the result_mode 'columnar'"
+			)
+		}
+
+		for (let start = 0; start < events.length; start += batch_size) {
+			if (start > 0) {
+				await next_event_loop_turn()
+			}
+
+			yield* events.slice(start, start + batch_size)
+		}
+	}
+
+	static parse_ass_batch<S extends ParseSettingsTS>(
+		sources: AssSource[],
+		settings_ts: S | CompiledSettings<S>,
+		options: BatchOptions = {}
+	): Promise<AssParseResult<AssResultFor<S>>[]> {
+		return new Promise<AssParseResult<AssResultFor<S>>[]>((resolve) => {
+			try {
+				const settings = AssParser.resolve_settings_arg(settings_ts)
+
+				// every source gets its own result, invalid sources just result in an error result
+				ass_parser.parse_ass_batch(
+					sources,
+					settings,
+					options.concurrency ?? 0,
+					(
+						err: Error | null,
+						results: AssParseResult<AssResultFor<S>>[]
+					) => {
+						if (err) {
+							resolve(
+								sources.map(() => AssParser.error_result(err))
+							)
+							return
+						}
+
+						resolve(results)
+					}
+				)
+			} catch (err) {
+				resolve(sources.map(() => AssParser.error_result(err)))
+			}
+		})
+	}
+
+	private static lint_ass(
+		source: AssSource,
+		settings_ts: ParseSettingsTS | CompiledSettings
+	): AssLintResult {
+		try {
+			const settings = AssParser.resolve_settings_arg(settings_ts)
+
+			return ass_parser.lint_ass(source, settings)
+		} catch (err) {
+			return AssParser.error_result(err)
+		}
+	}
+
+	// only parses and validates, without converting the result or caching it
+	static lint_ass_file(
+		file: string,
+		settings: ParseSettingsTS | CompiledSettings,
+		options: FileOptions = {}
+	): AssLintResult {
+		return AssParser.lint_ass(
+			{ type: "file", name: file, mmap: options.mmap },
+			settings
+		)
+	}
+
+	static lint_ass_string(
+		file: string,
+		settings: ParseSettingsTS | CompiledSettings
+	): AssLintResult {
+		return AssParser.lint_ass({ type: "string", content: file }, settings)
+	}
+
+	static lint_ass_buffer(
+		buffer: Uint8Array,
+		settings: ParseSettingsTS | CompiledSettings
+	): AssLintResult {
+		return AssParser.lint_ass({ type: "buffer", data: buffer }, settings)
+	}
+
+	// throws, if the settings are invalid, the diagnostics of parsing are in the document
+	static create_document<S extends ParseSettingsTS>(
+		content: string,
+		settings_ts: S | CompiledSettings<S>
+	): AssDocument<AssTimeFor<S>, AssColorFor<S>> {
+		const settings = AssParser.resolve_settings_arg(settings_ts)
+
+		return ass_parser.create_document(content, settings)
+	}
+
+	// throws, if the settings are invalid, only the "eager" result_mode is supported
+	static create_stream_parser<S extends ParseSettingsTS>(
+		settings_ts: S | CompiledSettings<S>,
+		options: StreamOptions = {}
+	): AssStreamParser<AssTimeFor<S>, AssColorFor<S>> {
+		const settings = AssParser.resolve_settings_arg(settings_ts)
+
+		return ass_parser.create_stream_parser(
+			settings,
+			options.batch_size ?? 1000
+		)
+	}
+
+	// e.g. fs.createReadStream(file).pipe(AssParser.parse_stream(settings))
+	static parse_stream<S extends ParseSettingsTS>(
+		settings_ts: S | CompiledSettings<S>,
+		options: StreamOptions = {}
+	): AssParseStream<AssTimeFor<S>, AssColorFor<S>> {
+		return new AssParseStream(
+			AssParser.create_stream_parser(settings_ts, options)
+		)
+	}
+
+	private static serialize_ass(
+		source: AssSource,
+		settings_ts: ParseSettingsTS | CompiledSettings
+	): AssParseResult<Buffer> {
+		try {
+			const settings = AssParser.resolve_settings_arg(settings_ts)
+
+			return ass_parser.serialize_ass(source, settings)
+		} catch (err) {
+			return AssParser.error_result(err)
+		}
+	}
+
+	// the result is a versioned binary snapshot, that can be stored or sent somewhere else and
+	// loaded with deserialize, without parsing the script again
+	static serialize_ass_file(
+		file: string,
+		settings: ParseSettingsTS | CompiledSettings,
+		options: FileOptions = {}
+	): AssParseResult<Buffer> {
+		return AssParser.serialize_ass(
+			{ type: "file", name: file, mmap: options.mmap },
+			settings
+		)
+	}
+
+	static serialize_ass_string(
+		file: string,
+		settings: ParseSettingsTS | CompiledSettings
+	): AssParseResult<Buffer> {
+		return AssParser.serialize_ass({ type: "string", content: file }, settings)
+	}
+
+	static serialize_ass_buffer(
+		buffer: Uint8Array,
+		settings: ParseSettingsTS | CompiledSettings
+	): AssParseResult<Buffer> {
+		return AssParser.serialize_ass({ type: "buffer", data: buffer }, settings)
+	}
+
+	// returns the same result as parsing the original script, only the "eager" result_mode is
+	// supported, invalid snapshots return an error result
+	static deserialize<S extends ConvertSettings = ConvertSettings>(
+		snapshot: Uint8Array,
+		settings: S | CompiledSettings = {} as S
+	): AssParseResult<AssResultFor<S>> {
+		try {
+			return ass_parser.deserialize_ass(snapshot, settings)
+		} catch (err) {
+			return AssParser.error_result(err)
+		}
+	}
+
+	// builds an index from start and end times in milliseconds, e.g. the start_ms and end_ms
+	// columns of a columnar result, to index a parse result, use settings.event_index instead
+	static create_event_index(
+		start_ms: Int32Array,
+		end_ms: Int32Array
+	): AssEventIndex {
+		return ass_parser.create_event_index(start_ms, end_ms)
+	}
+
+	/**
+	 * @internal times the native parsing and the conversion to js separately, only used by
+	 * bench/suite.ts, stripped from the published declarations
+	 */
+	static benchmark_phases(
+		source: AssSource,
+		settings_ts: ParseSettingsTS | CompiledSettings,
+		iterations: number
+	): PhaseTimings {
+		const settings = AssParser.resolve_settings_arg(settings_ts)
+
+		return ass_parser.benchmark_phases(source, settings, iterations)
+	}
+
+	// the cache is process wide and disabled by default, only successful results are cached
+	static cache_configure(options: CacheOptions): void {
+		ass_parser.cache_configure(options)
+	}
+
+	static get cache_stats(): CacheStats {
+		return ass_parser.cache_stats()
+	}
+
+	// removes all entries and resets the counters
+	static cache_clear(): void {
+		ass_parser.cache_clear()
+	}
+
 	static get version(): string {
 		return ass_parser.version
 	}
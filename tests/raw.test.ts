@@ -24,9 +24,44 @@ describe("parse_ass", () => {
 	})
 })
 
+describe("parse_ass_async", () => {
+	it("should throw an error, when no callback was given", async () => {
+		try {
+			ass_parser.parse_ass_async({ type: "string", content: "" }, {})
+
+			fail("it should not reach here")
+		} catch (e) {
+			expect((e as any).toString()).toEqual(
+				"TypeError: Wrong number of arguments"
+			)
+		}
+	})
+})
+
 describe("exported properties", () => {
 	it("should only have known properties", async () => {
-		const expectedKeys = ["parse_ass", "version", "commit_hash"]
+		const expectedKeys = [
+			"parse_ass",
+			"parse_ass_async",
+			"parse_ass_batch",
+			"parse_ass_json",
+			"parse_ass_json_async",
+			"write_ass",
+			"write_ass_async",
+			"lint_ass",
+			"compile_settings",
+			"serialize_ass",
+			"deserialize_ass",
+			"create_document",
+			"create_stream_parser",
+			"create_event_index",
+			"benchmark_phases",
+			"cache_configure",
+			"cache_stats",
+			"cache_clear",
+			"version",
+			"commit_hash",
+		]
 
 		const keys = Object.keys(ass_parser)
 		expect(keys).toStrictEqual(expectedKeys)
@@ -35,6 +70,23 @@ describe("exported properties", () => {
 	it("should have the expected properties", async () => {
 		const expectedProperties: Record<string, any> = {
 			parse_ass: () => {},
+			parse_ass_async: () => {},
+			parse_ass_batch: () => {},
+			parse_ass_json: () => {},
+			parse_ass_json_async: () => {},
+			write_ass: () => {},
+			write_ass_async: () => {},
+			lint_ass: () => {},
+			compile_settings: () => {},
+			serialize_ass: () => {},
+			deserialize_ass: () => {},
+			create_document: () => {},
+			create_stream_parser: () => {},
+			create_event_index: () => {},
+			benchmark_phases: () => {},
+			cache_configure: () => {},
+			cache_stats: () => {},
+			cache_clear: () => {},
 			version: "0.0.3",
 			commit_hash: "e35310b3519b",
 		}
@@ -1,8 +1,20 @@
 import { expect } from "@jest/globals"
 import path from "path"
 import fs from "fs"
+import os from "os"
+import { Readable } from "stream"
+import { Worker } from "worker_threads"
 import { sampleFiles } from "./samples"
-import { AssParser, type ParseSettingsTS } from "../src/ts/index"
+import {
+	AssEventColumnsReader,
+	AssParseError,
+	AssParser,
+	PackedColor,
+	type AssDocument,
+	type AssSource,
+	type AssStreamChunk,
+	type ParseSettingsTS,
+} from "../src/ts/index"
 
 function fail(reason = "fail was called in a test."): never {
 	throw new Error(reason)
@@ -75,3 +87,2074 @@ describe("parse_ass: works as expected", () => {
 		}
 	})
 })
+
+describe("parse_ass_async: works as expected", () => {
+	it("should return an error for non existent file", async () => {
+		const file = getFilePath("NON-EXISTENT.ass")
+
+		expect(fs.existsSync(file)).toBe(false)
+
+		const result = await AssParser.parse_ass_file_async(
+			file,
+			DEFAULT_SETTINGS
+		)
+		expect(result).toMatchObject({
+			error: true,
+			diagnostics: [{ message: "no such file", severity: "error" }],
+		})
+	})
+
+	it("should return the same objects as the sync version", async () => {
+		const results = await Promise.all(
+			sampleFiles.map(({ file }) =>
+				AssParser.parse_ass_file_async(
+					getFilePath(file),
+					DEFAULT_SETTINGS
+				)
+			)
+		)
+
+		for (let i = 0; i < sampleFiles.length; ++i) {
+			expect(results[i]).toMatchObject(sampleFiles[i].result as any)
+		}
+	})
+
+	it("should parse strings", async () => {
+		for (const { file, result } of sampleFiles) {
+			const filePath = getFilePath(file)
+			const content = fs.readFileSync(filePath, "utf8")
+
+			const actual_result = await AssParser.parse_ass_string_async(
+				content,
+				DEFAULT_SETTINGS
+			)
+
+			expect(actual_result).toMatchObject(result as any)
+			expect(actual_result).toStrictEqual(
+				AssParser.parse_ass_file(filePath, DEFAULT_SETTINGS)
+			)
+		}
+	})
+})
+
+describe("parse_ass_batch: works as expected", () => {
+	it("should return the results in input order", async () => {
+		const sources: AssSource[] = [...sampleFiles, ...sampleFiles].map(
+			({ file }) => ({ type: "file", name: getFilePath(file) })
+		)
+
+		const results = await AssParser.parse_ass_batch(
+			sources,
+			DEFAULT_SETTINGS,
+			{ concurrency: 2 }
+		)
+
+		expect(results.length).toBe(sources.length)
+
+		for (let i = 0; i < sources.length; ++i) {
+			const { result } = sampleFiles[i % sampleFiles.length]
+			expect(results[i]).toMatchObject(result as any)
+		}
+	})
+
+	it("should report an error per invalid source", async () => {
+		const sources = [
+			{ type: "file", name: getFilePath("test.ass") },
+			{ type: "invalid" },
+			{ type: "file", name: getFilePath("NON-EXISTENT.ass") },
+		] as AssSource[]
+
+		const results = await AssParser.parse_ass_batch(
+			sources,
+			DEFAULT_SETTINGS
+		)
+
+		expect(results.length).toBe(3)
+		expect(results[0]).toMatchObject({ error: false })
+		expect(results[1]).toMatchObject({
+			error: true,
+			diagnostics: [
+				{
+					message:
+						"source.type needs to be either 'file', 'string' or 'buffer'",
+					severity: "error",
+				},
+			],
+		})
+		expect(results[2]).toMatchObject({
+			error: true,
+			diagnostics: [{ message: "no such file", severity: "error" }],
+		})
+	})
+
+	it("should handle an empty list", async () => {
+		const results = await AssParser.parse_ass_batch([], DEFAULT_SETTINGS)
+
+		expect(results).toStrictEqual([])
+	})
+
+	it("should handle lists without any valid source", async () => {
+		const results = await AssParser.parse_ass_batch(
+			[{ type: "invalid" }, { type: "invalid" }] as AssSource[],
+			DEFAULT_SETTINGS,
+			{ concurrency: 1 }
+		)
+
+		expect(results).toMatchObject([{ error: true }, { error: true }])
+	})
+})
+
+describe("parse_ass_buffer: works as expected", () => {
+	it("should return the same objects as the file version", async () => {
+		for (const { file, result } of sampleFiles) {
+			const buffer = fs.readFileSync(getFilePath(file))
+
+			const actual_result = AssParser.parse_ass_buffer(
+				buffer,
+				DEFAULT_SETTINGS
+			)
+			expect(actual_result).toMatchObject(result as any)
+
+			const async_result = await AssParser.parse_ass_buffer_async(
+				buffer,
+				DEFAULT_SETTINGS
+			)
+			expect(async_result).toStrictEqual(actual_result)
+		}
+	})
+
+	it("should parse string and buffer sources like the file", async () => {
+		for (const { file } of sampleFiles) {
+			const filePath = getFilePath(file)
+			const expected = AssParser.parse_ass_file(filePath, DEFAULT_SETTINGS)
+
+			const buffer = fs.readFileSync(filePath)
+
+			expect(
+				AssParser.parse_ass_buffer(buffer, DEFAULT_SETTINGS)
+			).toStrictEqual(expected)
+
+			expect(
+				AssParser.parse_ass_string(
+					buffer.toString("utf8"),
+					DEFAULT_SETTINGS
+				)
+			).toStrictEqual(expected)
+		}
+	})
+
+	it("should accept plain Uint8Arrays with an offset", async () => {
+		const buffer = fs.readFileSync(getFilePath("test.ass"))
+
+		const backing = new Uint8Array(buffer.length + 16)
+		backing.set(buffer, 8)
+		const view = backing.subarray(8, 8 + buffer.length)
+
+		expect(AssParser.parse_ass_buffer(view, DEFAULT_SETTINGS)).toStrictEqual(
+			AssParser.parse_ass_buffer(buffer, DEFAULT_SETTINGS)
+		)
+	})
+
+	it("should detect UTF-16 encoded input", async () => {
+		const content = fs.readFileSync(getFilePath("test.ass"), "utf8")
+
+		// the content starts with a BOM, so this is UTF-16LE with a BOM
+		const buffer = Buffer.from(content, "utf16le")
+
+		const expected = sampleFiles[0].result as any
+		expect(sampleFiles[0].file).toBe("test.ass")
+
+		const result = AssParser.parse_ass_buffer(buffer, DEFAULT_SETTINGS)
+		expect(result).toMatchObject({
+			error: false,
+			result: {
+				events: expected.result.events,
+				file_props: { file_type: "UTF-16LE" },
+			},
+		})
+	})
+
+	it("should return an error for non Uint8Array data", async () => {
+		const result = AssParser.parse_ass_buffer(
+			"not a buffer" as any,
+			DEFAULT_SETTINGS
+		)
+		expect(result).toMatchObject({
+			error: true,
+			diagnostics: [
+				{
+					message: "source.data needs to be a Uint8Array",
+					severity: "error",
+				},
+			],
+		})
+	})
+})
+
+describe("parse_ass_file with mmap: works as expected", () => {
+	it("should return the same objects as reading the file", async () => {
+		for (const { file, result } of sampleFiles) {
+			const filePath = getFilePath(file)
+
+			const actual_result = AssParser.parse_ass_file(
+				filePath,
+				DEFAULT_SETTINGS,
+				{ mmap: true }
+			)
+			expect(actual_result).toMatchObject(result as any)
+
+			const async_result = await AssParser.parse_ass_file_async(
+				filePath,
+				DEFAULT_SETTINGS,
+				{ mmap: true }
+			)
+			expect(async_result).toStrictEqual(actual_result)
+		}
+	})
+
+	it("should keep lazy results valid after parsing returned", async () => {
+		const filePath = getFilePath("test.ass")
+
+		const lazy = AssParser.parse_ass_file(
+			filePath,
+			{ ...DEFAULT_SETTINGS, result_mode: "lazy" },
+			{ mmap: true }
+		)
+		const eager = AssParser.parse_ass_file(filePath, DEFAULT_SETTINGS)
+
+		if (lazy.error || eager.error) {
+			fail("test.ass should parse")
+		}
+
+		// the entries are only converted now, so they read the still mapped file
+		expect(lazy.result.events.slice()).toStrictEqual(eager.result.events)
+		expect(lazy.result.styles.slice()).toStrictEqual(eager.result.styles)
+	})
+
+	it("should return an error for non existent file", async () => {
+		const file = getFilePath("NON-EXISTENT.ass")
+
+		expect(fs.existsSync(file)).toBe(false)
+
+		const result = AssParser.parse_ass_file(file, DEFAULT_SETTINGS, {
+			mmap: true,
+		})
+		expect(result).toMatchObject({
+			error: true,
+			diagnostics: [{ message: "no such file", severity: "error" }],
+		})
+	})
+})
+
+describe("result_mode lazy: works as expected", () => {
+	const LAZY_SETTINGS = {
+		...DEFAULT_SETTINGS,
+		result_mode: "lazy",
+	} satisfies ParseSettingsTS
+
+	it("should return the same entries as the eager mode", async () => {
+		for (const { file, result } of sampleFiles) {
+			const filePath = getFilePath(file)
+
+			const eager_result = AssParser.parse_ass_file(
+				filePath,
+				DEFAULT_SETTINGS
+			)
+			expect(eager_result).toMatchObject(result as any)
+
+			const lazy_result = AssParser.parse_ass_file(filePath, LAZY_SETTINGS)
+
+			if (eager_result.error || lazy_result.error) {
+				expect(lazy_result).toStrictEqual(eager_result)
+				continue
+			}
+
+			const { events, styles } = lazy_result.result
+
+			expect(events.length).toBe(eager_result.result.events.length)
+			expect(styles.length).toBe(eager_result.result.styles.length)
+
+			expect([...events]).toStrictEqual(eager_result.result.events)
+			expect(styles.slice()).toStrictEqual(eager_result.result.styles)
+
+			expect(lazy_result.result.script_info).toStrictEqual(
+				eager_result.result.script_info
+			)
+		}
+	})
+
+	it("should support random access and slicing", async () => {
+		const { file } = sampleFiles[0]
+
+		const eager_result = AssParser.parse_ass_file(
+			getFilePath(file),
+			DEFAULT_SETTINGS
+		)
+		const lazy_result = await AssParser.parse_ass_file_async(
+			getFilePath(file),
+			LAZY_SETTINGS
+		)
+
+		expect(eager_result.error).toBe(false)
+		expect(lazy_result.error).toBe(false)
+
+		if (eager_result.error || lazy_result.error) {
+			return
+		}
+
+		const expected = eager_result.result.events
+		const { events } = lazy_result.result
+
+		expect(events.get(0)).toStrictEqual(expected[0])
+		expect(events.get(expected.length - 1)).toStrictEqual(
+			expected[expected.length - 1]
+		)
+		expect(events.get(expected.length)).toBeUndefined()
+		expect(events.get(-1)).toBeUndefined()
+
+		expect(events.slice(1, 3)).toStrictEqual(expected.slice(1, 3))
+		expect(events.slice(-2)).toStrictEqual(expected.slice(-2))
+		expect(events.slice(3, 1)).toStrictEqual([])
+	})
+
+	it("should reject methods called on other objects", async () => {
+		const lazy_result = AssParser.parse_ass_file(
+			getFilePath(sampleFiles[0].file),
+			LAZY_SETTINGS
+		)
+
+		if (lazy_result.error) {
+			fail("the sample should parse")
+		}
+
+		const prototype = Object.getPrototypeOf(lazy_result.result.events)
+
+		expect(() => prototype[Symbol.iterator].call({})).toThrow(TypeError)
+		expect(() => prototype.get.call({}, 0)).toThrow(TypeError)
+		expect(() => prototype.slice.call({})).toThrow(TypeError)
+	})
+
+	it("should return an error for an unknown result_mode", async () => {
+		const result = AssParser.parse_ass_string("", {
+			...DEFAULT_SETTINGS,
+			result_mode: "unknown" as any,
+		})
+		expect(result).toMatchObject({
+			error: true,
+			diagnostics: [
+				{
+					message:
+						"settings.result_mode needs to be either 'eager', 'lazy' or 'columnar'",
+					severity: "error",
+				},
+			],
+		})
+	})
+})
+
+describe("result_mode columnar: works as expected", () => {
+	const COLUMNAR_SETTINGS = {
+		...DEFAULT_SETTINGS,
+		result_mode: "columnar",
+	} satisfies ParseSettingsTS
+
+	it("should return the same events as the eager mode", async () => {
+		for (const { file } of sampleFiles) {
+			const filePath = getFilePath(file)
+
+			const eager_result = AssParser.parse_ass_file(
+				filePath,
+				DEFAULT_SETTINGS
+			)
+			const columnar_result = AssParser.parse_ass_file(
+				filePath,
+				COLUMNAR_SETTINGS
+			)
+
+			if (eager_result.error || columnar_result.error) {
+				expect(columnar_result).toStrictEqual(eager_result)
+				continue
+			}
+
+			const expected = eager_result.result.events
+			const columns = columnar_result.result.events
+
+			expect(columns.length).toBe(expected.length)
+			expect(columns.style.length).toBe(expected.length + 1)
+
+			for (let i = 0; i < columns.length; ++i) {
+				expect(AssEventColumnsReader.event(columns, i)).toStrictEqual(
+					expected[i]
+				)
+			}
+
+			expect(columnar_result.result.styles).toStrictEqual(
+				eager_result.result.styles
+			)
+		}
+	})
+
+	it("should store times in milliseconds", async () => {
+		const { file } = sampleFiles[0]
+
+		const result = AssParser.parse_ass_file(
+			getFilePath(file),
+			COLUMNAR_SETTINGS
+		)
+
+		expect(result.error).toBe(false)
+
+		if (result.error) {
+			return
+		}
+
+		const { events } = result.result
+
+		expect(events.start_ms).toBeInstanceOf(Int32Array)
+		expect(events.strings).toBeInstanceOf(ArrayBuffer)
+
+		for (let i = 0; i < events.length; ++i) {
+			expect(events.end_ms[i]).toBeGreaterThanOrEqual(events.start_ms[i])
+			expect(events.start_ms[i] % 10).toBe(0)
+		}
+	})
+})
+
+describe("projection: works as expected", () => {
+	it("should only return the projected sections and fields", async () => {
+		const { file } = sampleFiles[0]
+
+		const full_result = AssParser.parse_ass_file(
+			getFilePath(file),
+			DEFAULT_SETTINGS
+		)
+		const result = AssParser.parse_ass_file(getFilePath(file), {
+			...DEFAULT_SETTINGS,
+			projection: {
+				sections: ["script_info", "events"],
+				event_fields: ["start", "end"],
+			},
+		})
+
+		expect(full_result.error).toBe(false)
+		expect(result.error).toBe(false)
+
+		if (full_result.error || result.error) {
+			return
+		}
+
+		expect(Object.keys(result.result)).toStrictEqual([
+			"script_info",
+			"events",
+		])
+		expect(result.result.script_info).toStrictEqual(
+			full_result.result.script_info
+		)
+		expect(result.result.events).toStrictEqual(
+			full_result.result.events.map(({ start, end }) => ({ start, end }))
+		)
+	})
+
+	it("should project the lazy and columnar result modes", async () => {
+		const { file } = sampleFiles[0]
+
+		const projection = {
+			event_fields: ["layer", "text"],
+			style_fields: ["name"],
+		} satisfies ParseSettingsTS["projection"]
+
+		const full_result = AssParser.parse_ass_file(
+			getFilePath(file),
+			DEFAULT_SETTINGS
+		)
+		const lazy_result = AssParser.parse_ass_file(getFilePath(file), {
+			...DEFAULT_SETTINGS,
+			result_mode: "lazy",
+			projection,
+		})
+		const columnar_result = AssParser.parse_ass_file(getFilePath(file), {
+			...DEFAULT_SETTINGS,
+			result_mode: "columnar",
+			projection,
+		})
+
+		expect(full_result.error).toBe(false)
+		expect(lazy_result.error).toBe(false)
+		expect(columnar_result.error).toBe(false)
+
+		if (full_result.error || lazy_result.error || columnar_result.error) {
+			return
+		}
+
+		const { events, styles } = full_result.result
+
+		expect([...lazy_result.result.events]).toStrictEqual(
+			events.map(({ layer, text }) => ({ layer, text }))
+		)
+		expect([...lazy_result.result.styles]).toStrictEqual(
+			styles.map(({ name }) => ({ name }))
+		)
+
+		const columns = columnar_result.result.events
+
+		expect(Object.keys(columns)).toStrictEqual([
+			"length",
+			"layer",
+			"text",
+			"strings",
+		])
+
+		for (let i = 0; i < columns.length; ++i) {
+			expect(AssEventColumnsReader.string(columns, "text", i)).toBe(
+				events[i].text
+			)
+		}
+	})
+
+	it("should return an error for unknown fields", async () => {
+		const result = AssParser.parse_ass_string("", {
+			...DEFAULT_SETTINGS,
+			projection: { event_fields: ["start", "duration" as any] },
+		})
+		expect(result).toMatchObject({
+			error: true,
+			diagnostics: [
+				{
+					message:
+						"settings.projection.event_fields contains the unknown field 'duration'",
+					severity: "error",
+				},
+			],
+		})
+	})
+})
+
+describe("string conversion: works as expected", () => {
+	it("should convert ASCII and non ASCII values the same way", async () => {
+		const content = fs
+			.readFileSync(getFilePath("test.ass"), "utf8")
+			.replace("Hello 1", "Hällo ✓ 1")
+
+		const result = AssParser.parse_ass_string(content, DEFAULT_SETTINGS)
+		const expected = sampleFiles[0].result as any
+
+		expect(result).toMatchObject({
+			error: false,
+			result: {
+				events: expected.result.events.map(
+					(event: { text: string }, index: number) =>
+						index === 0 ? { ...event, text: "Hällo ✓ 1" } : event
+				),
+			},
+		})
+	})
+
+	it("should return the same values with external strings", async () => {
+		for (const { file } of sampleFiles) {
+			const filePath = getFilePath(file)
+
+			const result = AssParser.parse_ass_file(filePath, DEFAULT_SETTINGS)
+
+			const external_result = AssParser.parse_ass_file(filePath, {
+				...DEFAULT_SETTINGS,
+				external_strings: true,
+			})
+			expect(external_result).toStrictEqual(result)
+
+			const lazy_result = AssParser.parse_ass_file(filePath, {
+				...DEFAULT_SETTINGS,
+				result_mode: "lazy",
+				external_strings: true,
+			})
+
+			if (result.error || lazy_result.error) {
+				expect(lazy_result.error).toBe(result.error)
+				continue
+			}
+
+			expect([...lazy_result.result.events]).toStrictEqual(
+				result.result.events
+			)
+		}
+	})
+})
+
+describe("cache: works as expected", () => {
+	afterEach(() => {
+		AssParser.cache_configure({ enabled: false, max_bytes: 0 })
+		AssParser.cache_clear()
+	})
+
+	it("should be disabled by default", async () => {
+		AssParser.parse_ass_file(getFilePath("test.ass"), DEFAULT_SETTINGS)
+
+		expect(AssParser.cache_stats).toMatchObject({
+			enabled: false,
+			entries: 0,
+			hits: 0,
+		})
+	})
+
+	it("should return the same results on a hit", async () => {
+		AssParser.cache_configure({ enabled: true, max_bytes: 64 * 1024 * 1024 })
+
+		const file = getFilePath("test.ass")
+
+		const first = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+		const second = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+		const third = await AssParser.parse_ass_file_async(file, DEFAULT_SETTINGS)
+
+		expect(second).toStrictEqual(first)
+		expect(third).toStrictEqual(first)
+		expect(AssParser.cache_stats).toMatchObject({
+			entries: 1,
+			hits: 2,
+			misses: 1,
+		})
+
+		const content = fs.readFileSync(file)
+
+		const string_first = AssParser.parse_ass_buffer(content, DEFAULT_SETTINGS)
+		const string_second = AssParser.parse_ass_buffer(
+			Buffer.from(content),
+			DEFAULT_SETTINGS
+		)
+
+		expect(string_second).toStrictEqual(string_first)
+		expect(AssParser.cache_stats).toMatchObject({
+			entries: 2,
+			hits: 3,
+			misses: 2,
+		})
+	})
+
+	it("should key relative paths on the file they resolve to", async () => {
+		AssParser.cache_configure({ enabled: true, max_bytes: 64 * 1024 * 1024 })
+
+		const content = fs.readFileSync(getFilePath("test.ass"), "utf8")
+		const cwd = process.cwd()
+		const dirs = ["A", "B"].map((title) => {
+			const dir = fs.mkdtempSync(path.join(os.tmpdir(), "ass-parser-"))
+			const file = path.join(dir, "same.ass")
+
+			// same size and modification time, only the title differs
+			fs.writeFileSync(
+				file,
+				content.replace(/^Title: .*$/m, `Title: ${title}`)
+			)
+			fs.utimesSync(file, 1_000_000, 1_000_000)
+
+			return dir
+		})
+
+		try {
+			const titles = dirs.map((dir) => {
+				process.chdir(dir)
+
+				const result = AssParser.parse_ass_file("same.ass", DEFAULT_SETTINGS)
+
+				return result.error ? null : result.result.script_info.title
+			})
+
+			expect(titles).toStrictEqual(["A", "B"])
+			expect(AssParser.cache_stats).toMatchObject({ hits: 0, misses: 2 })
+		} finally {
+			process.chdir(cwd)
+
+			for (const dir of dirs) {
+				fs.rmSync(dir, { recursive: true, force: true })
+			}
+		}
+	})
+
+	it("should key on the parse settings", async () => {
+		AssParser.cache_configure({ enabled: true, max_bytes: 64 * 1024 * 1024 })
+
+		const file = getFilePath("test.ass")
+
+		AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+		AssParser.parse_ass_file(file, {
+			...DEFAULT_SETTINGS,
+			validate_settings: "nothing",
+		})
+
+		expect(AssParser.cache_stats).toMatchObject({
+			entries: 2,
+			hits: 0,
+			misses: 2,
+		})
+	})
+
+	it("should evict the least recently used results", async () => {
+		AssParser.cache_configure({ enabled: true, max_bytes: 64 * 1024 * 1024 })
+
+		for (const { file } of sampleFiles) {
+			AssParser.parse_ass_file(getFilePath(file), DEFAULT_SETTINGS)
+		}
+
+		const { bytes, entries } = AssParser.cache_stats
+		expect(entries).toBeGreaterThan(1)
+
+		// only leaves space for roughly one result
+		AssParser.cache_configure({
+			enabled: true,
+			max_bytes: Math.floor(bytes / entries),
+		})
+
+		const stats = AssParser.cache_stats
+		expect(stats.entries).toBeLessThan(entries)
+		expect(stats.evictions).toBe(entries - stats.entries)
+		expect(stats.bytes).toBeLessThanOrEqual(stats.max_bytes)
+	})
+})
+
+describe("profile: works as expected", () => {
+	it("should not add timings and counters by default", async () => {
+		const result = AssParser.parse_ass_file(
+			getFilePath("test.ass"),
+			DEFAULT_SETTINGS
+		)
+
+		expect(result.timings).toBeUndefined()
+		expect(result.counters).toBeUndefined()
+	})
+
+	it("should add timings and counters", async () => {
+		const file = getFilePath("test.ass")
+
+		const plain = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+		const result = AssParser.parse_ass_file(file, {
+			...DEFAULT_SETTINGS,
+			profile: true,
+		})
+
+		if (result.error || plain.error) {
+			fail("parse errored")
+		}
+
+		const { timings, counters, ...rest } = result
+
+		expect(rest).toStrictEqual(plain)
+
+		expect(timings?.read_ns).toBe(0)
+		expect(timings?.parse_ns).toBeGreaterThan(0)
+		expect(timings?.convert_ns).toBeGreaterThan(0)
+
+		expect(counters).toStrictEqual({
+			bytes_read: fs.statSync(file).size,
+			events: result.result.events.length,
+			styles: result.result.styles.length,
+			strings_created: expect.any(Number),
+			diagnostics: result.diagnostics.length,
+			cached: false,
+		})
+		expect(counters?.strings_created).toBeGreaterThan(0)
+	})
+
+	it("should time mapping files", async () => {
+		const file = getFilePath("test.ass")
+
+		const result = AssParser.parse_ass_file(
+			file,
+			{ ...DEFAULT_SETTINGS, profile: true },
+			{ mmap: true }
+		)
+
+		expect(result.timings?.read_ns).toBeGreaterThan(0)
+		expect(result.counters?.bytes_read).toBe(fs.statSync(file).size)
+	})
+
+	it("should report cache hits", async () => {
+		AssParser.cache_configure({ enabled: true, max_bytes: 64 * 1024 * 1024 })
+
+		try {
+			const settings: ParseSettingsTS = { ...DEFAULT_SETTINGS, profile: true }
+			const file = getFilePath("test.ass")
+
+			const first = await AssParser.parse_ass_file_async(file, settings)
+			const second = await AssParser.parse_ass_file_async(file, settings)
+
+			expect(first.counters?.cached).toBe(false)
+			expect(second.counters?.cached).toBe(true)
+		} finally {
+			AssParser.cache_configure({ enabled: false, max_bytes: 0 })
+			AssParser.cache_clear()
+		}
+	})
+
+	it("should add them to every batch result", async () => {
+		const results = await AssParser.parse_ass_batch(
+			[
+				{ type: "file", name: getFilePath("test.ass") },
+				{ type: "string", content: "" },
+			],
+			{ ...DEFAULT_SETTINGS, profile: true }
+		)
+
+		expect(results[0].counters?.events).toBeGreaterThan(0)
+		expect(results[1].counters).toMatchObject({ bytes_read: 0, events: 0 })
+	})
+
+	it("should reject invalid values", async () => {
+		const result = AssParser.parse_ass_file(getFilePath("test.ass"), {
+			...DEFAULT_SETTINGS,
+			profile: "yes" as unknown as boolean,
+		})
+
+		expect(result.error).toBe(true)
+		expect(result.diagnostics[0].message).toBe(
+			"settings.profile needs to be a boolean"
+		)
+	})
+})
+
+describe("time_format and color_format: works as expected", () => {
+	it("should return times as integers", async () => {
+		const file = getFilePath("test.ass")
+
+		const objects = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+		const centiseconds = AssParser.parse_ass_file(file, {
+			...DEFAULT_SETTINGS,
+			time_format: "centiseconds",
+		})
+		const milliseconds = await AssParser.parse_ass_file_async(file, {
+			...DEFAULT_SETTINGS,
+			time_format: "milliseconds",
+			result_mode: "lazy",
+		})
+
+		if (objects.error || centiseconds.error || milliseconds.error) {
+			fail("parse errored")
+		}
+
+		expect(objects.result.events.length).toBeGreaterThan(0)
+
+		objects.result.events.forEach((event, i) => {
+			const start_ms = centiseconds.result.events[i].start * 10
+
+			expect(AssEventColumnsReader.ms_to_time(start_ms)).toStrictEqual(
+				event.start
+			)
+			expect(milliseconds.result.events.get(i)?.end).toBe(
+				centiseconds.result.events[i].end * 10
+			)
+		})
+	})
+
+	it("should return colours as packed integers", async () => {
+		const file = getFilePath("test.ass")
+
+		const objects = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+		const packed = AssParser.parse_ass_file(file, {
+			...DEFAULT_SETTINGS,
+			color_format: "packed",
+		})
+
+		if (objects.error || packed.error) {
+			fail("parse errored")
+		}
+
+		expect(objects.result.styles.length).toBeGreaterThan(0)
+
+		objects.result.styles.forEach((style, i) => {
+			const packed_style = packed.result.styles[i]
+
+			expect(PackedColor.unpack(packed_style.primary_colour)).toStrictEqual(
+				style.primary_colour
+			)
+			expect(packed_style.back_colour).toBe(
+				PackedColor.pack(style.back_colour)
+			)
+			expect(packed_style.name).toBe(style.name)
+		})
+	})
+
+	it("should reject invalid values", async () => {
+		const file = getFilePath("test.ass")
+
+		const time_result = AssParser.parse_ass_file(file, {
+			...DEFAULT_SETTINGS,
+			time_format: "seconds" as "object",
+		})
+
+		expect(time_result.error).toBe(true)
+		expect(time_result.diagnostics[0].message).toBe(
+			"settings.time_format needs to be either 'object', 'centiseconds' or 'milliseconds'"
+		)
+
+		const color_result = AssParser.parse_ass_file(file, {
+			...DEFAULT_SETTINGS,
+			color_format: "hex" as "object",
+		})
+
+		expect(color_result.error).toBe(true)
+		expect(color_result.diagnostics[0].message).toBe(
+			"settings.color_format needs to be either 'object' or 'packed'"
+		)
+	})
+})
+
+describe("lint_ass: works as expected", () => {
+	it("should return the same diagnostics as parsing", async () => {
+		for (const name of ["test.ass", "incorrect.ass"]) {
+			const file = getFilePath(name)
+
+			const parsed = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+			const linted = AssParser.lint_ass_file(file, DEFAULT_SETTINGS)
+
+			expect(linted).toStrictEqual({
+				error: parsed.error,
+				diagnostics: parsed.diagnostics,
+			})
+		}
+	})
+
+	it("should report errors", async () => {
+		const content = fs.readFileSync(getFilePath("incorrect.ass"), "utf8")
+
+		const result = AssParser.lint_ass_string(content, DEFAULT_SETTINGS)
+
+		expect(result).toMatchObject({
+			error: true,
+			diagnostics: [
+				{
+					message: "first line must be the script info section",
+					severity: "error",
+				},
+			],
+		})
+	})
+
+	it("should not use the cache", async () => {
+		AssParser.cache_configure({ enabled: true, max_bytes: 64 * 1024 * 1024 })
+
+		try {
+			const content = fs.readFileSync(getFilePath("test.ass"))
+
+			AssParser.lint_ass_buffer(content, DEFAULT_SETTINGS)
+
+			expect(AssParser.cache_stats).toMatchObject({ entries: 0, misses: 0 })
+		} finally {
+			AssParser.cache_configure({ enabled: false, max_bytes: 0 })
+			AssParser.cache_clear()
+		}
+	})
+})
+
+describe("compile_settings: works as expected", () => {
+	it("should return the same results as the settings object", async () => {
+		const settings: ParseSettingsTS = {
+			...DEFAULT_SETTINGS,
+			time_format: "milliseconds",
+			projection: { event_fields: ["start", "end", "text"] },
+		}
+		const compiled = AssParser.compile_settings(settings)
+
+		const file = getFilePath("test.ass")
+		const content = fs.readFileSync(file)
+
+		expect(AssParser.parse_ass_file(file, compiled)).toStrictEqual(
+			AssParser.parse_ass_file(file, settings)
+		)
+		expect(AssParser.parse_ass_buffer(content, compiled)).toStrictEqual(
+			AssParser.parse_ass_buffer(content, settings)
+		)
+		expect(await AssParser.parse_ass_file_async(file, compiled)).toStrictEqual(
+			await AssParser.parse_ass_file_async(file, settings)
+		)
+		expect(
+			await AssParser.parse_ass_batch([{ type: "file", name: file }], compiled)
+		).toStrictEqual(
+			await AssParser.parse_ass_batch([{ type: "file", name: file }], settings)
+		)
+		expect(AssParser.lint_ass_file(file, compiled)).toStrictEqual(
+			AssParser.lint_ass_file(file, settings)
+		)
+	})
+
+	it("should be reusable", async () => {
+		const compiled = AssParser.compile_settings(DEFAULT_SETTINGS)
+
+		const file = getFilePath("test.ass")
+
+		const first = AssParser.parse_ass_file(file, compiled)
+		const second = AssParser.parse_ass_file(file, compiled)
+
+		expect(first.error).toBe(false)
+		expect(second).toStrictEqual(first)
+	})
+
+	it("should throw on invalid settings", async () => {
+		expect(() =>
+			AssParser.compile_settings({
+				...DEFAULT_SETTINGS,
+				result_mode: "fast" as "eager",
+			})
+		).toThrow(
+			"settings.result_mode needs to be either 'eager', 'lazy' or 'columnar'"
+		)
+	})
+})
+
+describe("serialize and deserialize: works as expected", () => {
+	it("should round-trip the sample files", async () => {
+		for (const { file, result } of sampleFiles) {
+			const filePath = getFilePath(file)
+
+			const snapshot = AssParser.serialize_ass_file(filePath, DEFAULT_SETTINGS)
+
+			if (snapshot.error) {
+				fail("serialize errored")
+			}
+
+			const loaded = AssParser.deserialize(snapshot.result)
+
+			expect(loaded).toMatchObject(result as any)
+			expect(loaded).toStrictEqual(
+				AssParser.parse_ass_file(filePath, DEFAULT_SETTINGS)
+			)
+		}
+	})
+
+	it("should round-trip non ASCII content", async () => {
+		const content = fs
+			.readFileSync(getFilePath("test.ass"), "utf8")
+			.replace(/Default/g, "Défault ✓")
+
+		const snapshot = AssParser.serialize_ass_string(content, DEFAULT_SETTINGS)
+
+		if (snapshot.error) {
+			fail("serialize errored")
+		}
+
+		expect(AssParser.deserialize(snapshot.result)).toStrictEqual(
+			AssParser.parse_ass_string(content, DEFAULT_SETTINGS)
+		)
+	})
+
+	it("should apply the conversion settings", async () => {
+		const file = getFilePath("test.ass")
+		const settings: ParseSettingsTS = {
+			...DEFAULT_SETTINGS,
+			time_format: "centiseconds",
+			color_format: "packed",
+			projection: { sections: ["events", "styles"], event_fields: ["start"] },
+		}
+
+		const snapshot = AssParser.serialize_ass_file(file, DEFAULT_SETTINGS)
+
+		if (snapshot.error) {
+			fail("serialize errored")
+		}
+
+		expect(AssParser.deserialize(snapshot.result, settings)).toStrictEqual(
+			AssParser.parse_ass_file(file, settings)
+		)
+	})
+
+	it("should be smaller than the JSON of the result", async () => {
+		const file = getFilePath("ass-format-tests.ass")
+
+		const snapshot = AssParser.serialize_ass_file(file, DEFAULT_SETTINGS)
+		const parsed = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+
+		if (snapshot.error || parsed.error) {
+			fail("parse errored")
+		}
+
+		expect(snapshot.result.length).toBeLessThan(
+			JSON.stringify(parsed.result).length
+		)
+	})
+
+	it("should return errors for parse errors and invalid snapshots", async () => {
+		const failed = AssParser.serialize_ass_file(
+			getFilePath("incorrect.ass"),
+			DEFAULT_SETTINGS
+		)
+
+		expect(failed.error).toBe(true)
+
+		const snapshot = AssParser.serialize_ass_file(
+			getFilePath("test.ass"),
+			DEFAULT_SETTINGS
+		)
+
+		if (snapshot.error) {
+			fail("serialize errored")
+		}
+
+		expect(AssParser.deserialize(Buffer.from("no snapshot"))).toMatchObject({
+			error: true,
+			diagnostics: [{ message: "invalid snapshot: the snapshot is too small" }],
+		})
+
+		const truncated = snapshot.result.subarray(0, snapshot.result.length - 1)
+
+		expect(AssParser.deserialize(truncated).error).toBe(true)
+
+		const other_version = Buffer.from(snapshot.result)
+		other_version.writeUInt32LE(0xffff, 8)
+
+		expect(AssParser.deserialize(other_version)).toMatchObject({
+			error: true,
+			diagnostics: [
+				{
+					message:
+						"invalid snapshot: unsupported snapshot version 65535, expected 1",
+				},
+			],
+		})
+
+		expect(
+			AssParser.deserialize(snapshot.result, { result_mode: "lazy" }).error
+		).toBe(true)
+	})
+})
+
+describe("event_index: works as expected", () => {
+	it("should return the events shown at a time", async () => {
+		const result = AssParser.parse_ass_file(getFilePath("test.ass"), {
+			...DEFAULT_SETTINGS,
+			event_index: true,
+		})
+
+		if (result.error || result.event_index === undefined) {
+			fail("parse errored")
+		}
+
+		const index = result.event_index
+
+		expect(index.length).toBe(3)
+		expect(Array.from(index.active_at(0))).toStrictEqual([0])
+		expect(Array.from(index.active_at(4999.5))).toStrictEqual([0])
+		expect(Array.from(index.active_at(5000))).toStrictEqual([1])
+		expect(Array.from(index.active_at(11000))).toStrictEqual([])
+		expect(Array.from(index.active_at(-1))).toStrictEqual([])
+		expect(Array.from(index.active_at(NaN))).toStrictEqual([])
+
+		expect(Array.from(index.range(4000, 9000))).toStrictEqual([0, 1, 2])
+		expect(Array.from(index.range(5000, 8000))).toStrictEqual([1])
+		expect(Array.from(index.range(8000, 5000))).toStrictEqual([])
+	})
+
+	it("should match filtering the events", async () => {
+		for (const file of ["ass-format-tests.ass", "ass-format-tests-new.ass"]) {
+			const result = AssParser.parse_ass_file(getFilePath(file), {
+				...DEFAULT_SETTINGS,
+				time_format: "milliseconds",
+				event_index: true,
+			})
+
+			if (result.error || result.event_index === undefined) {
+				fail("parse errored")
+			}
+
+			const events = result.result.events
+			const index = result.event_index
+
+			const last_end = Math.max(...events.map((event) => event.end))
+
+			for (let time = -500; time <= last_end + 500; time += 250) {
+				const active = events.flatMap((event, i) =>
+					event.start <= time && time < event.end ? [i] : []
+				)
+
+				expect(Array.from(index.active_at(time))).toStrictEqual(active)
+
+				const shown = events.flatMap((event, i) =>
+					event.start < event.end &&
+					event.start < time + 1000 &&
+					event.end > time
+						? [i]
+						: []
+				)
+
+				expect(Array.from(index.range(time, time + 1000))).toStrictEqual(shown)
+			}
+		}
+	})
+
+	it("should be built by every entry point", async () => {
+		const file = getFilePath("test.ass")
+		const settings: ParseSettingsTS = { ...DEFAULT_SETTINGS, event_index: true }
+
+		const async_result = await AssParser.parse_ass_file_async(file, settings)
+
+		if (async_result.error || async_result.event_index === undefined) {
+			fail("parse errored")
+		}
+
+		expect(Array.from(async_result.event_index.active_at(9000))).toStrictEqual([2])
+
+		const snapshot = AssParser.serialize_ass_file(file, DEFAULT_SETTINGS)
+
+		if (snapshot.error) {
+			fail("serialize errored")
+		}
+
+		const loaded = AssParser.deserialize(snapshot.result, { event_index: true })
+
+		if (loaded.error || loaded.event_index === undefined) {
+			fail("deserialize errored")
+		}
+
+		expect(Array.from(loaded.event_index.active_at(9000))).toStrictEqual([2])
+
+		const without = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+
+		expect(without).not.toHaveProperty("event_index")
+	})
+
+	it("should be created from columnar events", async () => {
+		const result = AssParser.parse_ass_file(getFilePath("test.ass"), {
+			...DEFAULT_SETTINGS,
+			result_mode: "columnar",
+		})
+
+		if (result.error) {
+			fail("parse errored")
+		}
+
+		const { start_ms, end_ms } = result.result.events
+
+		const index = AssParser.create_event_index(start_ms, end_ms)
+
+		expect(index.length).toBe(3)
+		expect(Array.from(index.active_at(6000))).toStrictEqual([1])
+
+		expect(() =>
+			AssParser.create_event_index(start_ms, end_ms.subarray(1))
+		).toThrow(
+			"the 'start_ms' and 'end_ms' arguments need to have the same length"
+		)
+	})
+
+	it("should reject invalid settings", async () => {
+		const result = AssParser.parse_ass_file(getFilePath("test.ass"), {
+			...DEFAULT_SETTINGS,
+			event_index: "yes" as any,
+		})
+
+		expect(result).toMatchObject({
+			error: true,
+			diagnostics: [{ message: "settings.event_index needs to be a boolean" }],
+		})
+	})
+})
+
+describe("documents: works as expected", () => {
+	const content = fs.readFileSync(getFilePath("test.ass"), "utf8")
+
+	function expectSameAsParsing(document: AssDocument) {
+		const parsed = AssParser.parse_ass_string(document.text(), DEFAULT_SETTINGS)
+
+		expect(document.diagnostics()).toStrictEqual(parsed.diagnostics)
+		expect(document.error).toBe(parsed.error)
+
+		if (!parsed.error) {
+			expect(document.events()).toStrictEqual(parsed.result.events)
+			expect(document.styles()).toStrictEqual(parsed.result.styles)
+		}
+	}
+
+	it("should parse the content", async () => {
+		const document = AssParser.create_document(content, DEFAULT_SETTINGS)
+
+		expect(document.text()).toBe(content.replace(/\r\n/g, "\n"))
+		expect(document.events(1, 2)).toStrictEqual([document.events()[1]])
+
+		expectSameAsParsing(document)
+	})
+
+	it("should only parse changed event lines", async () => {
+		const document = AssParser.create_document(content, DEFAULT_SETTINGS)
+
+		const changed = document.edit(20, 21, [
+			"Dialogue: 0,0:00:01.00,0:00:04.00,Default,,0,0,0,,Changed",
+		])
+
+		expect(changed).toMatchObject({
+			error: false,
+			full_reparse: false,
+			events: { start: 0, removed: 1, inserted: 1 },
+			styles: { start: 0, removed: 0, inserted: 0 },
+		})
+		expect(document.events(0, 1)[0]).toMatchObject({ text: "Changed" })
+		expectSameAsParsing(document)
+
+		const inserted = document.edit(21, 21, [
+			"Dialogue: 0,0:00:02.00,0:00:03.00,Default,,0,0,0,,New 1",
+			"; a comment",
+			"Dialogue: 0,0:00:02.00,0:00:03.00,Default,,0,0,0,,New 2",
+		])
+
+		expect(inserted).toMatchObject({
+			full_reparse: false,
+			events: { start: 1, removed: 0, inserted: 2 },
+		})
+		expect(document.events().length).toBe(5)
+		expectSameAsParsing(document)
+
+		const removed = document.edit(21, 25, [])
+
+		expect(removed).toMatchObject({
+			full_reparse: false,
+			events: { start: 1, removed: 3, inserted: 0 },
+		})
+		expect(document.events().length).toBe(2)
+		expectSameAsParsing(document)
+	})
+
+	it("should parse everything for other edits", async () => {
+		const document = AssParser.create_document(content, DEFAULT_SETTINGS)
+
+		const changed = document.edit(15, 16, [
+			"Style: Style 2,Arial,30,&H00FFFFFF,&H00FF002D,&H008E8E8E,&H00000000,-1,0,0,0,100,100,0,0,1,3,0,5,20,20,6,1",
+		])
+
+		expect(changed).toMatchObject({
+			full_reparse: true,
+			events: { start: 0, removed: 3, inserted: 3 },
+			styles: { start: 0, removed: 3, inserted: 3 },
+		})
+		expect(document.styles(1, 2)[0]).toMatchObject({ fontsize: 30 })
+		expectSameAsParsing(document)
+	})
+
+	it("should recover from errors", async () => {
+		const document = AssParser.create_document(
+			"hello i am incorrect",
+			DEFAULT_SETTINGS
+		)
+
+		expect(document.error).toBe(true)
+		expect(document.events()).toStrictEqual([])
+
+		const fixed = document.edit(0, 1, content.split(/\r?\n/))
+
+		expect(fixed).toMatchObject({ error: false, full_reparse: true })
+		expectSameAsParsing(document)
+	})
+
+	it("should reject invalid edits", async () => {
+		const document = AssParser.create_document(content, DEFAULT_SETTINGS)
+
+		expect(() => document.edit(2, 1, [])).toThrow(
+			"the 'start' and 'end' arguments need to be line indices with start <= end <= line_count"
+		)
+		expect(() => document.edit(0, document.line_count + 1, [])).toThrow()
+		expect(() => document.edit(0, 0, ["a\nb"])).toThrow(
+			"the 'lines' argument must not contain line breaks"
+		)
+		expect(() => document.edit(0, 0, [1 as any])).toThrow(
+			"the 'lines' argument needs to be an array of strings"
+		)
+	})
+})
+
+describe("json: works as expected", () => {
+	function parseJson(buffer: Buffer): unknown {
+		expect(buffer).toBeInstanceOf(Buffer)
+
+		return JSON.parse(buffer.toString("utf8"))
+	}
+
+	function expectSameJson(json: Buffer, result: unknown) {
+		expect(parseJson(json)).toStrictEqual(JSON.parse(JSON.stringify(result)))
+	}
+
+	it("should write the same result as parsing", async () => {
+		for (const { file } of sampleFiles) {
+			const filePath = getFilePath(file)
+
+			expectSameJson(
+				AssParser.parse_ass_file_json(filePath, DEFAULT_SETTINGS),
+				AssParser.parse_ass_file(filePath, DEFAULT_SETTINGS)
+			)
+
+			expectSameJson(
+				await AssParser.parse_ass_file_json_async(filePath, DEFAULT_SETTINGS),
+				AssParser.parse_ass_file(filePath, DEFAULT_SETTINGS)
+			)
+		}
+	})
+
+	it("should apply the conversion settings", async () => {
+		const settings: ParseSettingsTS = {
+			...DEFAULT_SETTINGS,
+			time_format: "milliseconds",
+			color_format: "packed",
+			projection: {
+				sections: ["styles", "events"],
+				event_fields: ["start", "end", "text"],
+			},
+		}
+
+		const filePath = getFilePath("test.ass")
+
+		expectSameJson(
+			AssParser.parse_ass_file_json(filePath, settings),
+			AssParser.parse_ass_file(filePath, settings)
+		)
+	})
+
+	it("should escape strings", async () => {
+		const content = fs
+			.readFileSync(getFilePath("test.ass"), "utf8")
+			.replace("Hello 1", 'quote " backslash \\ tab \t bell \u0007 ü 😀')
+
+		const json = AssParser.parse_ass_string_json(content, DEFAULT_SETTINGS)
+
+		expect(json.toString("utf8")).toContain(
+			'"quote \\" backslash \\\\ tab \\t bell \\u0007 ü 😀"'
+		)
+	})
+
+	it("should write numbers like JSON.stringify", async () => {
+		const content = fs
+			.readFileSync(getFilePath("test.ass"), "utf8")
+			.replace("100,100,0.3,-232,", "100,100,100000,0.0000001,")
+
+		const json = AssParser.parse_ass_string_json(content, DEFAULT_SETTINGS)
+		const result = AssParser.parse_ass_string(content, DEFAULT_SETTINGS)
+
+		if (result.error) {
+			fail("the modified test.ass should parse")
+		}
+
+		const [style] = result.result.styles
+
+		expect(json.toString("utf8")).toContain(
+			`"spacing":100000,"angle":${JSON.stringify(style.angle)},`
+		)
+	})
+
+	it("should write errors", async () => {
+		const json = AssParser.parse_ass_string_json(
+			"hello i am incorrect",
+			DEFAULT_SETTINGS
+		)
+
+		expect(parseJson(json)).toMatchObject({ error: true })
+
+		expect(
+			parseJson(
+				AssParser.parse_ass_string_json("", {
+					...DEFAULT_SETTINGS,
+					time_format: "invalid" as any,
+				})
+			)
+		).toMatchObject({ error: true })
+	})
+})
+
+describe("iterate_events: works as expected", () => {
+	const file = getFilePath("test.ass")
+	const source: AssSource = { type: "file", name: file }
+
+	async function collect(iterable: AsyncIterable<unknown>) {
+		const values: unknown[] = []
+
+		for await (const value of iterable) {
+			values.push(value)
+		}
+
+		return values
+	}
+
+	it("should return every event", async () => {
+		const parsed = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+
+		if (parsed.error) {
+			fail("the sample file should parse")
+		}
+
+		for (const batch_size of [1, 2, 1000]) {
+			const events = await collect(
+				AssParser.iterate_events(source, DEFAULT_SETTINGS, { batch_size })
+			)
+
+			expect(events).toStrictEqual(parsed.result.events)
+		}
+
+		const compiled = AssParser.compile_settings(DEFAULT_SETTINGS)
+
+		expect(
+			await collect(AssParser.iterate_events(source, compiled))
+		).toStrictEqual(parsed.result.events)
+	})
+
+	it("should only convert events, when they are requested", async () => {
+		const iterator = AssParser.iterate_events(source, DEFAULT_SETTINGS, {
+			batch_size: 1,
+		})
+
+		const first = await iterator.next()
+
+		expect(first.done).toBe(false)
+		expect(first.value).toMatchObject({ text: "Hello 1" })
+
+		// stopping early is fine, the rest is never converted
+		await iterator.return()
+
+		expect(await iterator.next()).toStrictEqual({
+			done: true,
+			value: undefined,
+		})
+	})
+
+	it("should throw parse errors", async () => {
+		const iterator = AssParser.iterate_events(
+			{ type: "string", content: "hello i am incorrect" },
+			DEFAULT_SETTINGS
+		)
+
+		await expect(collect(iterator)).rejects.toBeInstanceOf(AssParseError)
+
+		await expect(
+			collect(
+				AssParser.iterate_events(source, DEFAULT_SETTINGS, {
+					batch_size: 0,
+				})
+			)
+		).rejects.toThrow("options.batch_size needs to be a positive integer")
+	})
+})
+
+describe("stream parser: works as expected", () => {
+	const file = getFilePath("test.ass")
+
+	function collect(chunks: AssStreamChunk[]) {
+		const kinds = chunks.map((chunk) => chunk.kind)
+		const events = chunks.flatMap((chunk) =>
+			chunk.kind === "events" ? chunk.events : []
+		)
+		const header = chunks.find((chunk) => chunk.kind === "header")
+		const end = chunks.find((chunk) => chunk.kind === "end")
+
+		return { kinds, events, header, end }
+	}
+
+	function expectSameAsParsing(
+		chunks: AssStreamChunk[],
+		parsed = AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+	) {
+		if (parsed.error) {
+			fail("the sample file should parse")
+		}
+
+		const { events, header, end } = collect(chunks)
+
+		expect(events).toStrictEqual(parsed.result.events)
+		expect(header).toMatchObject({
+			script_info: parsed.result.script_info,
+			styles: parsed.result.styles,
+		})
+		expect(end).toMatchObject({
+			extra_sections: parsed.result.extra_sections,
+			file_props: parsed.result.file_props,
+		})
+	}
+
+	it("should emit the events in batches", async () => {
+		const parser = AssParser.create_stream_parser(DEFAULT_SETTINGS, {
+			batch_size: 2,
+		})
+
+		const data = fs.readFileSync(file)
+		const chunks: AssStreamChunk[] = []
+
+		// split in the middle of lines
+		for (let i = 0; i < data.length; i += 7) {
+			chunks.push(...parser.feed(data.subarray(i, i + 7)))
+		}
+
+		chunks.push(...parser.end())
+
+		expect(collect(chunks).kinds).toStrictEqual([
+			"header",
+			"events",
+			"events",
+			"end",
+		])
+		expectSameAsParsing(chunks)
+	})
+
+	it("should work as a Transform", async () => {
+		const chunks: AssStreamChunk[] = []
+
+		const stream = fs
+			.createReadStream(file, { highWaterMark: 16 })
+			.pipe(AssParser.parse_stream(DEFAULT_SETTINGS, { batch_size: 1 }))
+
+		for await (const chunk of stream) {
+			chunks.push(chunk)
+		}
+
+		expect(collect(chunks).kinds).toStrictEqual([
+			"header",
+			"events",
+			"events",
+			"events",
+			"end",
+		])
+		expectSameAsParsing(chunks)
+	})
+
+	it("should keep the sections before and after the events", async () => {
+		// test.ass has an [Aegisub Project Garbage] section before the events
+		const content =
+			fs.readFileSync(file, "utf8") + "\n[Fonts]\nfontname: a.ttf\n"
+
+		const parser = AssParser.create_stream_parser(DEFAULT_SETTINGS, {
+			batch_size: 1,
+		})
+
+		const chunks = [
+			...parser.feed(Buffer.from(content)),
+			...parser.end(),
+		]
+
+		expect(collect(chunks).kinds).toStrictEqual([
+			"header",
+			"events",
+			"events",
+			"events",
+			"end",
+		])
+		expectSameAsParsing(
+			chunks,
+			AssParser.parse_ass_string(content, DEFAULT_SETTINGS)
+		)
+	})
+
+	it("should parse scripts without events", async () => {
+		const content = "[Script Info]\nScriptType: v4.00+\n"
+
+		const stream = Readable.from([Buffer.from(content)]).pipe(
+			AssParser.parse_stream(DEFAULT_SETTINGS)
+		)
+
+		const chunks: AssStreamChunk[] = []
+
+		for await (const chunk of stream) {
+			chunks.push(chunk)
+		}
+
+		const parsed = AssParser.parse_ass_string(content, DEFAULT_SETTINGS)
+
+		expect(collect(chunks).kinds).toStrictEqual([
+			parsed.error ? "error" : "header",
+			...(parsed.error ? [] : ["events", "end"]),
+		])
+	})
+
+	it("should reject unsupported scripts", async () => {
+		const utf16 = AssParser.create_stream_parser(DEFAULT_SETTINGS)
+
+		expect(
+			utf16.feed(Buffer.from("\uFEFF[Script Info]\n", "utf16le"))
+		).toMatchObject([
+			{
+				kind: "error",
+				diagnostics: [
+					{
+						message: "the stream parser only supports UTF-8 scripts",
+						severity: "error",
+					},
+				],
+			},
+		])
+		expect(utf16.end()).toStrictEqual([])
+
+		const no_format = AssParser.create_stream_parser(DEFAULT_SETTINGS)
+
+		expect(
+			no_format.feed(
+				Buffer.from(
+					"[Events]\nDialogue: 0,0:00:01.00,0:00:04.00,Default,,0,0,0,,Text\n"
+				)
+			)
+		).toMatchObject([{ kind: "error" }])
+
+		expect(() =>
+			AssParser.create_stream_parser(DEFAULT_SETTINGS, { batch_size: 0 })
+		).toThrow("the 'batch_size' argument needs to be a positive integer")
+		expect(() =>
+			AssParser.create_stream_parser({
+				...DEFAULT_SETTINGS,
+				result_mode: "lazy",
+			})
+		).toThrow("the stream parser only supports the result_mode 'eager'")
+	})
+})
+
+describe("write_ass: works as expected", () => {
+	function parseWritten(script: Buffer) {
+		expect(script).toBeInstanceOf(Buffer)
+
+		return AssParser.parse_ass_buffer(script, DEFAULT_SETTINGS)
+	}
+
+	it("should write scripts, that parse to the same result", async () => {
+		for (const { file } of sampleFiles) {
+			const parsed = AssParser.parse_ass_file(
+				getFilePath(file),
+				DEFAULT_SETTINGS
+			)
+
+			if (parsed.error) {
+				continue
+			}
+
+			const script = AssParser.write_ass(parsed.result)
+			const reparsed = parseWritten(script)
+
+			if (reparsed.error) {
+				fail(`the written ${file} should parse`)
+			}
+
+			// the positions of the diagnostics are different in the written script
+			expect(reparsed.result).toStrictEqual(parsed.result)
+
+			// writing is stable, so the script is the same after every round trip
+			expect(AssParser.write_ass(reparsed.result)).toStrictEqual(script)
+		}
+	})
+
+	it("should write the events of ass-format-tests.ass like the source", async () => {
+		const filePath = getFilePath("ass-format-tests.ass")
+		const parsed = AssParser.parse_ass_file(filePath, DEFAULT_SETTINGS)
+
+		if (parsed.error) {
+			fail("ass-format-tests.ass should parse")
+		}
+
+		// the parser trims the trailing whitespace of the text
+		function eventLines(script: string): string[] {
+			return script
+				.split(/\r?\n/)
+				.filter((line) => /^(Dialogue|Comment): /.test(line))
+				.map((line) => line.trimEnd())
+		}
+
+		// default margins are written as 0000, set ones without padding
+		function unpadMargins(line: string): string {
+			const fields = line.split(",")
+
+			for (const index of [5, 6, 7]) {
+				if (fields[index] !== "0000") {
+					fields[index] = String(Number(fields[index]))
+				}
+			}
+
+			return fields.join(",")
+		}
+
+		const written = AssParser.write_ass(parsed.result).toString("utf8")
+
+		expect(eventLines(written)).toStrictEqual(
+			eventLines(fs.readFileSync(filePath, "utf8")).map(unpadMargins)
+		)
+	})
+
+	it("should write lazy lists and other formats", async () => {
+		const filePath = getFilePath("test.ass")
+		const eager = AssParser.parse_ass_file(filePath, DEFAULT_SETTINGS)
+
+		if (eager.error) {
+			fail("test.ass should parse")
+		}
+
+		const expected = AssParser.write_ass(eager.result)
+
+		const lazy = AssParser.parse_ass_file(filePath, {
+			...DEFAULT_SETTINGS,
+			result_mode: "lazy",
+		})
+
+		if (lazy.error) {
+			fail("test.ass should parse")
+		}
+
+		expect(AssParser.write_ass(lazy.result)).toStrictEqual(expected)
+
+		const settings = {
+			...DEFAULT_SETTINGS,
+			time_format: "milliseconds",
+			color_format: "packed",
+		} as const
+
+		const packed = AssParser.parse_ass_file(filePath, settings)
+
+		if (packed.error) {
+			fail("test.ass should parse")
+		}
+
+		expect(AssParser.write_ass(packed.result, settings)).toStrictEqual(
+			expected
+		)
+	})
+
+	it("should write to a file descriptor", async () => {
+		const parsed = AssParser.parse_ass_file(
+			getFilePath("test.ass"),
+			DEFAULT_SETTINGS
+		)
+
+		if (parsed.error) {
+			fail("test.ass should parse")
+		}
+
+		const expected = AssParser.write_ass(parsed.result)
+
+		const dir = fs.mkdtempSync(path.join(os.tmpdir(), "ass-parser-"))
+		const output = path.join(dir, "written.ass")
+
+		try {
+			const fd = fs.openSync(output, "w")
+
+			try {
+				expect(AssParser.write_ass(parsed.result, {}, { fd })).toBe(
+					expected.length
+				)
+			} finally {
+				fs.closeSync(fd)
+			}
+
+			expect(fs.readFileSync(output)).toStrictEqual(expected)
+		} finally {
+			fs.rmSync(dir, { recursive: true, force: true })
+		}
+	})
+
+	it("should validate everything before writing to a file descriptor", async () => {
+		const parsed = AssParser.parse_ass_file(
+			getFilePath("test.ass"),
+			DEFAULT_SETTINGS
+		)
+
+		if (parsed.error) {
+			fail("test.ass should parse")
+		}
+
+		// more than the 1 MiB, after which the writer flushes
+		const text = "x".repeat(1000)
+		const events = Array.from({ length: 2000 }, () => ({
+			...parsed.result.events[0],
+			text,
+		}))
+		events[events.length - 1] = { ...events[0], style: "a, b" }
+
+		const dir = fs.mkdtempSync(path.join(os.tmpdir(), "ass-parser-"))
+		const output = path.join(dir, "written.ass")
+
+		try {
+			const fd = fs.openSync(output, "w")
+
+			try {
+				expect(() =>
+					AssParser.write_ass({ ...parsed.result, events }, {}, { fd })
+				).toThrow(
+					"result.events[1999].style needs to be a string without commas"
+				)
+			} finally {
+				fs.closeSync(fd)
+			}
+
+			expect(fs.statSync(output).size).toBe(0)
+		} finally {
+			fs.rmSync(dir, { recursive: true, force: true })
+		}
+	})
+
+	it("should write to a file descriptor on the threadpool", async () => {
+		const parsed = AssParser.parse_ass_file(
+			getFilePath("test.ass"),
+			DEFAULT_SETTINGS
+		)
+
+		if (parsed.error) {
+			fail("test.ass should parse")
+		}
+
+		const expected = AssParser.write_ass(parsed.result)
+
+		const dir = fs.mkdtempSync(path.join(os.tmpdir(), "ass-parser-"))
+		const output = path.join(dir, "written.ass")
+
+		try {
+			const fd = fs.openSync(output, "w")
+
+			try {
+				await expect(
+					AssParser.write_ass_async(parsed.result, {}, fd)
+				).resolves.toBe(expected.length)
+			} finally {
+				fs.closeSync(fd)
+			}
+
+			expect(fs.readFileSync(output)).toStrictEqual(expected)
+
+			// the file is read only now
+			const read_fd = fs.openSync(output, "r")
+
+			try {
+				await expect(
+					AssParser.write_ass_async(parsed.result, {}, read_fd)
+				).rejects.toThrow("writing to the file descriptor failed")
+			} finally {
+				fs.closeSync(read_fd)
+			}
+
+			await expect(
+				AssParser.write_ass_async(
+					{ ...parsed.result, styles: 1 as any },
+					{},
+					0
+				)
+			).rejects.toThrow("result.styles needs to be an array or a lazy list")
+		} finally {
+			fs.rmSync(dir, { recursive: true, force: true })
+		}
+	})
+
+	it("should reject values, that can't be written", async () => {
+		const parsed = AssParser.parse_ass_file(
+			getFilePath("test.ass"),
+			DEFAULT_SETTINGS
+		)
+
+		if (parsed.error) {
+			fail("test.ass should parse")
+		}
+
+		const events = parsed.result.events.map((event) => ({ ...event }))
+		events[0].text = "line 1\nline 2"
+
+		expect(() => AssParser.write_ass({ ...parsed.result, events })).toThrow(
+			"result.events[0].text needs to be a string without line breaks"
+		)
+
+		// only the text is the last field of the line, so only it can contain commas
+		events[0].text = "a, b"
+
+		const with_commas = AssParser.parse_ass_buffer(
+			AssParser.write_ass({ ...parsed.result, events }),
+			DEFAULT_SETTINGS
+		)
+
+		if (with_commas.error) {
+			fail("the written script should parse")
+		}
+
+		expect(with_commas.result.events[0].text).toBe("a, b")
+
+		events[0].name = "a, b"
+
+		expect(() => AssParser.write_ass({ ...parsed.result, events })).toThrow(
+			"result.events[0].name needs to be a string without commas"
+		)
+
+		expect(() =>
+			AssParser.write_ass({
+				...parsed.result,
+				styles: [{ ...parsed.result.styles[0], fontname: "a, b" }],
+			})
+		).toThrow("result.styles[0].fontname needs to be a string without commas")
+
+		expect(() =>
+			AssParser.write_ass({
+				...parsed.result,
+				styles: [{ ...parsed.result.styles[0], bold: 1 as any }],
+			})
+		).toThrow("result.styles[0].bold needs to be a boolean")
+
+		const columnar = AssParser.parse_ass_file(getFilePath("test.ass"), {
+			...DEFAULT_SETTINGS,
+			result_mode: "columnar",
+		})
+
+		if (columnar.error) {
+			fail("test.ass should parse")
+		}
+
+		expect(() => AssParser.write_ass(columnar.result as any)).toThrow(
+			"result.events needs to be an array or a lazy list"
+		)
+	})
+})
+
+describe("worker_threads: works as expected", () => {
+	// plain js, as the workers don't go through ts-jest
+	const WORKER_SOURCE = `
+		const { parentPort, workerData } = require("worker_threads")
+		const ass_parser = require("node-gyp-build")(workerData.rootDir)
+
+		const results = workerData.files.map((file) =>
+			ass_parser.parse_ass({ type: "file", name: file }, workerData.settings)
+		)
+
+		parentPort.postMessage(results)
+	`
+
+	// resolves with the results of the worker only after it exited, so that its isolate (and the
+	// per isolate data of the addon) was torn down
+	function run_worker(files: string[]): Promise<unknown[]> {
+		return new Promise((resolve, reject) => {
+			const worker = new Worker(WORKER_SOURCE, {
+				eval: true,
+				workerData: {
+					rootDir: path.join(__dirname, ".."),
+					files,
+					settings: AssParser.resolve_parse_settings(DEFAULT_SETTINGS),
+				},
+			})
+
+			let results: unknown[] | undefined = undefined
+
+			worker.once("message", (message: unknown[]) => {
+				results = message
+			})
+			worker.once("error", reject)
+			worker.once("exit", (code) => {
+				if (code !== 0 || results === undefined) {
+					reject(new Error(`the worker exited with code ${code}`))
+					return
+				}
+
+				resolve(results)
+			})
+		})
+	}
+
+	it("should parse the sample files concurrently in multiple workers", async () => {
+		const WORKER_COUNT = 4
+
+		const files = sampleFiles.map(({ file }) => getFilePath(file))
+
+		const expected = files.map((file) =>
+			AssParser.parse_ass_file(file, DEFAULT_SETTINGS)
+		)
+
+		const results = await Promise.all(
+			Array.from({ length: WORKER_COUNT }, () => run_worker(files))
+		)
+
+		for (const result of results) {
+			expect(result).toStrictEqual(expected)
+		}
+
+		// the main thread still works, after the workers exited
+		expect(AssParser.parse_ass_file(files[0], DEFAULT_SETTINGS)).toStrictEqual(
+			expected[0]
+		)
+		expect(
+			AssParser.parse_ass_file(files[0], {
+				...DEFAULT_SETTINGS,
+				result_mode: "lazy",
+			}).error
+		).toBe(expected[0].error)
+	}, 20000)
+})